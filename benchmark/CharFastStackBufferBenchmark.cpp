@@ -0,0 +1,105 @@
+#include "benchmark/benchmark.h"
+
+#include "CharFastStackBuffer.h"
+#include "FastStackStreamBuffer.h"
+#include "FormatString.h"
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace {
+/*!
+ * @brief Formats a typical log record: text, integers and a floating point value.
+ */
+void BM_CharFastStackBufferFormat(benchmark::State &_state) {
+    CharFastStackBuffer<char, 1024> buffer;
+    for (auto _ : _state) {
+        buffer.clear();
+        buffer << "request " << 12345 << " took " << 2.5 << " ms, status " << -1;
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+/*!
+ * @brief The same record by the format string checked at compile time.
+ */
+void BM_FormatStringFormat(benchmark::State &_state) {
+    CharFastStackBuffer<char, 1024> buffer;
+    for (auto _ : _state) {
+        buffer.clear();
+        formatTo(buffer, STDCORE_FMT("request {} took {} ms, status {}"), 12345, 2.5, -1);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+/*!
+ * @brief The record with the width and the precision, which operator<< writes through std::ostream only.
+ */
+void BM_FormatStringSpecFormat(benchmark::State &_state) {
+    CharFastStackBuffer<char, 1024> buffer;
+    for (auto _ : _state) {
+        buffer.clear();
+        formatTo(buffer, STDCORE_FMT("request {:>8} took {:8.3f} ms, status {:x}"), 12345, 2.5, 255);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+void BM_OstringstreamFormat(benchmark::State &_state) {
+    for (auto _ : _state) {
+        std::ostringstream os;
+        os << "request " << 12345 << " took " << 2.5 << " ms, status " << -1;
+        benchmark::DoNotOptimize(os.str());
+    }
+}
+
+/*!
+ * @brief std::string with std::to_string, the string is reused.
+ */
+void BM_StringFormat(benchmark::State &_state) {
+    std::string str;
+    for (auto _ : _state) {
+        str.clear();
+        str.append("request ").append(std::to_string(12345)).append(" took ").append(std::to_string(2.5))
+                .append(" ms, status ").append(std::to_string(-1));
+        benchmark::DoNotOptimize(str.data());
+    }
+}
+
+/*!
+ * @brief std::ostream over FastStackStreamBuffer, the stream is reused.
+ */
+void BM_FastStackStreamBufferFormat(benchmark::State &_state) {
+    CharFastStackBuffer<char, 1024> buffer;
+    FastStackStreamBuffer<char, 1024> streamBuffer(buffer);
+    std::ostream os(&streamBuffer);
+    for (auto _ : _state) {
+        buffer.clear();
+        streamBuffer.pubsync();
+        os << "request " << 12345 << " took " << 2.5 << " ms, status " << -1;
+        os.flush();
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+/*!
+ * @brief std::ostream over std::stringbuf, the stream is reused.
+ */
+void BM_StringbufFormat(benchmark::State &_state) {
+    std::stringbuf streamBuffer;
+    std::ostream os(&streamBuffer);
+    for (auto _ : _state) {
+        streamBuffer.str({});
+        os << "request " << 12345 << " took " << 2.5 << " ms, status " << -1;
+        benchmark::DoNotOptimize(streamBuffer.str());
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_CharFastStackBufferFormat);
+BENCHMARK(BM_FormatStringFormat);
+BENCHMARK(BM_FormatStringSpecFormat);
+BENCHMARK(BM_OstringstreamFormat);
+BENCHMARK(BM_StringFormat);
+BENCHMARK(BM_FastStackStreamBufferFormat);
+BENCHMARK(BM_StringbufFormat);
@@ -0,0 +1,56 @@
+#include "benchmark/benchmark.h"
+
+#include "EscapeFormat.h"
+
+#include <string>
+
+namespace {
+/*!
+ * @brief A typical user-supplied string: mostly plain text with a quote and a newline.
+ */
+std::string payload() {
+    std::string str;
+    while (str.size() < 512) {
+        str += "user agent Mozilla/5.0 (X11; Linux x86_64) request \"GET /index.html\" ";
+    }
+    str += "\n";
+
+    return str;
+}
+
+/*!
+ * @brief Scans the plain part of the payload by the instruction set.
+ */
+void BM_EscapeScan(benchmark::State &_state) {
+    const auto isa = static_cast<EscapeScanner::Isa>(_state.range(0));
+    if (!EscapeScanner::isSupported(isa)) {
+        _state.SkipWithError("the instruction set is not supported");
+        return;
+    }
+
+    const std::string str(1024, 'a');
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(EscapeScanner::find(isa, str, EscapeMode::Json, true));
+    }
+    _state.SetBytesProcessed(static_cast<std::int64_t>(_state.iterations() * str.size()));
+}
+
+/*!
+ * @brief Appends the payload with the JSON escapes.
+ */
+void BM_EscapeJson(benchmark::State &_state) {
+    const auto str = payload();
+    CharFastStackBuffer<char, 2048> buffer;
+    for (auto _ : _state) {
+        buffer.clear();
+        buffer << escapeFormat(str, EscapeMode::Json);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    _state.SetBytesProcessed(static_cast<std::int64_t>(_state.iterations() * str.size()));
+}
+}  // namespace
+
+BENCHMARK(BM_EscapeScan)->Arg(static_cast<int>(EscapeScanner::Isa::Scalar))
+                        ->Arg(static_cast<int>(EscapeScanner::Isa::Sse2))
+                        ->Arg(static_cast<int>(EscapeScanner::Isa::Avx2));
+BENCHMARK(BM_EscapeJson);
@@ -0,0 +1,96 @@
+#include "benchmark/benchmark.h"
+
+#include "FastRingBuffer.h"
+
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+constexpr std::size_t Capacity = 1024;
+
+/*!
+ * @brief Pushes a value and pops one, every thread of the run works on the same buffer.
+ */
+template<class Buffer_t>
+void BM_RingBufferPushPop(benchmark::State &_state) {
+    static Buffer_t buffer;
+    for (auto _ : _state) {
+        while (!buffer.tryPush(1)) {
+            std::this_thread::yield();
+        }
+        while (!buffer.tryPop()) {
+            std::this_thread::yield();
+        }
+    }
+    _state.SetItemsProcessed(_state.iterations());
+}
+
+/*!
+ * @brief The baseline: std::deque guarded by std::mutex.
+ */
+class MutexQueue {
+public:
+    bool tryPush(int _value) {
+        const std::lock_guard lock(m_mutex);
+        if (m_queue.size() == Capacity) {
+            return false;
+        }
+        m_queue.push_back(_value);
+        return true;
+    }
+
+    bool tryPop() {
+        const std::lock_guard lock(m_mutex);
+        if (m_queue.empty()) {
+            return false;
+        }
+        m_queue.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<int> m_queue;
+};
+
+/*!
+ * @brief One producer and one consumer pass the values through FastSpscRingBuffer.
+ */
+void BM_SpscProducerConsumer(benchmark::State &_state) {
+    static FastSpscRingBuffer<int, Capacity> buffer;
+    const bool producer = _state.thread_index() == 0;
+    for (auto _ : _state) {
+        if (producer) {
+            while (!buffer.tryPush(1)) {
+                std::this_thread::yield();
+            }
+        } else {
+            while (!buffer.tryPop()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    _state.SetItemsProcessed(_state.iterations());
+}
+
+/*!
+ * @brief Passes the values in batches of the argument size through FastSpscRingBuffer on one thread.
+ */
+void BM_SpscBatch(benchmark::State &_state) {
+    FastSpscRingBuffer<int, Capacity> buffer;
+    const auto batch = static_cast<std::size_t>(_state.range(0));
+    int values[Capacity] = {};
+    for (auto _ : _state) {
+        buffer.pushBatch(values, batch);
+        benchmark::DoNotOptimize(buffer.popBatch(values, batch));
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * batch));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_RingBufferPushPop, FastSpscRingBuffer<int, Capacity>);
+BENCHMARK_TEMPLATE(BM_RingBufferPushPop, FastMpmcRingBuffer<int, Capacity>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RingBufferPushPop, MutexQueue)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_SpscProducerConsumer)->Threads(2)->UseRealTime();
+BENCHMARK(BM_SpscBatch)->RangeMultiplier(4)->Range(1, 256);
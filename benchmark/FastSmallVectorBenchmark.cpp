@@ -0,0 +1,55 @@
+#include "benchmark/benchmark.h"
+
+#include "FastSmallVector.h"
+
+#include <vector>
+
+namespace {
+/*!
+ * @brief Builds a short vector per iteration, like a request handler does.
+ */
+void BM_FastSmallVectorShort(benchmark::State &_state) {
+    const auto count = static_cast<std::size_t>(_state.range(0));
+    for (auto _ : _state) {
+        FastSmallVector<int, 16> vector;
+        for (std::size_t i = 0; i < count; ++i) {
+            vector.push(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(vector.data());
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * count));
+}
+
+/*!
+ * @brief std::vector pays an allocation per iteration.
+ */
+void BM_VectorShort(benchmark::State &_state) {
+    const auto count = static_cast<std::size_t>(_state.range(0));
+    for (auto _ : _state) {
+        std::vector<int> vector;
+        for (std::size_t i = 0; i < count; ++i) {
+            vector.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(vector.data());
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * count));
+}
+
+/*!
+ * @brief Inserts at the front of a vector which fits into the inline storage.
+ */
+void BM_FastSmallVectorInsertFront(benchmark::State &_state) {
+    for (auto _ : _state) {
+        FastSmallVector<int, 16> vector;
+        for (int i = 0; i < 16; ++i) {
+            vector.insert(vector.begin(), i);
+        }
+        benchmark::DoNotOptimize(vector.data());
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * 16));
+}
+}  // namespace
+
+BENCHMARK(BM_FastSmallVectorShort)->Arg(8)->Arg(64);
+BENCHMARK(BM_VectorShort)->Arg(8)->Arg(64);
+BENCHMARK(BM_FastSmallVectorInsertFront);
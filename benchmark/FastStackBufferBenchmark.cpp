@@ -0,0 +1,90 @@
+#include "benchmark/benchmark.h"
+
+#include "FastStackBuffer.h"
+
+#include <stack>
+#include <vector>
+
+namespace {
+constexpr std::size_t Capacity = 1024;
+
+/*!
+ * @brief Pushes the stack full and pops it empty.
+ */
+void BM_FastStackBufferPushPop(benchmark::State &_state) {
+    FastStackBuffer<int, Capacity> stack;
+    for (auto _ : _state) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            stack.push(static_cast<int>(i));
+        }
+        while (!stack.isEmpty()) {
+            benchmark::DoNotOptimize(stack.pop());
+        }
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * Capacity));
+}
+
+/*!
+ * @brief std::vector with the reserved capacity.
+ */
+void BM_VectorPushPop(benchmark::State &_state) {
+    std::vector<int> stack;
+    stack.reserve(Capacity);
+    for (auto _ : _state) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            stack.push_back(static_cast<int>(i));
+        }
+        while (!stack.empty()) {
+            benchmark::DoNotOptimize(stack.back());
+            stack.pop_back();
+        }
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * Capacity));
+}
+
+/*!
+ * @brief std::stack over std::deque.
+ */
+void BM_StdStackPushPop(benchmark::State &_state) {
+    std::stack<int> stack;
+    for (auto _ : _state) {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            stack.push(static_cast<int>(i));
+        }
+        while (!stack.empty()) {
+            benchmark::DoNotOptimize(stack.top());
+            stack.pop();
+        }
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * Capacity));
+}
+
+/*!
+ * @brief Constructs the stack, fills it and destroys it, the containers allocate on every iteration.
+ */
+void BM_FastStackBufferScoped(benchmark::State &_state) {
+    for (auto _ : _state) {
+        FastStackBuffer<int, 64> stack;
+        for (int i = 0; i < 64; ++i) {
+            stack.push(i);
+        }
+        benchmark::DoNotOptimize(stack.data());
+    }
+}
+
+void BM_VectorScoped(benchmark::State &_state) {
+    for (auto _ : _state) {
+        std::vector<int> stack;
+        for (int i = 0; i < 64; ++i) {
+            stack.push_back(i);
+        }
+        benchmark::DoNotOptimize(stack.data());
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_FastStackBufferPushPop);
+BENCHMARK(BM_VectorPushPop);
+BENCHMARK(BM_StdStackPushPop);
+BENCHMARK(BM_FastStackBufferScoped);
+BENCHMARK(BM_VectorScoped);
@@ -0,0 +1,72 @@
+#include "benchmark/benchmark.h"
+
+#include "LogCompression.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+/*!
+ * @brief Returns the text records as LogHelper writes them, with varying values.
+ */
+std::string logText(std::size_t _size) {
+    static const char *const Levels[] = {"Information", "Information", "Information", "Warning", "Error"};
+    static const char *const Messages[] = {"request handled", "cache miss for key", "connection closed by peer",
+                                           "retrying the upstream call", "slow query detected"};
+    std::mt19937 random(42);
+    std::string text;
+    for (long long time = 1700000000000000; text.size() < _size; time += random() % 5000) {
+        text += "2023-11-14 22:13:" + std::to_string(time / 1000000 % 60) + '.' + std::to_string(time % 1000000) + ' ' +
+                Levels[random() % 5] + ' ' + Messages[random() % 5] + " id=" + std::to_string(random() % 1000000) +
+                " took " + std::to_string(random() % 2000) + " us\n";
+    }
+
+    return text;
+}
+
+const std::string &sampleText() {
+    static const std::string text = logText(4 * 1024 * 1024);
+    return text;
+}
+
+/*!
+ * @brief Compresses the log text block by block, the ratio is the input size divided by the output size.
+ */
+void BM_LogCompressionCompress(benchmark::State &_state) {
+    const auto &text = sampleText();
+    std::string compressed;
+    for (auto _ : _state) {
+        std::istringstream input(text);
+        std::ostringstream output;
+        LogCompression::compressStream(input, output);
+        compressed = output.str();
+        benchmark::DoNotOptimize(compressed.data());
+    }
+
+    _state.SetBytesProcessed(static_cast<std::int64_t>(_state.iterations() * text.size()));
+    _state.counters["ratio"] = static_cast<double>(text.size()) / static_cast<double>(compressed.size());
+}
+
+/*!
+ * @brief Decompresses the compressed log text.
+ */
+void BM_LogCompressionDecompress(benchmark::State &_state) {
+    const auto &text = sampleText();
+    std::istringstream input(text);
+    std::ostringstream compressed;
+    LogCompression::compressStream(input, compressed);
+
+    for (auto _ : _state) {
+        std::istringstream compressedInput(compressed.str());
+        std::ostringstream output;
+        LogCompression::decompressStream(compressedInput, output);
+        benchmark::DoNotOptimize(output.str().data());
+    }
+
+    _state.SetBytesProcessed(static_cast<std::int64_t>(_state.iterations() * text.size()));
+}
+}  // namespace
+
+BENCHMARK(BM_LogCompressionCompress)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LogCompressionDecompress)->Unit(benchmark::kMillisecond);
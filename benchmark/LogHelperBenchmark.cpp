@@ -0,0 +1,92 @@
+#include "benchmark/benchmark.h"
+
+#include "LogHelper.h"
+
+#include <memory>
+#include <ostream>
+
+namespace {
+/*!
+ * @brief Drops the records, so only the record formatting is measured.
+ */
+class NullSink final : public LogSink {
+public:
+    void write(std::string_view _record, LogLevel) override {
+        benchmark::DoNotOptimize(_record.data());
+    }
+
+    void flush() override {}
+};
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream &operator<<(std::ostream &_os, const Point &_point) {
+    return _os << '(' << _point.x << ", " << _point.y << ')';
+}
+
+/*!
+ * @brief A record of the values CharFastStackBuffer formats itself.
+ */
+void BM_LogHelperBufferRecord(benchmark::State &_state) {
+    LogHelper::setSink(std::make_shared<NullSink>());
+    for (auto _ : _state) {
+        STDCORE_LOG_ERROR << "request " << 12345 << " took " << 2.5 << " ms";
+    }
+    LogHelper::setSink(nullptr);
+}
+
+/*!
+ * @brief A record with a value written by std::ostream, the stream of the pooled record is reused.
+ */
+void BM_LogHelperStreamRecord(benchmark::State &_state) {
+    LogHelper::setSink(std::make_shared<NullSink>());
+    for (auto _ : _state) {
+        STDCORE_LOG_ERROR << "point " << Point{1, 2};
+    }
+    LogHelper::setSink(nullptr);
+}
+
+/*!
+ * @brief A rate limited statement which suppresses almost every record, the limiter is checked before any formatting.
+ */
+void BM_LogHelperSuppressedRecord(benchmark::State &_state) {
+    LogHelper::setSink(std::make_shared<NullSink>());
+    for (auto _ : _state) {
+        STDCORE_LOG_EVERY_N(LogHelper::LogLevel::Error, 1000000) << "request " << 12345 << " took " << 2.5 << " ms";
+    }
+    LogHelper::setSink(nullptr);
+}
+
+/*!
+ * @brief A token bucket statement which suppresses almost every record.
+ */
+void BM_LogHelperRateLimitedRecord(benchmark::State &_state) {
+    LogHelper::setSink(std::make_shared<NullSink>());
+    for (auto _ : _state) {
+        STDCORE_LOG_RATE_LIMITED(LogHelper::LogLevel::Error, 10, 10) << "request " << 12345 << " took " << 2.5 << " ms";
+    }
+    LogHelper::setSink(nullptr);
+}
+
+/*!
+ * @brief An Information record kept by the flight recorder, it is copied into the buffer of the thread instead of the sink.
+ */
+void BM_LogHelperFlightRecorderRecord(benchmark::State &_state) {
+    LogHelper::setSink(std::make_shared<NullSink>());
+    LogHelper::enableFlightRecorder();
+    for (auto _ : _state) {
+        STDCORE_LOG_INFORMATION << "request " << 12345 << " took " << 2.5 << " ms";
+    }
+    LogHelper::disableFlightRecorder();
+    LogHelper::setSink(nullptr);
+}
+}  // namespace
+
+BENCHMARK(BM_LogHelperBufferRecord);
+BENCHMARK(BM_LogHelperStreamRecord);
+BENCHMARK(BM_LogHelperSuppressedRecord);
+BENCHMARK(BM_LogHelperRateLimitedRecord);
+BENCHMARK(BM_LogHelperFlightRecorderRecord);
@@ -0,0 +1,74 @@
+#include "benchmark/benchmark.h"
+
+#include "FdLogSink.h"
+#include "MmapLogSink.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+/*!
+ * @brief A record of a typical length.
+ */
+const std::string g_record = "2024-01-01 12:00:00.000000 Information request 12345 took 2.5 ms, status 200, bytes 4096";
+
+std::string benchmarkPath(const char *_name) {
+    return std::string("/tmp/") + _name;
+}
+
+void removeFiles(const std::string &_path) {
+    for (const auto &file : {_path, _path + ".1"}) {
+        std::remove(file.c_str());
+    }
+}
+
+/*!
+ * @brief The records are coalesced and written by writev per 64 KiB.
+ */
+void BM_FileLogSinkWrite(benchmark::State &_state) {
+    static std::unique_ptr<FileLogSink> sink;
+    const auto path = benchmarkPath("stdcore_file_sink_benchmark.log");
+    if (_state.thread_index() == 0) {
+        removeFiles(path);
+        sink = std::make_unique<FileLogSink>(path);
+    }
+
+    for (auto _ : _state) {
+        sink->write(g_record, LogLevel::Information);
+    }
+
+    if (_state.thread_index() == 0) {
+        sink.reset();
+        removeFiles(path);
+    }
+    _state.SetBytesProcessed(static_cast<std::int64_t>(_state.iterations() * (g_record.size() + 1)));
+}
+
+/*!
+ * @brief The records are copied into the mapped segment, without a lock or a system call.
+ */
+void BM_MmapLogSinkWrite(benchmark::State &_state) {
+    static std::unique_ptr<MmapLogSink> sink;
+    const auto path = benchmarkPath("stdcore_mmap_sink_benchmark.log");
+    if (_state.thread_index() == 0) {
+        removeFiles(path);
+        MmapLogSink::Options options;
+        options.maxFiles = 1;
+        sink = std::make_unique<MmapLogSink>(path, options);
+    }
+
+    for (auto _ : _state) {
+        sink->write(g_record, LogLevel::Information);
+    }
+
+    if (_state.thread_index() == 0) {
+        sink.reset();
+        removeFiles(path);
+    }
+    _state.SetBytesProcessed(static_cast<std::int64_t>(_state.iterations() * (g_record.size() + 1)));
+}
+}  // namespace
+
+BENCHMARK(BM_FileLogSinkWrite)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(BM_MmapLogSinkWrite)->ThreadRange(1, 4)->UseRealTime();
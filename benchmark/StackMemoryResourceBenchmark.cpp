@@ -0,0 +1,45 @@
+#include "benchmark/benchmark.h"
+
+#include "StackMemoryResource.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::size_t StringCount = 8;
+constexpr std::size_t StringSize = 64;
+
+/*!
+ * @brief The temporary strings of a request from the thread resource, released at once by the scope.
+ */
+void BM_MemoryResourceScopeStrings(benchmark::State &_state) {
+    for (auto _ : _state) {
+        MemoryResourceScope scope;
+        std::pmr::vector<std::pmr::string> strings(scope.resource());
+        strings.reserve(StringCount);
+        for (std::size_t i = 0; i < StringCount; ++i) {
+            strings.emplace_back(StringSize, 'x');
+        }
+        benchmark::DoNotOptimize(strings.data());
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * StringCount));
+}
+
+/*!
+ * @brief The same strings from the global allocator.
+ */
+void BM_GlobalAllocatorStrings(benchmark::State &_state) {
+    for (auto _ : _state) {
+        std::vector<std::string> strings;
+        strings.reserve(StringCount);
+        for (std::size_t i = 0; i < StringCount; ++i) {
+            strings.emplace_back(StringSize, 'x');
+        }
+        benchmark::DoNotOptimize(strings.data());
+    }
+    _state.SetItemsProcessed(static_cast<std::int64_t>(_state.iterations() * StringCount));
+}
+}  // namespace
+
+BENCHMARK(BM_MemoryResourceScopeStrings);
+BENCHMARK(BM_GlobalAllocatorStrings);
@@ -0,0 +1,67 @@
+#include "benchmark/benchmark.h"
+
+#include "StackTrace.h"
+#include "UserException.h"
+
+#include <string>
+
+namespace {
+/*!
+ * @brief Throws from a few frames deep, like a real throw site.
+ */
+[[gnu::noinline]] void throwException(int _depth) {
+    if (_depth == 0) {
+        throw UserException(UserException::Static, "user", "debug", __PRETTY_FUNCTION__);
+    }
+
+    throwException(_depth - 1);
+    benchmark::ClobberMemory();
+}
+
+/*!
+ * @brief Throws and catches UserException, the argument enables the stack trace capture.
+ */
+void BM_UserExceptionThrow(benchmark::State &_state) {
+    StackTrace::setCaptureEnabled(_state.range(0) != 0);
+    for (auto _ : _state) {
+        try {
+            throwException(8);
+        } catch (const UserException &_exception) {
+            benchmark::DoNotOptimize(_exception.stackTrace().size());
+        }
+    }
+    StackTrace::setCaptureEnabled(false);
+}
+
+/*!
+ * @brief The capture alone.
+ */
+void BM_StackTraceCapture(benchmark::State &_state) {
+    StackTrace::setCaptureEnabled(true);
+    for (auto _ : _state) {
+        auto stackTrace = StackTrace::capture();
+        benchmark::DoNotOptimize(stackTrace);
+    }
+    StackTrace::setCaptureEnabled(false);
+}
+
+/*!
+ * @brief Writes the exception with the stack trace, the symbols are cached after the first iteration.
+ */
+void BM_UserExceptionWriteStackTrace(benchmark::State &_state) {
+    StackTrace::setCaptureEnabled(true);
+    const UserException exception(UserException::Static, "user", "debug", __PRETTY_FUNCTION__);
+    StackTrace::setCaptureEnabled(false);
+
+    std::string str;
+    for (auto _ : _state) {
+        str.clear();
+        exception.writeTo(str);
+        benchmark::DoNotOptimize(str.data());
+    }
+}
+}  // namespace
+
+BENCHMARK(BM_UserExceptionThrow)->Arg(0)->Arg(1);
+BENCHMARK(BM_StackTraceCapture);
+BENCHMARK(BM_UserExceptionWriteStackTrace);
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON outputs and flags the regressions.
+
+Usage: compare_benchmarks.py BASELINE.json CURRENT.json [--threshold 0.10] [--metric cpu_time]
+
+The repeated runs of a benchmark are averaged, the aggregates are ignored.
+The exit status is 1 if any benchmark is slower than the baseline by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path, metric):
+    """Returns {benchmark name: time in nanoseconds}."""
+    with open(path) as file:
+        data = json.load(file)
+
+    totals = {}
+    for entry in data.get("benchmarks", []):
+        if entry.get("run_type") == "aggregate" or "error_occurred" in entry:
+            continue
+        name = entry.get("run_name", entry["name"])
+        time = entry[metric] * TIME_UNITS[entry.get("time_unit", "ns")]
+        total, count = totals.get(name, (0.0, 0))
+        totals[name] = (total + time, count + 1)
+
+    return {name: total / count for name, (total, count) in totals.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="the relative slowdown reported as a regression, 0.10 by default")
+    parser.add_argument("--metric", choices=["cpu_time", "real_time"], default="cpu_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+
+    regressions = 0
+    width = max((len(name) for name in current), default=10)
+    print(f"{'Benchmark':<{width}} {'Baseline':>12} {'Current':>12} {'Change':>8}")
+    for name, time in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}} {'-':>12} {time:>10.1f}ns {'new':>8}")
+            continue
+
+        change = time / baseline[name] - 1.0 if baseline[name] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            regressions += 1
+            flag = "  REGRESSION"
+        print(f"{name:<{width}} {baseline[name]:>10.1f}ns {time:>10.1f}ns {change:>+7.1%}{flag}")
+
+    for name in baseline.keys() - current.keys():
+        print(f"{name:<{width}} {'':>12} {'':>12} {'removed':>8}")
+
+    if regressions:
+        print(f"{regressions} regression(s) above {args.threshold:.0%}", file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,234 @@
+#include "AsyncLogWriter.h"
+
+#include "LogMetrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+//! The writer thread wakes up at least this often, even if nobody notified it.
+constexpr auto WriterWaitInterval = std::chrono::milliseconds(10);
+
+std::size_t roundUpToPowerOfTwo(std::size_t _value) {
+    std::size_t result = 2;
+    while (result < _value) {
+        result <<= 1;
+    }
+
+    return result;
+}
+}  // namespace
+
+AsyncLogWriter::AsyncLogWriter(LogSink &_sink, std::size_t _queueCapacity, OverflowPolicy _policy)
+    : m_sink(_sink),
+      m_policy(_policy),
+      m_mask(roundUpToPowerOfTwo(_queueCapacity) - 1),
+      m_slots(new Slot[m_mask + 1]) {
+    for (std::size_t i = 0; i <= m_mask; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_thread = std::thread(&AsyncLogWriter::run, this);
+}
+
+AsyncLogWriter::AsyncLogWriter(std::ostream &_os, std::size_t _queueCapacity, OverflowPolicy _policy)
+    : AsyncLogWriter(*new StreamLogSink(_os), _queueCapacity, _policy) {
+    m_ownedSink.reset(&m_sink);
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    stop();
+}
+
+AsyncLogWriter::PushResult AsyncLogWriter::push(std::string_view _record, LogLevel _level) noexcept {
+    m_producers.fetch_add(1);
+    if (!m_accepting.load()) {
+        m_producers.fetch_sub(1);
+        return PushResult::Stopped;
+    }
+
+    auto result = PushResult::Queued;
+    bool queued = true;
+    while (!tryEnqueue(_record, _level)) {
+        if (m_policy == OverflowPolicy::DropNewest) {
+            result = PushResult::Dropped;
+            queued = false;
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            if constexpr (LogMetrics::Enabled) {
+                LogMetrics::add(LogMetrics::Counter::Dropped);
+            }
+            break;
+        }
+
+        if (m_policy == OverflowPolicy::DropOldest) {
+            if (tryDequeue([](std::string_view, LogLevel) {})) {
+                result = PushResult::Dropped;
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                m_consumed.fetch_add(1);
+                if constexpr (LogMetrics::Enabled) {
+                    LogMetrics::add(LogMetrics::Counter::Dropped);
+                }
+            }
+            continue;
+        }
+
+        // the writer notifies the blocked producers after every batch.
+        std::unique_lock lock(m_mutex);
+        m_wakeCv.notify_one();
+        m_spaceCv.wait_for(lock, WriterWaitInterval, [this] { return hasFreeSlot(); });
+    }
+
+    if (queued) {
+        m_enqueued.fetch_add(1);
+        if (m_writerWaiting.load()) {
+            wakeWriter();
+        }
+    }
+
+    m_producers.fetch_sub(1);
+
+    return result;
+}
+
+void AsyncLogWriter::flush() {
+    const auto target = m_enqueued.load();
+
+    std::unique_lock lock(m_mutex);
+    while (m_consumed.load() < target) {
+        m_wakeCv.notify_one();
+        m_flushCv.wait_for(lock, WriterWaitInterval);
+    }
+}
+
+void AsyncLogWriter::stop() {
+    m_accepting.store(false);
+    while (m_producers.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    m_running.store(false);
+    wakeWriter();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::size_t AsyncLogWriter::dropped() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+AsyncLogWriter::OverflowPolicy AsyncLogWriter::overflowPolicy() const noexcept {
+    return m_policy;
+}
+
+bool AsyncLogWriter::tryEnqueue(std::string_view _record, LogLevel _level) noexcept {
+    auto pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->size = std::min(_record.size(), RecordCapacity);
+    slot->level = _level;
+    std::memcpy(slot->data, _record.data(), slot->size);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool AsyncLogWriter::hasFreeSlot() const noexcept {
+    return m_enqueuePos.load(std::memory_order_relaxed) - m_dequeuePos.load(std::memory_order_relaxed) <= m_mask;
+}
+
+template<class Consumer_t>
+bool AsyncLogWriter::tryDequeue(Consumer_t &&_consumer) noexcept {
+    auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        const auto sequence = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+        if (diff == 0) {
+            if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    _consumer(std::string_view(slot->data, slot->size), slot->level);
+    slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+    return true;
+}
+
+void AsyncLogWriter::wakeWriter() {
+    std::lock_guard lock(m_mutex);
+    m_wakeCv.notify_one();
+}
+
+void AsyncLogWriter::run() {
+    const auto writeRecord = [this](std::string_view _record, LogLevel _level) {
+        if constexpr (LogMetrics::Enabled) {
+            const auto start = LogMetrics::now();
+            m_sink.write(_record, _level);
+            LogMetrics::addLatency(LogMetrics::Latency::SinkWrite, LogMetrics::now() - start);
+        } else {
+            m_sink.write(_record, _level);
+        }
+    };
+
+    while (true) {
+        std::size_t count = 0;
+        while (count < MaxBatchRecords && tryDequeue(writeRecord)) {
+            ++count;
+        }
+
+        if (count != 0) {
+            m_sink.flush();
+
+            m_consumed.fetch_add(count);
+            std::lock_guard lock(m_mutex);
+            m_flushCv.notify_all();
+            m_spaceCv.notify_all();
+            continue;
+        }
+
+        if (!m_running.load() && m_consumed.load() == m_enqueued.load()) {
+            break;
+        }
+
+        // a sink written by others, e.g. by the synchronous records, may keep records while the queue is idle.
+        m_sink.flushIfDue();
+
+        std::unique_lock lock(m_mutex);
+        m_writerWaiting.store(true);
+        m_wakeCv.wait_for(lock, WriterWaitInterval, [this] {
+            return !m_running.load() || m_consumed.load() != m_enqueued.load();
+        });
+        m_writerWaiting.store(false);
+    }
+
+    std::lock_guard lock(m_mutex);
+    m_flushCv.notify_all();
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <thread>
+
+#include "LogSink.h"
+
+/*!
+ * @brief AsyncLogWriter hands finished log records over to a dedicated writer thread.
+ * Producers copy a record into a bounded multi-producer queue, the writer thread drains the queue in batches,
+ * passes the records of the batch to the sink and flushes the sink once per batch.
+ */
+class AsyncLogWriter {
+public:
+    /*!
+     * @brief The behaviour of push() when the queue is full.
+     */
+    enum class OverflowPolicy {
+        Block,
+        DropNewest,
+        DropOldest
+    };
+
+    /*!
+     * @brief The result of push().
+     */
+    enum class PushResult {
+        Queued,
+        Dropped,
+        Stopped
+    };
+
+    /*!
+     * @brief The maximum size of a single record. Longer records are truncated.
+     */
+    static constexpr std::size_t RecordCapacity = STDCORE_LOG_RECORD_CAPACITY;
+
+    /*!
+     * @brief The default number of queue slots.
+     */
+    static constexpr std::size_t DefaultQueueCapacity = 4096;
+
+    /*!
+     * @brief The maximum number of records written by one write call.
+     */
+    static constexpr std::size_t MaxBatchRecords = 256;
+
+    /*!
+     * @brief Construct a new AsyncLogWriter object and start the writer thread.
+     * @param _sink - output sink, it must outlive the writer.
+     * @param _queueCapacity - number of queue slots, rounded up to the power of two.
+     * @param _policy - full queue policy.
+     */
+    explicit AsyncLogWriter(LogSink &_sink,
+                            std::size_t _queueCapacity = DefaultQueueCapacity,
+                            OverflowPolicy _policy = OverflowPolicy::Block);
+
+    /*!
+     * @brief Construct a new AsyncLogWriter object which writes to the stream through StreamLogSink.
+     * @param _os - output stream. It is used only by the writer thread.
+     * @param _queueCapacity - number of queue slots, rounded up to the power of two.
+     * @param _policy - full queue policy.
+     */
+    explicit AsyncLogWriter(std::ostream &_os,
+                            std::size_t _queueCapacity = DefaultQueueCapacity,
+                            OverflowPolicy _policy = OverflowPolicy::Block);
+
+    /*!
+     * @brief Destroy the AsyncLogWriter object. All queued records are written before the writer thread stops.
+     */
+    ~AsyncLogWriter();
+
+    AsyncLogWriter(const AsyncLogWriter &) = delete;
+    AsyncLogWriter &operator=(const AsyncLogWriter &) = delete;
+
+    /*!
+     * @brief Queue a record. A line feed is appended to every record by the sink.
+     * @param _record - record content.
+     * @param _level - record level, it is passed to the sink.
+     * @return Stopped if the writer does not accept records anymore; Dropped if the record or an older record
+     * was dropped by the overflow policy; otherwise Queued.
+     */
+    PushResult push(std::string_view _record, LogLevel _level = LogLevel::Information) noexcept;
+
+    /*!
+     * @brief Blocks until all records queued before the call are written and the stream is flushed.
+     */
+    void flush();
+
+    /*!
+     * @brief Writes all queued records and stops the writer thread. Subsequent push() calls return Stopped.
+     */
+    void stop();
+
+    /*!
+     * @brief Returns the number of records dropped by the overflow policy.
+     */
+    [[nodiscard]]
+    std::size_t dropped() const noexcept;
+
+    /*!
+     * @brief Returns the full queue policy.
+     */
+    [[nodiscard]]
+    OverflowPolicy overflowPolicy() const noexcept;
+
+private:
+    /*!
+     * @brief The queue slot.
+     */
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::size_t size;
+        LogLevel level;
+        char data[RecordCapacity];
+    };
+
+    /*!
+     * @brief Tries to copy the record into the queue. Returns false if the queue is full.
+     */
+    bool tryEnqueue(std::string_view _record, LogLevel _level) noexcept;
+
+    /*!
+     * @brief Tries to take the oldest record from the queue. Returns false if the queue is empty.
+     * @param _consumer - callable which receives the record content and level.
+     */
+    template<class Consumer_t>
+    bool tryDequeue(Consumer_t &&_consumer) noexcept;
+
+    /*!
+     * @brief Returns true if the queue has a free slot.
+     */
+    [[nodiscard]]
+    bool hasFreeSlot() const noexcept;
+
+    /*!
+     * @brief Wakes the writer thread up if it is waiting.
+     */
+    void wakeWriter();
+
+    /*!
+     * @brief The writer thread function.
+     */
+    void run();
+
+    /*!
+     * @brief The sink created by the stream constructor.
+     */
+    std::unique_ptr<LogSink> m_ownedSink;
+    /*!
+     * @brief Output sink.
+     */
+    LogSink &m_sink;
+    /*!
+     * @brief Full queue policy.
+     */
+    const OverflowPolicy m_policy;
+    /*!
+     * @brief The slot index mask, the queue capacity minus one.
+     */
+    const std::size_t m_mask;
+    /*!
+     * @brief The queue slots.
+     */
+    std::unique_ptr<Slot[]> m_slots;
+
+    /*!
+     * @brief Enqueue position.
+     */
+    alignas(64) std::atomic<std::size_t> m_enqueuePos{0};
+    /*!
+     * @brief Dequeue position.
+     */
+    alignas(64) std::atomic<std::size_t> m_dequeuePos{0};
+
+    /*!
+     * @brief Number of queued records.
+     */
+    alignas(64) std::atomic<std::size_t> m_enqueued{0};
+    /*!
+     * @brief Number of records removed from the queue, either written or dropped.
+     */
+    std::atomic<std::size_t> m_consumed{0};
+    /*!
+     * @brief Number of dropped records.
+     */
+    std::atomic<std::size_t> m_dropped{0};
+    /*!
+     * @brief Number of producers inside push().
+     */
+    std::atomic<std::size_t> m_producers{0};
+    /*!
+     * @brief The writer accepts new records.
+     */
+    std::atomic<bool> m_accepting{true};
+    /*!
+     * @brief The writer thread keeps running.
+     */
+    std::atomic<bool> m_running{true};
+    /*!
+     * @brief The writer thread is waiting for records.
+     */
+    std::atomic<bool> m_writerWaiting{false};
+
+    /*!
+     * @brief Guards the condition variables.
+     */
+    std::mutex m_mutex;
+    /*!
+     * @brief Wakes the writer thread up.
+     */
+    std::condition_variable m_wakeCv;
+    /*!
+     * @brief Notifies flush() callers about written records.
+     */
+    std::condition_variable m_flushCv;
+    /*!
+     * @brief Notifies the producers blocked by the full queue about the freed slots.
+     */
+    std::condition_variable m_spaceCv;
+
+    /*!
+     * @brief The writer thread.
+     */
+    std::thread m_thread;
+};
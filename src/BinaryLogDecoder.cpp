@@ -0,0 +1,195 @@
+#include "BinaryLogDecoder.h"
+
+#include "BinaryLogFormat.h"
+#include "LogLevel.h"
+#include "UserException.h"
+
+#include <istream>
+#include <ostream>
+
+namespace {
+//! The size of the input chunk read by decodeStream().
+constexpr std::size_t ReadChunkSize = 64 * 1024;
+
+/*!
+ * @brief Reads the values of the entry and checks the bounds.
+ */
+class EntryReader {
+public:
+    explicit EntryReader(std::string_view _data) : m_data(_data) {}
+
+    [[nodiscard]]
+    bool has(std::size_t _size) const noexcept { return m_data.size() - m_position >= _size; }
+
+    template<class V>
+    V get() {
+        if (!has(sizeof(V))) {
+            throw UserException(UserException::Static, "Corrupted binary log", "the entry is truncated", __PRETTY_FUNCTION__);
+        }
+
+        const auto value = BinaryLogFormat::get<V>(m_data.data() + m_position);
+        m_position += sizeof(V);
+
+        return value;
+    }
+
+    std::string_view chars(std::size_t _size) {
+        if (!has(_size)) {
+            throw UserException(UserException::Static, "Corrupted binary log", "the entry is truncated", __PRETTY_FUNCTION__);
+        }
+
+        const auto chars = m_data.substr(m_position, _size);
+        m_position += _size;
+
+        return chars;
+    }
+
+    [[nodiscard]]
+    std::size_t position() const noexcept { return m_position; }
+
+private:
+    std::string_view m_data;
+    std::size_t m_position = 0;
+};
+
+template<class V>
+void writeValue(std::ostream &_os, const V &_value) {
+    CharFastStackBuffer<char, 512> buffer;
+    buffer << _value;
+    _os << buffer;
+}
+}  // namespace
+
+BinaryLogDecoder::BinaryLogDecoder() : m_options() {
+}
+
+BinaryLogDecoder::BinaryLogDecoder(Options _options) : m_options(_options) {
+}
+
+std::size_t BinaryLogDecoder::decode(std::string_view _data, std::ostream &_os) {
+    std::size_t consumed = 0;
+
+    while (consumed < _data.size()) {
+        EntryReader reader(_data.substr(consumed));
+        const auto type = static_cast<BinaryLogFormat::EntryType>(reader.get<std::uint8_t>());
+
+        if (type == BinaryLogFormat::EntryType::Site) {
+            if (!reader.has(4 + 4 + 2)) {
+                break;
+            }
+
+            const auto id = reader.get<std::uint32_t>();
+            const auto line = reader.get<std::uint32_t>();
+            const auto fileSize = reader.get<std::uint16_t>();
+            if (!reader.has(fileSize)) {
+                break;
+            }
+
+            m_sites[id] = Site{std::string(reader.chars(fileSize)), line};
+            consumed += reader.position();
+        } else if (type == BinaryLogFormat::EntryType::Record) {
+            if (!reader.has(BinaryLogFormat::RecordHeaderSize - 1)) {
+                break;
+            }
+
+            const auto payloadSize = BinaryLogFormat::get<std::uint32_t>(_data.data() + consumed + BinaryLogFormat::PayloadSizeOffset);
+            const auto entrySize = BinaryLogFormat::RecordHeaderSize + payloadSize;
+            if (_data.size() - consumed < entrySize) {
+                break;
+            }
+
+            decodeRecord(_data.substr(consumed, entrySize), _os);
+            consumed += entrySize;
+        } else {
+            throw UserException(UserException::Static, "Corrupted binary log", "unknown entry type", __PRETTY_FUNCTION__);
+        }
+    }
+
+    return consumed;
+}
+
+void BinaryLogDecoder::decodeStream(std::istream &_is, std::ostream &_os) {
+    char header[sizeof(BinaryLogFormat::Magic) + sizeof(BinaryLogFormat::Version)];
+    if (!_is.read(header, sizeof(header)) ||
+        std::string_view(header, sizeof(BinaryLogFormat::Magic)) != std::string_view(BinaryLogFormat::Magic, sizeof(BinaryLogFormat::Magic))) {
+        throw UserException(UserException::Static, "The stream is not a binary log", "wrong magic", __PRETTY_FUNCTION__);
+    }
+
+    if (BinaryLogFormat::get<std::uint32_t>(header + sizeof(BinaryLogFormat::Magic)) != BinaryLogFormat::Version) {
+        throw UserException(UserException::Static, "Unsupported binary log version", "wrong version", __PRETTY_FUNCTION__);
+    }
+
+    std::string data;
+    std::string chunk(ReadChunkSize, '\0');
+    while (_is.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || _is.gcount() > 0) {
+        data.append(chunk.data(), static_cast<std::size_t>(_is.gcount()));
+        data.erase(0, decode(data, _os));
+    }
+
+    if (!data.empty()) {
+        throw UserException(UserException::Static, "Corrupted binary log", "the last entry is truncated", __PRETTY_FUNCTION__);
+    }
+}
+
+void BinaryLogDecoder::decodeRecord(std::string_view _entry, std::ostream &_os) const {
+    EntryReader reader(_entry);
+    reader.get<std::uint8_t>();
+    const auto level = reader.get<std::uint8_t>();
+    const auto siteId = reader.get<std::uint32_t>();
+    const auto timestamp = reader.get<std::int64_t>();
+    reader.get<std::uint32_t>();
+
+    char timestampChars[TimestampFormatter::MaxSize];
+    _os.write(timestampChars, static_cast<std::streamsize>(m_options.timestampFormatter.format(timestamp, timestampChars)));
+    _os << ' ';
+
+    if (m_options.withSite) {
+        _os << '[' << logLevelName(static_cast<LogLevel>(level)) << "] ";
+        if (const auto site = m_sites.find(siteId); site != m_sites.end()) {
+            _os << site->second.file << ':' << site->second.line << ' ';
+        }
+    }
+
+    using ArgType = BinaryLogFormat::ArgType;
+    while (reader.has(1)) {
+        switch (static_cast<ArgType>(reader.get<std::uint8_t>())) {
+            case ArgType::Bool:
+                writeValue(_os, reader.get<std::uint8_t>() != 0);
+                break;
+            case ArgType::Char:
+                _os << reader.get<char>();
+                break;
+            case ArgType::Int:
+                writeValue(_os, reader.get<std::int64_t>());
+                break;
+            case ArgType::UInt:
+                writeValue(_os, reader.get<std::uint64_t>());
+                break;
+            case ArgType::Double:
+                writeValue(_os, reader.get<double>());
+                break;
+            case ArgType::String:
+                _os << reader.chars(reader.get<std::uint32_t>());
+                break;
+            case ArgType::Pointer:
+                writeValue(_os, reinterpret_cast<const void *>(static_cast<std::uintptr_t>(reader.get<std::uint64_t>())));
+                break;
+            case ArgType::Hex:
+                if (reader.get<std::uint8_t>() != 0) {
+                    writeValue(_os, hexFormat(reader.get<std::int64_t>()));
+                } else {
+                    writeValue(_os, hexFormat(reader.get<std::uint64_t>()));
+                }
+                break;
+            case ArgType::Fixed: {
+                const auto value = reader.get<double>();
+                writeValue(_os, fixedFormat(value, reader.get<std::uint8_t>()));
+                break;
+            }
+            default:
+                throw UserException(UserException::Static, "Corrupted binary log", "unknown argument type", __PRETTY_FUNCTION__);
+        }
+    }
+
+    _os << '\n';
+}
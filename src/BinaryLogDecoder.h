@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "TimestampFormatter.h"
+
+/*!
+ * @brief BinaryLogDecoder turns the binary log entries (see BinaryLogFormat) into text records.
+ * The text record is the same as the one LogHelper writes in the text mode.
+ */
+class BinaryLogDecoder {
+public:
+    /*!
+     * @brief The decoding options.
+     */
+    struct Options {
+        /*!
+         * @brief The formatter of the record timestamps.
+         */
+        TimestampFormatter timestampFormatter;
+        /*!
+         * @brief Write the logging level and the source location after the timestamp.
+         */
+        bool withSite = false;
+    };
+
+    /*!
+     * @brief Construct a new BinaryLogDecoder object with the default options.
+     */
+    BinaryLogDecoder();
+
+    /*!
+     * @brief Construct a new BinaryLogDecoder object.
+     * @param _options - decoding options.
+     */
+    explicit BinaryLogDecoder(Options _options);
+
+    /*!
+     * @brief Decodes the complete entries at the beginning of the data. Every record is written as one line.
+     * @param _data - binary entries without the file header.
+     * @param _os - output stream.
+     * @return Number of consumed bytes. The incomplete entry at the end of the data is not consumed.
+     * @throw UserException - if the data is corrupted.
+     */
+    std::size_t decode(std::string_view _data, std::ostream &_os);
+
+    /*!
+     * @brief Decodes the binary log file.
+     * @param _is - input stream positioned at the file header.
+     * @param _os - output stream.
+     * @throw UserException - if the stream is not the binary log or the data is corrupted.
+     */
+    void decodeStream(std::istream &_is, std::ostream &_os);
+
+private:
+    /*!
+     * @brief The source location of the site.
+     */
+    struct Site {
+        std::string file;
+        std::uint32_t line;
+    };
+
+    /*!
+     * @brief Decodes the record payload.
+     */
+    void decodeRecord(std::string_view _entry, std::ostream &_os) const;
+
+    /*!
+     * @brief The decoding options.
+     */
+    Options m_options;
+
+    /*!
+     * @brief The sites by id.
+     */
+    std::unordered_map<std::uint32_t, Site> m_sites;
+};
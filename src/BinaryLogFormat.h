@@ -0,0 +1,302 @@
+#pragma once
+
+#include "CharFastStackBuffer.h"
+#include "EscapeFormat.h"
+#include "FormatString.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <string_view>
+#include <type_traits>
+
+/*!
+ * @brief LogSite is the static description of a logging statement. The STDCORE_LOG macros create one per statement.
+ * The binary log refers to the site by the id instead of repeating the file name in every record.
+ */
+struct LogSite {
+    /*!
+     * @brief Construct a new LogSite object.
+     * @param _file - source file name.
+     * @param _line - source line.
+     */
+    constexpr LogSite(const char *_file, int _line) noexcept : file(_file), line(_line) {}
+
+    /*!
+     * @brief The source file name.
+     */
+    const char *file;
+    /*!
+     * @brief The source line.
+     */
+    int line;
+    /*!
+     * @brief The site id, 0 until the site is registered by BinaryLogWriter::siteId().
+     */
+    mutable std::atomic<std::uint32_t> id{0};
+};
+
+/*!
+ * @brief BinaryLogFormat defines the binary log layout and encodes the records.
+ * The file starts with Magic and Version, followed by the entries. An entry starts with EntryType:
+ * - Site: id (u32), line (u32), file size (u16), file name;
+ * - Record: level (u8), site id (u32, 0 if unknown), timestamp in nanoseconds (i64), payload size (u32), payload.
+ * The payload is the sequence of the arguments, each argument starts with ArgType followed by the raw value.
+ * The numbers are stored in the native byte order.
+ */
+struct BinaryLogFormat {
+    /*!
+     * @brief The file signature.
+     */
+    static constexpr char Magic[4] = {'S', 'C', 'L', 'B'};
+
+    /*!
+     * @brief The format version.
+     */
+    static constexpr std::uint32_t Version = 1;
+
+    /*!
+     * @brief The entry type.
+     */
+    enum class EntryType : std::uint8_t {
+        Site = 1,
+        Record = 2
+    };
+
+    /*!
+     * @brief The argument type.
+     */
+    enum class ArgType : std::uint8_t {
+        //! u8.
+        Bool = 1,
+        //! char.
+        Char,
+        //! i64.
+        Int,
+        //! u64.
+        UInt,
+        //! double.
+        Double,
+        //! size (u32), chars.
+        String,
+        //! u64.
+        Pointer,
+        //! i64 or u64 depending on the sign flag (u8).
+        Hex,
+        //! double, precision (u8).
+        Fixed
+    };
+
+    /*!
+     * @brief The size of the record entry without payload.
+     */
+    static constexpr std::size_t RecordHeaderSize = 1 + 1 + 4 + 8 + 4;
+
+    /*!
+     * @brief The offset of the timestamp in the record entry.
+     */
+    static constexpr std::size_t TimestampOffset = 1 + 1 + 4;
+
+    /*!
+     * @brief The offset of the payload size in the record entry.
+     */
+    static constexpr std::size_t PayloadSizeOffset = RecordHeaderSize - 4;
+
+    /*!
+     * @brief Returned by beginString() if the String argument header does not fit into the truncating buffer.
+     */
+    static constexpr size_t NoPosition = static_cast<size_t>(-1);
+
+    /*!
+     * @brief Returns true if the argument of the size fits into the buffer. If the buffer truncates, an argument
+     * which does not fit is counted as truncated and skipped as a whole, so the payload stays decodable.
+     * Other buffers apply their overflow policy when the argument is written.
+     */
+    template<size_t N, class P>
+    static bool fits(CharFastStackBuffer<char, N, P> &_buffer, size_t _size) noexcept {
+        if constexpr (P::Truncates) {
+            if (N - static_cast<size_t>(_buffer.size()) < _size) {
+                _buffer.addTruncated(_size);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /*!
+     * @brief Appends the raw value.
+     */
+    template<class V, size_t N, class P>
+    static void put(CharFastStackBuffer<char, N, P> &_buffer, V _value) {
+        static_assert(std::is_trivially_copyable_v<V>);
+        char bytes[sizeof(V)];
+        std::memcpy(bytes, &_value, sizeof(V));
+        _buffer.append(bytes, sizeof(V));
+    }
+
+    /*!
+     * @brief Reads the raw value.
+     */
+    template<class V>
+    static V get(const char *_data) noexcept {
+        V value;
+        std::memcpy(&value, _data, sizeof(V));
+        return value;
+    }
+
+    /*!
+     * @brief Writes the record header. The payload size is written by endRecord().
+     * @param _buffer - record buffer, must be empty.
+     * @param _level - logging level.
+     * @param _siteId - site id.
+     * @param _timestamp - timestamp in nanoseconds since the epoch.
+     */
+    template<size_t N, class P>
+    static void beginRecord(CharFastStackBuffer<char, N, P> &_buffer, std::uint8_t _level, std::uint32_t _siteId, std::int64_t _timestamp) {
+        put(_buffer, EntryType::Record);
+        put(_buffer, _level);
+        put(_buffer, _siteId);
+        put(_buffer, _timestamp);
+        put(_buffer, std::uint32_t{0});
+    }
+
+    /*!
+     * @brief Writes the payload size to the record header.
+     */
+    template<size_t N, class P>
+    static void endRecord(CharFastStackBuffer<char, N, P> &_buffer) noexcept {
+        const auto payloadSize = static_cast<std::uint32_t>(static_cast<size_t>(_buffer.size()) - RecordHeaderSize);
+        std::memcpy(_buffer.data() + PayloadSizeOffset, &payloadSize, sizeof(payloadSize));
+    }
+
+    /*!
+     * @brief Writes the String argument header. The chars are written by the caller, the size by endString().
+     * @return The position of the string size or NoPosition if the header does not fit.
+     */
+    template<size_t N, class P>
+    static size_t beginString(CharFastStackBuffer<char, N, P> &_buffer) {
+        if (!fits(_buffer, 1 + sizeof(std::uint32_t))) {
+            return NoPosition;
+        }
+
+        put(_buffer, ArgType::String);
+        const auto position = static_cast<size_t>(_buffer.size());
+        put(_buffer, std::uint32_t{0});
+
+        return position;
+    }
+
+    /*!
+     * @brief Writes the size of the String argument started by beginString().
+     */
+    template<size_t N, class P>
+    static void endString(CharFastStackBuffer<char, N, P> &_buffer, size_t _position) noexcept {
+        const auto size = static_cast<std::uint32_t>(static_cast<size_t>(_buffer.size()) - _position - sizeof(std::uint32_t));
+        std::memcpy(_buffer.data() + _position, &size, sizeof(size));
+    }
+
+    /*!
+     * @brief Encodes the argument, it must satisfy IsBufferFormattable_v.
+     */
+    template<size_t N, class P, class T>
+    static void encode(CharFastStackBuffer<char, N, P> &_buffer, const T &_value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (!fits(_buffer, 1 + 1)) {
+                return;
+            }
+
+            put(_buffer, ArgType::Bool);
+            put(_buffer, static_cast<std::uint8_t>(_value));
+        } else if constexpr (std::is_same_v<T, char>) {
+            if (!fits(_buffer, 1 + 1)) {
+                return;
+            }
+
+            put(_buffer, ArgType::Char);
+            put(_buffer, _value);
+        } else if constexpr (std::is_arithmetic_v<T> || (std::is_pointer_v<T> && !std::is_convertible_v<const T &, std::string_view>)) {
+            if (!fits(_buffer, 1 + 8)) {
+                return;
+            }
+
+            encodeNumber(_buffer, _value);
+        } else if constexpr (std::is_base_of_v<std::exception, T> || std::is_same_v<T, ExceptionFormat> || IsFormatArgs_v<T> ||
+                             std::is_same_v<T, EscapeFormat>) {
+            // the exception, the formatted and the escaped strings are written straight into the String argument.
+            if (const auto position = beginString(_buffer); position != NoPosition) {
+                _buffer << _value;
+                endString(_buffer, position);
+            }
+        } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+            if constexpr (std::is_pointer_v<T>) {
+                if (_value == nullptr) {
+                    encode(_buffer, static_cast<const void *>(nullptr));
+                    return;
+                }
+            }
+
+            std::string_view view(_value);
+            if (!fits(_buffer, 1 + sizeof(std::uint32_t))) {
+                _buffer.addTruncated(view.size());
+                return;
+            }
+
+            if constexpr (P::Truncates) {
+                // the string is clamped, the header of the next argument would not fit anyway.
+                const auto freeSize = N - static_cast<size_t>(_buffer.size()) - 1 - sizeof(std::uint32_t);
+                if (view.size() > freeSize) {
+                    _buffer.addTruncated(view.size() - freeSize);
+                    view = view.substr(0, freeSize);
+                }
+            }
+
+            put(_buffer, ArgType::String);
+            put(_buffer, static_cast<std::uint32_t>(view.size()));
+            _buffer.append(view.data(), view.size());
+        } else {
+            if (!fits(_buffer, 1 + 1 + 8)) {
+                return;
+            }
+
+            encodeFormat(_buffer, _value);
+        }
+    }
+
+private:
+    template<size_t N, class P, class T>
+    static void encodeNumber(CharFastStackBuffer<char, N, P> &_buffer, T _value) {
+        if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            put(_buffer, ArgType::Int);
+            put(_buffer, static_cast<std::int64_t>(_value));
+        } else if constexpr (std::is_integral_v<T>) {
+            put(_buffer, ArgType::UInt);
+            put(_buffer, static_cast<std::uint64_t>(_value));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            put(_buffer, ArgType::Double);
+            put(_buffer, static_cast<double>(_value));
+        } else {
+            put(_buffer, ArgType::Pointer);
+            put(_buffer, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(_value)));
+        }
+    }
+
+    template<size_t N, class P, class V>
+    static void encodeFormat(CharFastStackBuffer<char, N, P> &_buffer, const HexFormat<V> &_format) {
+        put(_buffer, ArgType::Hex);
+        put(_buffer, static_cast<std::uint8_t>(std::is_signed_v<V>));
+        if constexpr (std::is_signed_v<V>) {
+            put(_buffer, static_cast<std::int64_t>(_format.value));
+        } else {
+            put(_buffer, static_cast<std::uint64_t>(_format.value));
+        }
+    }
+
+    template<size_t N, class P, class V>
+    static void encodeFormat(CharFastStackBuffer<char, N, P> &_buffer, const FixedFormat<V> &_format) {
+        put(_buffer, ArgType::Fixed);
+        put(_buffer, static_cast<double>(_format.value));
+        put(_buffer, static_cast<std::uint8_t>(_format.precision));
+    }
+};
@@ -0,0 +1,334 @@
+#include "BinaryLogWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace {
+//! The background thread drains the staging buffers at least this often.
+constexpr auto DrainInterval = std::chrono::milliseconds(1);
+
+//! The source of the writer ids.
+std::atomic<std::uint64_t> g_nextWriterId{1};
+
+//! Guards g_sites.
+std::mutex g_sitesMutex;
+//! The registered sites, the site id is the index plus one.
+std::vector<const LogSite *> g_sites;
+}  // namespace
+
+/*!
+ * @brief The staging buffer of one thread. The owner thread advances head, the draining thread advances tail.
+ */
+struct BinaryLogWriter::StagingBuffer {
+    alignas(64) std::atomic<std::size_t> head{0};
+    //! The owner thread is inside push(), stop() waits until it leaves. It shares the cache line of head.
+    std::atomic<bool> pushing{false};
+    alignas(64) std::atomic<std::size_t> tail{0};
+    //! The owner thread has finished, the buffer is removed once it is drained.
+    std::atomic<bool> retired{false};
+    char data[StagingCapacity];
+
+    /*!
+     * @brief Copies the bytes at the position of the ring.
+     */
+    void read(std::size_t _position, char *_out, std::size_t _size) const noexcept {
+        const auto offset = _position % StagingCapacity;
+        const auto firstPart = std::min(_size, StagingCapacity - offset);
+        std::memcpy(_out, data + offset, firstPart);
+        std::memcpy(_out + firstPart, data, _size - firstPart);
+    }
+
+    /*!
+     * @brief Appends the bytes at the position of the ring.
+     */
+    void appendTo(std::string &_out, std::size_t _position, std::size_t _size) const {
+        const auto offset = _position % StagingCapacity;
+        const auto firstPart = std::min(_size, StagingCapacity - offset);
+        _out.append(data + offset, firstPart);
+        _out.append(data, _size - firstPart);
+    }
+};
+
+namespace {
+/*!
+ * @brief The next staged entry of a buffer in the merge of drain().
+ */
+template<class StagingBuffer_t>
+struct StagedEntry {
+    const StagingBuffer_t *buffer;
+    std::size_t position;
+    std::size_t end;
+    std::size_t size = 0;
+    std::int64_t timestamp = 0;
+
+    /*!
+     * @brief Reads the header of the entry at the position. An entry which is not a complete record is taken
+     * with the rest of the buffer at once.
+     */
+    void load() noexcept {
+        size = end - position;
+        timestamp = std::numeric_limits<std::int64_t>::min();
+        if (size < BinaryLogFormat::RecordHeaderSize) {
+            return;
+        }
+
+        char header[BinaryLogFormat::RecordHeaderSize];
+        buffer->read(position, header, sizeof(header));
+        const auto payloadSize = BinaryLogFormat::get<std::uint32_t>(header + BinaryLogFormat::PayloadSizeOffset);
+        if (static_cast<BinaryLogFormat::EntryType>(header[0]) != BinaryLogFormat::EntryType::Record ||
+            payloadSize > size - BinaryLogFormat::RecordHeaderSize) {
+            return;
+        }
+
+        size = BinaryLogFormat::RecordHeaderSize + payloadSize;
+        timestamp = BinaryLogFormat::get<std::int64_t>(header + BinaryLogFormat::TimestampOffset);
+    }
+};
+}  // namespace
+
+namespace {
+/*!
+ * @brief The staging buffer of the calling thread and the writer it belongs to.
+ */
+template<class StagingBuffer_t>
+struct ThreadStagingBuffer {
+    std::uint64_t writerId = 0;
+    std::shared_ptr<StagingBuffer_t> buffer;
+
+    ~ThreadStagingBuffer() {
+        if (buffer) {
+            buffer->retired.store(true, std::memory_order_release);
+        }
+    }
+};
+}  // namespace
+
+BinaryLogWriter::BinaryLogWriter(std::ostream &_os, Output _output, BinaryLogDecoder::Options _decoderOptions)
+    : m_id(g_nextWriterId.fetch_add(1)),
+      m_os(_os),
+      m_output(_output),
+      m_decoder(_decoderOptions) {
+    if (m_output == Output::Binary) {
+        m_os.write(BinaryLogFormat::Magic, sizeof(BinaryLogFormat::Magic));
+        const auto version = BinaryLogFormat::Version;
+        m_os.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+
+    m_thread = std::thread(&BinaryLogWriter::run, this);
+}
+
+BinaryLogWriter::~BinaryLogWriter() {
+    stop();
+}
+
+std::uint32_t BinaryLogWriter::siteId(const LogSite &_site) {
+    if (const auto id = _site.id.load(std::memory_order_acquire); id != 0) {
+        return id;
+    }
+
+    std::lock_guard lock(g_sitesMutex);
+    if (const auto id = _site.id.load(std::memory_order_relaxed); id != 0) {
+        return id;
+    }
+
+    g_sites.push_back(&_site);
+    const auto id = static_cast<std::uint32_t>(g_sites.size());
+    _site.id.store(id, std::memory_order_release);
+
+    return id;
+}
+
+bool BinaryLogWriter::push(std::string_view _record) noexcept {
+    if (_record.size() > StagingCapacity || !m_accepting.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    StagingBuffer *buffer = nullptr;
+    try {
+        buffer = &threadBuffer();
+    } catch (...) {
+        return false;
+    }
+
+    // the flag is stored before m_accepting is loaded, so stop() either sees the flag or this thread sees the stop.
+    buffer->pushing.store(true);
+    if (!m_accepting.load()) {
+        buffer->pushing.store(false, std::memory_order_release);
+        return false;
+    }
+
+    const auto head = buffer->head.load(std::memory_order_relaxed);
+    const auto hasSpace = [buffer, head, &_record] {
+        return StagingCapacity - (head - buffer->tail.load(std::memory_order_acquire)) >= _record.size();
+    };
+    if (!hasSpace()) {
+        // the background thread is woken up and signals m_spaceCv after the drain.
+        std::unique_lock lock(m_wakeMutex);
+        while (!hasSpace()) {
+            m_wakeCv.notify_one();
+            m_spaceCv.wait_for(lock, DrainInterval);
+        }
+    }
+
+    const auto offset = head % StagingCapacity;
+    const auto firstPart = std::min(_record.size(), StagingCapacity - offset);
+    std::memcpy(buffer->data + offset, _record.data(), firstPart);
+    std::memcpy(buffer->data, _record.data() + firstPart, _record.size() - firstPart);
+    buffer->head.store(head + _record.size(), std::memory_order_release);
+
+    buffer->pushing.store(false, std::memory_order_release);
+
+    return true;
+}
+
+void BinaryLogWriter::flush() {
+    std::lock_guard lock(m_drainMutex);
+    drain();
+}
+
+void BinaryLogWriter::stop() {
+    m_accepting.store(false);
+
+    // a buffer registered after the copy belongs to a producer which sees the stop.
+    std::vector<std::shared_ptr<StagingBuffer>> buffers;
+    {
+        std::lock_guard lock(m_buffersMutex);
+        buffers = m_buffers;
+    }
+    for (const auto &buffer : buffers) {
+        // the producer may wait for the space which the drain frees.
+        while (buffer->pushing.load()) {
+            flush();
+            std::this_thread::yield();
+        }
+    }
+
+    m_running.store(false);
+    m_wakeCv.notify_one();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    flush();
+}
+
+BinaryLogWriter::StagingBuffer &BinaryLogWriter::threadBuffer() {
+    thread_local ThreadStagingBuffer<StagingBuffer> threadBuffer;
+
+    if (threadBuffer.writerId != m_id || !threadBuffer.buffer) {
+        if (threadBuffer.buffer) {
+            threadBuffer.buffer->retired.store(true, std::memory_order_release);
+        }
+
+        threadBuffer.buffer = std::make_shared<StagingBuffer>();
+        threadBuffer.writerId = m_id;
+
+        std::lock_guard lock(m_buffersMutex);
+        m_buffers.push_back(threadBuffer.buffer);
+    }
+
+    return *threadBuffer.buffer;
+}
+
+void BinaryLogWriter::drain() {
+    std::vector<std::shared_ptr<StagingBuffer>> buffers;
+    {
+        std::lock_guard lock(m_buffersMutex);
+        buffers = m_buffers;
+    }
+
+    std::vector<std::size_t> heads;
+    heads.reserve(buffers.size());
+    for (const auto &buffer : buffers) {
+        heads.push_back(buffer->head.load(std::memory_order_acquire));
+    }
+
+    // the sites used by the records are registered before the records are staged.
+    {
+        std::lock_guard lock(g_sitesMutex);
+        for (; m_sitesWritten < g_sites.size(); ++m_sitesWritten) {
+            const auto *site = g_sites[m_sitesWritten];
+            const auto fileSize = static_cast<std::uint16_t>(std::min<std::size_t>(std::strlen(site->file), UINT16_MAX));
+            const auto id = static_cast<std::uint32_t>(m_sitesWritten + 1);
+            const auto line = static_cast<std::uint32_t>(site->line);
+
+            m_pending.push_back(static_cast<char>(BinaryLogFormat::EntryType::Site));
+            m_pending.append(reinterpret_cast<const char *>(&id), sizeof(id));
+            m_pending.append(reinterpret_cast<const char *>(&line), sizeof(line));
+            m_pending.append(reinterpret_cast<const char *>(&fileSize), sizeof(fileSize));
+            m_pending.append(site->file, fileSize);
+        }
+    }
+
+    // every buffer is ordered by time, the records of the threads are merged by their timestamps.
+    std::vector<StagedEntry<StagingBuffer>> entries;
+    entries.reserve(buffers.size());
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        if (const auto tail = buffers[i]->tail.load(std::memory_order_relaxed); tail != heads[i]) {
+            entries.push_back(StagedEntry<StagingBuffer>{buffers[i].get(), tail, heads[i]});
+            entries.back().load();
+        }
+    }
+
+    while (!entries.empty()) {
+        const auto next = std::min_element(entries.begin(), entries.end(), [](const auto &_left, const auto &_right) {
+            return _left.timestamp < _right.timestamp;
+        });
+
+        next->buffer->appendTo(m_pending, next->position, next->size);
+        next->position += next->size;
+        if (next->position == next->end) {
+            entries.erase(next);
+        } else {
+            next->load();
+        }
+    }
+
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        buffers[i]->tail.store(heads[i], std::memory_order_release);
+    }
+    {
+        std::lock_guard lock(m_wakeMutex);
+        m_spaceCv.notify_all();
+    }
+
+    {
+        std::lock_guard lock(m_buffersMutex);
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), [](const auto &_buffer) {
+            return _buffer->retired.load(std::memory_order_acquire) &&
+                   _buffer->head.load(std::memory_order_acquire) == _buffer->tail.load(std::memory_order_relaxed);
+        }), m_buffers.end());
+    }
+
+    if (m_pending.empty()) {
+        return;
+    }
+
+    if (m_output == Output::Binary) {
+        m_os.write(m_pending.data(), static_cast<std::streamsize>(m_pending.size()));
+    } else {
+        try {
+            m_decoder.decode(m_pending, m_os);
+        } catch (const std::exception &) {
+            // the corrupted entries are dropped.
+        }
+    }
+
+    m_os.flush();
+    m_pending.clear();
+}
+
+void BinaryLogWriter::run() {
+    while (m_running.load()) {
+        {
+            std::lock_guard lock(m_drainMutex);
+            drain();
+        }
+
+        std::unique_lock lock(m_wakeMutex);
+        m_wakeCv.wait_for(lock, DrainInterval, [this] { return !m_running.load(); });
+    }
+}
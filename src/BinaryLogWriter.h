@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "BinaryLogDecoder.h"
+#include "BinaryLogFormat.h"
+
+/*!
+ * @brief BinaryLogWriter collects the binary log records (see BinaryLogFormat) of all threads.
+ * Every thread copies its records into its own staging buffer, a single-producer single-consumer byte ring,
+ * so the hot path takes no lock and writes no shared cache line. A background thread drains the staging buffers, merges the records
+ * of the threads by their timestamps and either writes the entries to the stream as they are or decodes them into text.
+ * The records are ordered within one drain, a record staged after a drain comes after the records it has taken.
+ */
+class BinaryLogWriter {
+public:
+    /*!
+     * @brief The output of the writer.
+     */
+    enum class Output {
+        //! The binary log, decoded offline by BinaryLogDecoder.
+        Binary,
+        //! Text records formatted by the background thread.
+        Text
+    };
+
+    /*!
+     * @brief The size of the staging buffer of one thread.
+     */
+    static constexpr std::size_t StagingCapacity = 64 * 1024;
+
+    /*!
+     * @brief Construct a new BinaryLogWriter object and start the background thread.
+     * In the Binary output mode the file header is written at once.
+     * @param _os - output stream. It is used only under the writer lock.
+     * @param _output - output mode.
+     * @param _decoderOptions - decoding options of the Text output mode.
+     */
+    explicit BinaryLogWriter(std::ostream &_os,
+                             Output _output = Output::Binary,
+                             BinaryLogDecoder::Options _decoderOptions = BinaryLogDecoder::Options{});
+
+    /*!
+     * @brief Destroy the BinaryLogWriter object. All staged records are written before the background thread stops.
+     */
+    ~BinaryLogWriter();
+
+    BinaryLogWriter(const BinaryLogWriter &) = delete;
+    BinaryLogWriter &operator=(const BinaryLogWriter &) = delete;
+
+    /*!
+     * @brief Returns the id of the site, registering the site on the first call.
+     */
+    static std::uint32_t siteId(const LogSite &_site);
+
+    /*!
+     * @brief Copies the record entry into the staging buffer of the calling thread.
+     * Waits on a condition variable for the background thread if the staging buffer is full.
+     * @param _record - record entry built by BinaryLogFormat.
+     * @return false if the writer does not accept records anymore.
+     */
+    bool push(std::string_view _record) noexcept;
+
+    /*!
+     * @brief Writes all records pushed before the call and flushes the stream.
+     */
+    void flush();
+
+    /*!
+     * @brief Writes all staged records and stops the background thread. Subsequent push() calls return false.
+     */
+    void stop();
+
+private:
+    struct StagingBuffer;
+
+    /*!
+     * @brief Returns the staging buffer of the calling thread, creating it on the first call.
+     */
+    StagingBuffer &threadBuffer();
+
+    /*!
+     * @brief Moves the staged records and the new sites to the output. The caller holds m_drainMutex.
+     */
+    void drain();
+
+    /*!
+     * @brief The background thread function.
+     */
+    void run();
+
+    /*!
+     * @brief The unique id of the writer, it tells the staging buffers of different writers apart.
+     */
+    const std::uint64_t m_id;
+    /*!
+     * @brief Output stream.
+     */
+    std::ostream &m_os;
+    /*!
+     * @brief Output mode.
+     */
+    const Output m_output;
+    /*!
+     * @brief The decoder of the Text output mode.
+     */
+    BinaryLogDecoder m_decoder;
+
+    /*!
+     * @brief Guards m_buffers.
+     */
+    std::mutex m_buffersMutex;
+    /*!
+     * @brief Staging buffers of the threads.
+     */
+    std::vector<std::shared_ptr<StagingBuffer>> m_buffers;
+
+    /*!
+     * @brief Serializes drain().
+     */
+    std::mutex m_drainMutex;
+    /*!
+     * @brief The drained entries.
+     */
+    std::string m_pending;
+    /*!
+     * @brief Number of sites written to the output.
+     */
+    std::size_t m_sitesWritten = 0;
+
+    /*!
+     * @brief The writer accepts new records.
+     */
+    std::atomic<bool> m_accepting{true};
+    /*!
+     * @brief The background thread keeps running.
+     */
+    std::atomic<bool> m_running{true};
+    /*!
+     * @brief Guards m_wakeCv and m_spaceCv.
+     */
+    std::mutex m_wakeMutex;
+    /*!
+     * @brief Wakes the background thread up.
+     */
+    std::condition_variable m_wakeCv;
+    /*!
+     * @brief Signaled after a drain, it wakes up the producers waiting for the space in their staging buffers.
+     */
+    std::condition_variable m_spaceCv;
+    /*!
+     * @brief The background thread.
+     */
+    std::thread m_thread;
+};
@@ -1,59 +1,306 @@
 #ifndef CHARFASTSTACKBUFFER_H
 #define CHARFASTSTACKBUFFER_H
 
+#include "FastSmallVector.h"
 #include "FastStackBuffer.h"
 
 #include "UserException.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <iosfwd>
 #include <iterator>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+/*!
+ * @brief The storage of CharFastStackBuffer: FastSmallVector for GrowOnOverflow, FastStackBuffer for the other policies.
+ */
+template<class Char_t, size_t N, class OverflowPolicy_t>
+using CharFastStackStorage = std::conditional_t<IsGrowingPolicy_v<OverflowPolicy_t>,
+                                                FastSmallVector<Char_t, N>,
+                                                FastStackBuffer<Char_t, N, OverflowPolicy_t>>;
 
 /*!
  * @brief CharFastStackBuffer is class is stack of chars;
- * @tparam N - stack size.
+ * @tparam N - stack size, the inline capacity for GrowOnOverflow.
+ * @tparam OverflowPolicy_t - the stack overflow policy, see FastStackBuffer. With GrowOnOverflow the chars which
+ * do not fit are moved to the heap, see FastSmallVector.
  */
-template<class Char_t = char, size_t N = 1024>
-class CharFastStackBuffer : public FastStackBuffer<Char_t, N> {
+template<class Char_t = char, size_t N = 1024, class OverflowPolicy_t = ThrowOnOverflow>
+class CharFastStackBuffer : public CharFastStackStorage<Char_t, N, OverflowPolicy_t> {
+public:
+    /*!
+     * @brief Returns the view of the chars pushed onto the stack.
+     */
+    [[nodiscard]]
+    std::basic_string_view<Char_t> view() const noexcept {
+        return {this->data(), static_cast<size_t>(this->size())};
+    }
+
+    /*!
+     * @brief The size of the temporary array used when the formatted value does not fit into the free part of the stack.
+     */
+    static constexpr size_t MaxFormattedSize = 384;
+
+    /*!
+     * @brief Writes the chars produced by the formatter straight into the free part of the stack.
+     * If they do not fit, the formatter writes into a temporary array which is appended by append().
+     * @param _formatter - callable (char *first, char *last) -> std::to_chars_result.
+     */
+    template<class Formatter_t>
+    void appendFormatted(Formatter_t &&_formatter);
+
+    /*!
+     * @brief Replaces the tail of the stack with "\u2026[truncated N bytes]" if the overflow policy is
+     * TruncateWithMarkerOnOverflow and some chars have been dropped. N counts the overwritten chars too.
+     * Does nothing for the other policies.
+     */
+    void writeTruncationMarker() noexcept;
+
 private:
     /*!
      * @brief Write the values of this stack to the stream.
      * @param _os - output stream.
      * @param _buff - instace of the CharFastStackBuffer.
      */
-    template<class OS_t, class Buffer_t>
-    friend OS_t &operator<<(OS_t &_os, const Buffer_t &_buff);
+    template<class OS_t, class C, size_t M, class P>
+    friend OS_t &operator<<(OS_t &_os, const CharFastStackBuffer<C, M, P> &_buff);
 };
 
-template<class Char_t = char, size_t N = 1024>
-CharFastStackBuffer<Char_t, N> &operator<<(CharFastStackBuffer<Char_t, N> &_buffer, const std::exception &_exception) {
-    _buffer << _exception.what();
+/*!
+ * @brief ExceptionFormat writes the exception with the options of UserException::writeTo().
+ */
+struct ExceptionFormat {
+    const std::exception &exception;
+    UserException::WriteOptions options;
+};
+
+/*!
+ * @brief Returns the format of the exception, e.g. exceptionFormat(e, {true, 4}) writes 4 levels of the nested chain on one line.
+ */
+inline ExceptionFormat exceptionFormat(const std::exception &_exception, UserException::WriteOptions _options) noexcept {
+    return {_exception, _options};
+}
+
+template<class Char_t = char, size_t N = 1024, class OverflowPolicy_t>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, ExceptionFormat _format) {
+    if constexpr (std::is_same_v<Char_t, char>) {
+        // UserException is written straight into the stack, what() would build and cache the whole string.
+        if (const auto *exception = dynamic_cast<const UserException *>(&_format.exception); exception != nullptr) {
+            exception->writeTo(_buffer, _format.options);
+            return _buffer;
+        }
+    }
+
+    _buffer << _format.exception.what();
 
     return _buffer;
 }
 
-template<class OS_t, class Buffer_t>
-OS_t &operator<<(OS_t &_os, const Buffer_t &_buff) {
-    std::copy(_buff.m_buffer.cbegin(), _buff.m_buffer.cend(), std::ostreambuf_iterator(_os));
+template<class Char_t = char, size_t N = 1024, class OverflowPolicy_t>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, const std::exception &_exception) {
+    return _buffer << ExceptionFormat{_exception, UserException::WriteOptions{}};
+}
+
+template<class OS_t, class Char_t, size_t N, class OverflowPolicy_t>
+OS_t &operator<<(OS_t &_os, const CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buff) {
+    const auto view = _buff.view();
+    std::copy(view.cbegin(), view.cend(), std::ostreambuf_iterator(_os));
 
     return _os;
 }
 
-template<class Char_t = char, size_t N = 1024, class CharSeq_t>
-CharFastStackBuffer<Char_t, N> &
-operator<<(CharFastStackBuffer<Char_t, N> &_buffer, const CharSeq_t &_value) {
-    std::copy(std::cbegin(_value), std::cend(_value), FastStackBufferOutputIterator(_buffer));
+template<class Char_t = char, size_t N = 1024, class OverflowPolicy_t, class CharSeq_t,
+        typename = typename std::enable_if_t<!std::is_arithmetic_v<CharSeq_t> &&
+                                             !std::is_base_of_v<std::exception, CharSeq_t> &&
+                                             (!std::is_pointer_v<CharSeq_t> ||
+                                              std::is_convertible_v<CharSeq_t, const Char_t *>)>>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &
+operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, const CharSeq_t &_value) {
+    if constexpr (std::is_pointer_v<CharSeq_t>) {
+        if (_value == nullptr) {
+            _buffer << static_cast<const void *>(nullptr);
+        } else {
+            const std::basic_string_view<Char_t> view(_value);
+            _buffer.append(view.data(), view.size());
+        }
+    } else if constexpr (std::is_convertible_v<const CharSeq_t &, std::basic_string_view<Char_t>>) {
+        const std::basic_string_view<Char_t> view(_value);
+        _buffer.append(view.data(), view.size());
+    } else {
+        _buffer.append(_value);
+    }
 
     return _buffer;
 }
 
-template<class Char_t = char, size_t N, class V,
+/*!
+ * @brief HexFormat writes the integral value in the hexadecimal notation.
+ */
+template<class V>
+struct HexFormat {
+    V value;
+};
+
+/*!
+ * @brief FixedFormat writes the floating point value in the fixed notation with the given number of decimals.
+ */
+template<class V>
+struct FixedFormat {
+    V value;
+    int precision;
+};
+
+/*!
+ * @brief Returns the hexadecimal format of the integral value.
+ */
+template<class V, typename = typename std::enable_if_t<std::is_integral_v<V>>>
+constexpr HexFormat<V> hexFormat(V _value) noexcept {
+    return {_value};
+}
+
+/*!
+ * @brief Returns the fixed format of the floating point value. The precision is clamped to [0, 32].
+ */
+template<class V, typename = typename std::enable_if_t<std::is_floating_point_v<V>>>
+constexpr FixedFormat<V> fixedFormat(V _value, int _precision) noexcept {
+    return {_value, std::clamp(_precision, 0, 32)};
+}
+
+template<class Char_t, size_t N, class OverflowPolicy_t>
+template<class Formatter_t>
+void CharFastStackBuffer<Char_t, N, OverflowPolicy_t>::appendFormatted(Formatter_t &&_formatter) {
+    if constexpr (std::is_same_v<Char_t, char>) {
+        char *first = this->data() + this->size();
+        const auto result = _formatter(first, this->data() + this->capacity());
+        if (result.ec == std::errc()) {
+            this->resizeUninitialized(static_cast<size_t>(result.ptr - this->data()));
+            return;
+        }
+    }
+
+    char chars[MaxFormattedSize];
+    const auto result = _formatter(chars, chars + MaxFormattedSize);
+    if (result.ec != std::errc()) {
+        return;
+    }
+
+    if constexpr (std::is_same_v<Char_t, char>) {
+        this->append(chars, static_cast<size_t>(result.ptr - chars));
+    } else {
+        Char_t wideChars[MaxFormattedSize];
+        const auto last = std::copy(static_cast<const char *>(chars), static_cast<const char *>(result.ptr), wideChars);
+        this->append(wideChars, static_cast<size_t>(last - wideChars));
+    }
+}
+
+template<class Char_t, size_t N, class OverflowPolicy_t>
+void CharFastStackBuffer<Char_t, N, OverflowPolicy_t>::writeTruncationMarker() noexcept {
+    if constexpr (OverflowPolicy_t::Truncates) {
+        if constexpr (OverflowPolicy_t::WritesMarker) {
+            if (this->truncated() == 0) {
+                return;
+            }
+
+            // U+2026 in UTF-8 for char, "..." for the wide chars.
+            constexpr std::string_view ellipsis = std::is_same_v<Char_t, char> ? "\xE2\x80\xA6" : "...";
+            constexpr std::string_view prefix = "[truncated ";
+            constexpr std::string_view suffix = " bytes]";
+
+            const auto size = static_cast<size_t>(this->size());
+            char marker[ellipsis.size() + prefix.size() + suffix.size() + 20];
+            size_t markerSize = 0;
+            // the overwritten chars are counted too, so the marker size depends on the count it contains.
+            for (size_t previousSize = 1; markerSize != previousSize;) {
+                previousSize = markerSize;
+                const auto overwritten = size + previousSize > N ? size + previousSize - N : 0;
+                char *it = std::copy(ellipsis.cbegin(), ellipsis.cend(), marker);
+                it = std::copy(prefix.cbegin(), prefix.cend(), it);
+                it = std::to_chars(it, marker + sizeof(marker), this->truncated() + overwritten).ptr;
+                it = std::copy(suffix.cbegin(), suffix.cend(), it);
+                markerSize = static_cast<size_t>(it - marker);
+            }
+
+            if (markerSize > N) {
+                return;
+            }
+
+            const auto first = std::min(size, N - markerSize);
+            std::copy(marker, marker + markerSize, this->data() + first);
+            this->resizeUninitialized(first + markerSize);
+        }
+    }
+}
+
+template<class Char_t = char, size_t N, class OverflowPolicy_t, class V,
         typename = typename std::enable_if_t<
                 std::is_integral_v<V> ||
                 std::is_floating_point_v<V>>>
-CharFastStackBuffer<Char_t, N> &operator<<(CharFastStackBuffer<Char_t, N> &_buffer, V _val) {
-    _buffer << std::to_string(_val);
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, V _val) {
+    if constexpr (std::is_same_v<V, bool>) {
+        _buffer << std::string_view(_val ? "true" : "false");
+    } else if constexpr (std::is_same_v<V, Char_t>) {
+        _buffer.push(_val);
+    } else {
+        _buffer.appendFormatted([_val](char *_first, char *_last) { return std::to_chars(_first, _last, _val); });
+    }
+
+    return _buffer;
+}
+
+template<class Char_t = char, size_t N, class OverflowPolicy_t, class V>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, HexFormat<V> _format) {
+    _buffer.appendFormatted([_format](char *_first, char *_last) { return std::to_chars(_first, _last, _format.value, 16); });
+
+    return _buffer;
+}
+
+template<class Char_t = char, size_t N, class OverflowPolicy_t, class V>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, FixedFormat<V> _format) {
+    _buffer.appendFormatted([_format](char *_first, char *_last) {
+        return std::to_chars(_first, _last, _format.value, std::chars_format::fixed, _format.precision);
+    });
+
+    return _buffer;
+}
+
+/*!
+ * @brief Writes the pointer as "0x" followed by the hexadecimal address.
+ */
+template<class Char_t = char, size_t N, class OverflowPolicy_t>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &operator<<(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_buffer, const void *_pointer) {
+    _buffer.appendFormatted([_pointer](char *_first, char *_last) {
+        if (_last - _first < 2) {
+            return std::to_chars_result{_last, std::errc::value_too_large};
+        }
+
+        _first[0] = '0';
+        _first[1] = 'x';
+        return std::to_chars(_first + 2, _last, reinterpret_cast<std::uintptr_t>(_pointer), 16);
+    });
 
     return _buffer;
 }
 
+/*!
+ * @brief IsBufferFormattable is true if CharFastStackBuffer writes the value itself, without std::ostream.
+ */
+template<class T, class Char_t = char>
+inline constexpr bool IsBufferFormattable_v = std::is_arithmetic_v<T>
+                                              || std::is_pointer_v<T>
+                                              || std::is_convertible_v<const T &, std::basic_string_view<Char_t>>
+                                              || std::is_base_of_v<std::exception, T>;
+
+template<class V, class Char_t>
+inline constexpr bool IsBufferFormattable_v<HexFormat<V>, Char_t> = true;
+
+template<class V, class Char_t>
+inline constexpr bool IsBufferFormattable_v<FixedFormat<V>, Char_t> = true;
+
+template<class Char_t>
+inline constexpr bool IsBufferFormattable_v<ExceptionFormat, Char_t> = true;
+
 #endif  // CHARFASTSTACKBUFFER_H
@@ -0,0 +1,278 @@
+#include "EscapeFormat.h"
+
+#include <array>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define STDCORE_ESCAPE_X86 1
+#include <immintrin.h>
+#else
+#define STDCORE_ESCAPE_X86 0
+#endif
+
+namespace {
+/*!
+ * @brief The scanner of a mode: returns the position of the first char which needs escaping or the size.
+ */
+using Kernel = std::size_t (*)(const char *, std::size_t) noexcept;
+
+constexpr std::size_t ModeCount = static_cast<std::size_t>(EscapeMode::Utf8) + 1;
+
+/*!
+ * @brief The kernels by the mode and by the UTF-8 validation.
+ */
+using KernelTable = std::array<std::array<Kernel, 2>, ModeCount>;
+
+template<EscapeMode Mode, bool Validate>
+constexpr bool needsEscape(unsigned char _c) noexcept {
+    if (_c >= 0x80) {
+        return Validate || Mode == EscapeMode::Utf8;
+    }
+
+    switch (Mode) {
+        case EscapeMode::Json:
+            return _c < 0x20 || _c == '"' || _c == '\\';
+        case EscapeMode::Logfmt:
+            return _c <= 0x20 || _c == '=' || _c == '"' || _c == '\\';
+        case EscapeMode::StripControl:
+            return _c < 0x20 || _c == 0x7F;
+        case EscapeMode::Utf8:
+            break;
+    }
+
+    return false;
+}
+
+template<EscapeMode Mode, bool Validate>
+std::size_t scanScalar(const char *_data, std::size_t _size) noexcept {
+    for (std::size_t i = 0; i < _size; ++i) {
+        if (needsEscape<Mode, Validate>(static_cast<unsigned char>(_data[i]))) {
+            return i;
+        }
+    }
+
+    return _size;
+}
+
+#if STDCORE_ESCAPE_X86
+template<EscapeMode Mode, bool Validate>
+__attribute__((target("sse2"))) std::size_t scanSse2(const char *_data, std::size_t _size) noexcept {
+    const auto control = _mm_set1_epi8(Mode == EscapeMode::Logfmt ? 0x20 : 0x1F);
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto equals = _mm_set1_epi8('=');
+    const auto del = _mm_set1_epi8(0x7F);
+
+    std::size_t i = 0;
+    for (; i + 16 <= _size; i += 16) {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_data + i));
+        auto found = _mm_setzero_si128();
+        if constexpr (Mode != EscapeMode::Utf8) {
+            // max(c, limit) == limit is the unsigned c <= limit.
+            found = _mm_cmpeq_epi8(_mm_max_epu8(chars, control), control);
+        }
+        if constexpr (Mode == EscapeMode::Json || Mode == EscapeMode::Logfmt) {
+            found = _mm_or_si128(found, _mm_or_si128(_mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, backslash)));
+        }
+        if constexpr (Mode == EscapeMode::Logfmt) {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chars, equals));
+        }
+        if constexpr (Mode == EscapeMode::StripControl) {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(chars, del));
+        }
+
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(found));
+        if constexpr (Validate || Mode == EscapeMode::Utf8) {
+            mask |= static_cast<unsigned>(_mm_movemask_epi8(chars));
+        }
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+
+    return i + scanScalar<Mode, Validate>(_data + i, _size - i);
+}
+
+template<EscapeMode Mode, bool Validate>
+__attribute__((target("avx2"))) std::size_t scanAvx2(const char *_data, std::size_t _size) noexcept {
+    const auto control = _mm256_set1_epi8(Mode == EscapeMode::Logfmt ? 0x20 : 0x1F);
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto equals = _mm256_set1_epi8('=');
+    const auto del = _mm256_set1_epi8(0x7F);
+
+    std::size_t i = 0;
+    for (; i + 32 <= _size; i += 32) {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(_data + i));
+        auto found = _mm256_setzero_si256();
+        if constexpr (Mode != EscapeMode::Utf8) {
+            found = _mm256_cmpeq_epi8(_mm256_max_epu8(chars, control), control);
+        }
+        if constexpr (Mode == EscapeMode::Json || Mode == EscapeMode::Logfmt) {
+            found = _mm256_or_si256(found, _mm256_or_si256(_mm256_cmpeq_epi8(chars, quote), _mm256_cmpeq_epi8(chars, backslash)));
+        }
+        if constexpr (Mode == EscapeMode::Logfmt) {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(chars, equals));
+        }
+        if constexpr (Mode == EscapeMode::StripControl) {
+            found = _mm256_or_si256(found, _mm256_cmpeq_epi8(chars, del));
+        }
+
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(found));
+        if constexpr (Validate || Mode == EscapeMode::Utf8) {
+            mask |= static_cast<unsigned>(_mm256_movemask_epi8(chars));
+        }
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+
+    // the tail shorter than 32 bytes is scanned by the SSE2 code, which must not see the dirty upper halves of the registers.
+    _mm256_zeroupper();
+    return i + scanSse2<Mode, Validate>(_data + i, _size - i);
+}
+#endif
+
+template<template<EscapeMode, bool> class Kernels_t>
+constexpr KernelTable makeTable() noexcept {
+    return {{{Kernels_t<EscapeMode::Json, false>::kernel, Kernels_t<EscapeMode::Json, true>::kernel},
+             {Kernels_t<EscapeMode::Logfmt, false>::kernel, Kernels_t<EscapeMode::Logfmt, true>::kernel},
+             {Kernels_t<EscapeMode::StripControl, false>::kernel, Kernels_t<EscapeMode::StripControl, true>::kernel},
+             {Kernels_t<EscapeMode::Utf8, false>::kernel, Kernels_t<EscapeMode::Utf8, true>::kernel}}};
+}
+
+template<EscapeMode Mode, bool Validate>
+struct ScalarKernels {
+    static constexpr Kernel kernel = &scanScalar<Mode, Validate>;
+};
+
+constexpr KernelTable ScalarTable = makeTable<ScalarKernels>();
+
+#if STDCORE_ESCAPE_X86
+template<EscapeMode Mode, bool Validate>
+struct Sse2Kernels {
+    static constexpr Kernel kernel = &scanSse2<Mode, Validate>;
+};
+
+template<EscapeMode Mode, bool Validate>
+struct Avx2Kernels {
+    static constexpr Kernel kernel = &scanAvx2<Mode, Validate>;
+};
+
+constexpr KernelTable Sse2Table = makeTable<Sse2Kernels>();
+constexpr KernelTable Avx2Table = makeTable<Avx2Kernels>();
+#endif
+
+const KernelTable &table(EscapeScanner::Isa _isa) noexcept {
+#if STDCORE_ESCAPE_X86
+    if (_isa == EscapeScanner::Isa::Avx2) {
+        return Avx2Table;
+    }
+    if (_isa == EscapeScanner::Isa::Sse2) {
+        return Sse2Table;
+    }
+#endif
+    (void)_isa;
+
+    return ScalarTable;
+}
+
+EscapeScanner::Isa selectIsa() noexcept {
+    if (EscapeScanner::isSupported(EscapeScanner::Isa::Avx2)) {
+        return EscapeScanner::Isa::Avx2;
+    }
+    if (EscapeScanner::isSupported(EscapeScanner::Isa::Sse2)) {
+        return EscapeScanner::Isa::Sse2;
+    }
+
+    return EscapeScanner::Isa::Scalar;
+}
+
+/*!
+ * @brief The selected instruction set. The scalar table is constant-initialized, so a string escaped
+ * by a static constructor of another library before the selection is scanned too.
+ */
+EscapeScanner::Isa g_isa = EscapeScanner::Isa::Scalar;
+const KernelTable *g_table = &ScalarTable;
+
+/*!
+ * @brief Selects the instruction set when the library is loaded.
+ */
+const bool g_selected = [] {
+    g_isa = selectIsa();
+    g_table = &table(g_isa);
+    return true;
+}();
+}  // namespace
+
+std::size_t EscapeScanner::find(std::string_view _str, EscapeMode _mode, bool _validateUtf8) noexcept {
+    return (*g_table)[static_cast<std::size_t>(_mode)][_validateUtf8 ? 1 : 0](_str.data(), _str.size());
+}
+
+std::size_t EscapeScanner::find(Isa _isa, std::string_view _str, EscapeMode _mode, bool _validateUtf8) noexcept {
+    return table(_isa)[static_cast<std::size_t>(_mode)][_validateUtf8 ? 1 : 0](_str.data(), _str.size());
+}
+
+EscapeScanner::Isa EscapeScanner::isa() noexcept {
+    return g_isa;
+}
+
+bool EscapeScanner::isSupported(Isa _isa) noexcept {
+    switch (_isa) {
+        case Isa::Scalar:
+            return true;
+#if STDCORE_ESCAPE_X86
+        case Isa::Sse2:
+            return __builtin_cpu_supports("sse2");
+        case Isa::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+std::size_t EscapeScanner::utf8SequenceSize(std::string_view _str) noexcept {
+    if (_str.empty()) {
+        return 0;
+    }
+
+    const auto lead = static_cast<unsigned char>(_str[0]);
+    if (lead < 0x80) {
+        return 1;
+    }
+
+    std::size_t size = 0;
+    // the allowed range of the second byte excludes the overlong forms, the surrogates and the code points above U+10FFFF.
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    } else {
+        return 0;
+    }
+
+    if (_str.size() < size) {
+        return 0;
+    }
+
+    const auto second = static_cast<unsigned char>(_str[1]);
+    if (second < low || second > high) {
+        return 0;
+    }
+
+    for (std::size_t i = 2; i < size; ++i) {
+        if ((static_cast<unsigned char>(_str[i]) & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+
+    return size;
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "CharFastStackBuffer.h"
+
+#include <cstddef>
+#include <string_view>
+
+/*!
+ * @brief The escaping of a string appended to CharFastStackBuffer.
+ */
+enum class EscapeMode {
+    //! The JSON string escapes: \" \\ \n \r \t \b \f and \u00XX for the other control chars, without the quotes.
+    Json,
+    //! The logfmt value: as is, or quoted with the JSON escapes if it is empty or contains a space, '=', '"', '\' or a control char.
+    Logfmt,
+    //! The newline, the carriage return and the tab are replaced with a space, the other control chars and DEL are removed.
+    StripControl,
+    //! The string is written as is, only the invalid UTF-8 is replaced.
+    Utf8
+};
+
+/*!
+ * @brief EscapeScanner finds the chars which need escaping. The string is scanned by 32 bytes with AVX2 or by 16 bytes
+ * with SSE2, the instruction set is selected when the library is loaded; the scalar loop is the fallback.
+ */
+class EscapeScanner {
+public:
+    /*!
+     * @brief The instruction set of the scanner.
+     */
+    enum class Isa {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    /*!
+     * @brief Returns the position of the first char which needs escaping or the string size.
+     * @param _str - the string.
+     * @param _mode - the escaping.
+     * @param _validateUtf8 - the bytes >= 0x80 need escaping too, so the caller validates the UTF-8 sequences.
+     * The Utf8 mode always validates.
+     */
+    static std::size_t find(std::string_view _str, EscapeMode _mode, bool _validateUtf8) noexcept;
+
+    /*!
+     * @brief Returns the position by the instruction set, it must be supported.
+     */
+    static std::size_t find(Isa _isa, std::string_view _str, EscapeMode _mode, bool _validateUtf8) noexcept;
+
+    /*!
+     * @brief Returns the instruction set used by find().
+     */
+    [[nodiscard]]
+    static Isa isa() noexcept;
+
+    /*!
+     * @brief Returns true if the CPU supports the instruction set.
+     */
+    [[nodiscard]]
+    static bool isSupported(Isa _isa) noexcept;
+
+    /*!
+     * @brief Returns the size of the valid UTF-8 sequence at the start of the string or 0 if it is invalid:
+     * truncated, overlong, a surrogate or above U+10FFFF.
+     */
+    static std::size_t utf8SequenceSize(std::string_view _str) noexcept;
+};
+
+/*!
+ * @brief EscapeFormat writes the string with the escaping.
+ */
+struct EscapeFormat {
+    std::string_view str;
+    EscapeMode mode;
+    //! The invalid UTF-8 bytes are replaced with U+FFFD.
+    bool validateUtf8;
+};
+
+/*!
+ * @brief Returns the escaped string, e.g. buffer << escapeFormat(userName, EscapeMode::Json, true);
+ */
+inline EscapeFormat escapeFormat(std::string_view _str, EscapeMode _mode, bool _validateUtf8 = false) noexcept {
+    return {_str, _mode, _validateUtf8};
+}
+
+namespace escape_detail {
+/*!
+ * @brief Appends the string, every char found by the scanner is passed to the handler. The clean runs are appended as a whole.
+ */
+template<std::size_t N, class P, class Handler_t>
+void appendRuns(CharFastStackBuffer<char, N, P> &_buffer, std::string_view _str, EscapeMode _mode, bool _validateUtf8, Handler_t &&_handler) {
+    std::size_t position = 0;
+    while (position < _str.size()) {
+        const auto rest = _str.substr(position);
+        const auto found = EscapeScanner::find(rest, _mode, _validateUtf8);
+        _buffer.append(rest.data(), found);
+        if (found == rest.size()) {
+            return;
+        }
+
+        const auto c = static_cast<unsigned char>(rest[found]);
+        if (c < 0x80) {
+            _handler(c);
+            position += found + 1;
+            continue;
+        }
+
+        // the bytes >= 0x80 are found only if the UTF-8 is validated.
+        if (const auto size = EscapeScanner::utf8SequenceSize(rest.substr(found)); size != 0) {
+            _buffer.append(rest.data() + found, size);
+            position += found + size;
+        } else {
+            _buffer << std::string_view("\xEF\xBF\xBD");
+            position += found + 1;
+        }
+    }
+}
+
+/*!
+ * @brief Writes the JSON escape of the char found by the scanner: '"', '\\' or a control char.
+ * @return The size of the escape, 2 or 6.
+ */
+inline std::size_t jsonEscape(unsigned char _c, char (&_escape)[6]) noexcept {
+    _escape[0] = '\\';
+    _escape[1] = static_cast<char>(_c);
+    switch (_c) {
+        case '"':
+        case '\\':
+            return 2;
+        case '\n':
+            _escape[1] = 'n';
+            return 2;
+        case '\r':
+            _escape[1] = 'r';
+            return 2;
+        case '\t':
+            _escape[1] = 't';
+            return 2;
+        case '\b':
+            _escape[1] = 'b';
+            return 2;
+        case '\f':
+            _escape[1] = 'f';
+            return 2;
+        default:
+            constexpr char hexDigits[] = "0123456789abcdef";
+            _escape[1] = 'u';
+            _escape[2] = '0';
+            _escape[3] = '0';
+            _escape[4] = hexDigits[_c >> 4];
+            _escape[5] = hexDigits[_c & 0xF];
+            return 6;
+    }
+}
+
+template<std::size_t N, class P>
+void appendJson(CharFastStackBuffer<char, N, P> &_buffer, std::string_view _str, bool _validateUtf8) {
+    appendRuns(_buffer, _str, EscapeMode::Json, _validateUtf8, [&_buffer](unsigned char _c) {
+        char escape[6];
+        _buffer.append(escape, jsonEscape(_c, escape));
+    });
+}
+}  // namespace escape_detail
+
+template<std::size_t N, class P>
+CharFastStackBuffer<char, N, P> &operator<<(CharFastStackBuffer<char, N, P> &_buffer, const EscapeFormat &_format) {
+    switch (_format.mode) {
+        case EscapeMode::Json:
+            escape_detail::appendJson(_buffer, _format.str, _format.validateUtf8);
+            break;
+        case EscapeMode::Logfmt:
+            if (_format.str.empty() || EscapeScanner::find(_format.str, EscapeMode::Logfmt, false) != _format.str.size()) {
+                _buffer << '"';
+                escape_detail::appendJson(_buffer, _format.str, _format.validateUtf8);
+                _buffer << '"';
+            } else if (_format.validateUtf8) {
+                escape_detail::appendRuns(_buffer, _format.str, EscapeMode::Utf8, true, [](unsigned char) {});
+            } else {
+                _buffer << _format.str;
+            }
+            break;
+        case EscapeMode::StripControl:
+            escape_detail::appendRuns(_buffer, _format.str, EscapeMode::StripControl, _format.validateUtf8, [&_buffer](unsigned char _c) {
+                if (_c == '\n' || _c == '\r' || _c == '\t') {
+                    _buffer.push(' ');
+                }
+            });
+            break;
+        case EscapeMode::Utf8:
+            escape_detail::appendRuns(_buffer, _format.str, EscapeMode::Utf8, true, [](unsigned char) {});
+            break;
+    }
+
+    return _buffer;
+}
+
+template<>
+inline constexpr bool IsBufferFormattable_v<EscapeFormat, char> = true;
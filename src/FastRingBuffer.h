@@ -0,0 +1,512 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+/*!
+ * @brief The assumed size of the cache line. The positions written by different threads are placed
+ * on separate cache lines, so the threads do not invalidate each other's cache.
+ */
+inline constexpr std::size_t FastRingBufferCacheLine = 64;
+
+/*!
+ * @brief FastSpscRingBuffer is a wait-free bounded FIFO queue for one producer thread and one consumer thread.
+ * The items live in the aligned raw storage inside the object, so there is no heap allocation.
+ * Every side keeps a cached copy of the other side's position and reloads it only when the queue looks full or empty.
+ * @tparam T - element type.
+ * @tparam N - the queue capacity, a power of two.
+ */
+template<class T, std::size_t N = 1024>
+class FastSpscRingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "The capacity must be a power of two");
+
+public:
+    /*!
+     * @brief Construct an empty FastSpscRingBuffer object. The storage is not initialized.
+     */
+    FastSpscRingBuffer() noexcept {}
+
+    /*!
+     * @brief Destroy the FastSpscRingBuffer object, the queued items are destroyed.
+     */
+    ~FastSpscRingBuffer();
+
+    FastSpscRingBuffer(const FastSpscRingBuffer &) = delete;
+    FastSpscRingBuffer &operator=(const FastSpscRingBuffer &) = delete;
+
+    /*!
+     * @brief Constructs an item at the end of the queue. Producer only.
+     * @return false if the queue is full.
+     */
+    template<class... Args_t>
+    [[nodiscard]]
+    bool tryEmplace(Args_t &&..._args) noexcept(std::is_nothrow_constructible_v<T, Args_t...>);
+
+    /*!
+     * @brief Push a value to the end of the queue. Producer only.
+     * @return false if the queue is full.
+     */
+    [[nodiscard]]
+    bool tryPush(const T &_value) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /*!
+     * @brief Push a value to the end of the queue. Producer only.
+     * @return false if the queue is full.
+     */
+    [[nodiscard]]
+    bool tryPush(T &&_value) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Pushes as many values as fit with one position update. Producer only.
+     * @param _values - the values.
+     * @param _count - number of the values.
+     * @return Number of pushed values.
+     */
+    std::size_t pushBatch(const T *_values, std::size_t _count) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /*!
+     * @brief Removes the first item of the queue. Consumer only.
+     * @return The item or std::nullopt if the queue is empty.
+     */
+    [[nodiscard]]
+    std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Moves up to _count first items to the output with one position update. Consumer only.
+     * @param _out - output, at least _count values.
+     * @param _count - maximum number of the items.
+     * @return Number of popped items.
+     */
+    std::size_t popBatch(T *_out, std::size_t _count) noexcept(std::is_nothrow_move_assignable_v<T>);
+
+    /*!
+     * @brief Returns the number of queued items. The value is exact only if neither side is running.
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept;
+
+    /*!
+     * @brief Returns true if the queue contains no items. The value is exact only if neither side is running.
+     */
+    [[nodiscard]]
+    bool isEmpty() const noexcept;
+
+    /*!
+     * @brief Returns the capacity of the queue.
+     */
+    [[nodiscard]]
+    static constexpr std::size_t capacity() noexcept { return N; }
+
+private:
+    /*!
+     * @brief Returns the item storage of the position.
+     */
+    T *item(std::size_t _position) noexcept {
+        return std::launder(reinterpret_cast<T *>(m_storage + (_position & (N - 1)) * sizeof(T)));
+    }
+
+    /*!
+     * @brief Returns the number of free slots, reloading the consumer position if the cached one is not enough.
+     */
+    std::size_t freeSlots(std::size_t _tail, std::size_t _count) noexcept;
+
+    /*!
+     * @brief Returns the number of queued items, reloading the producer position if the cached one is not enough.
+     */
+    std::size_t queuedItems(std::size_t _head, std::size_t _count) noexcept;
+
+    /*!
+     * @brief The consumer position.
+     */
+    alignas(FastRingBufferCacheLine) std::atomic<std::size_t> m_head{0};
+    /*!
+     * @brief The producer position known to the consumer.
+     */
+    std::size_t m_cachedTail = 0;
+    /*!
+     * @brief The producer position.
+     */
+    alignas(FastRingBufferCacheLine) std::atomic<std::size_t> m_tail{0};
+    /*!
+     * @brief The consumer position known to the producer.
+     */
+    std::size_t m_cachedHead = 0;
+    /*!
+     * @brief The raw storage of the items.
+     */
+    alignas(FastRingBufferCacheLine) alignas(T) unsigned char m_storage[N * sizeof(T)];
+};
+
+/*!
+ * @brief FastMpmcRingBuffer is a lock-free bounded FIFO queue for any number of producer and consumer threads.
+ * Every slot has a sequence number which tells whether the slot is free for the producer of the position
+ * or holds the item for the consumer of the position (D. Vyukov's bounded MPMC queue).
+ * The items live inside the object, so there is no heap allocation.
+ * @tparam T - element type.
+ * @tparam N - the queue capacity, a power of two.
+ */
+template<class T, std::size_t N = 1024>
+class FastMpmcRingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "The capacity must be a power of two");
+
+public:
+    /*!
+     * @brief Construct an empty FastMpmcRingBuffer object. Only the slot sequences are initialized.
+     */
+    FastMpmcRingBuffer() noexcept;
+
+    /*!
+     * @brief Destroy the FastMpmcRingBuffer object, the queued items are destroyed.
+     */
+    ~FastMpmcRingBuffer();
+
+    FastMpmcRingBuffer(const FastMpmcRingBuffer &) = delete;
+    FastMpmcRingBuffer &operator=(const FastMpmcRingBuffer &) = delete;
+
+    /*!
+     * @brief Constructs an item at the end of the queue.
+     * @return false if the queue is full.
+     */
+    template<class... Args_t>
+    [[nodiscard]]
+    bool tryEmplace(Args_t &&..._args) noexcept(std::is_nothrow_constructible_v<T, Args_t...>);
+
+    /*!
+     * @brief Push a value to the end of the queue.
+     * @return false if the queue is full.
+     */
+    [[nodiscard]]
+    bool tryPush(const T &_value) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /*!
+     * @brief Push a value to the end of the queue.
+     * @return false if the queue is full.
+     */
+    [[nodiscard]]
+    bool tryPush(T &&_value) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Claims as many consecutive free slots as possible, up to _count, with one CAS and copies the values into them.
+     * @param _values - the values.
+     * @param _count - number of the values.
+     * @return Number of pushed values.
+     */
+    std::size_t pushBatch(const T *_values, std::size_t _count) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /*!
+     * @brief Removes the first item of the queue.
+     * @return The item or std::nullopt if the queue is empty.
+     */
+    [[nodiscard]]
+    std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Claims up to _count consecutive items with one CAS and moves them to the output.
+     * @param _out - output, at least _count values.
+     * @param _count - maximum number of the items.
+     * @return Number of popped items.
+     */
+    std::size_t popBatch(T *_out, std::size_t _count) noexcept(std::is_nothrow_move_assignable_v<T>);
+
+    /*!
+     * @brief Returns the approximate number of queued items.
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept;
+
+    /*!
+     * @brief Returns true if the queue looks empty.
+     */
+    [[nodiscard]]
+    bool isEmpty() const noexcept;
+
+    /*!
+     * @brief Returns the capacity of the queue.
+     */
+    [[nodiscard]]
+    static constexpr std::size_t capacity() noexcept { return N; }
+
+private:
+    /*!
+     * @brief The queue slot.
+     */
+    struct Slot {
+        //! Equals the position if the slot is free for its producer, the position + 1 if it holds the item.
+        std::atomic<std::size_t> sequence;
+        //! The raw storage of the item.
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *item() noexcept { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    /*!
+     * @brief Claims up to _count slots starting at the position.
+     * @param _position - enqueue or dequeue position.
+     * @param _offset - the sequence of the claimable slot minus its position: 0 for producers, 1 for consumers.
+     * @param _count - maximum number of the slots.
+     * @return The first claimed position and the number of the claimed slots, 0 if there are none.
+     */
+    std::pair<std::size_t, std::size_t> claim(std::atomic<std::size_t> &_position, std::size_t _offset, std::size_t _count) noexcept;
+
+    /*!
+     * @brief The queue slots.
+     */
+    Slot m_slots[N];
+    /*!
+     * @brief Enqueue position.
+     */
+    alignas(FastRingBufferCacheLine) std::atomic<std::size_t> m_enqueuePos{0};
+    /*!
+     * @brief Dequeue position.
+     */
+    alignas(FastRingBufferCacheLine) std::atomic<std::size_t> m_dequeuePos{0};
+};
+
+template<class T, std::size_t N>
+FastSpscRingBuffer<T, N>::~FastSpscRingBuffer() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        for (auto head = m_head.load(std::memory_order_relaxed); head != tail; ++head) {
+            item(head)->~T();
+        }
+    }
+}
+
+template<class T, std::size_t N>
+std::size_t FastSpscRingBuffer<T, N>::freeSlots(std::size_t _tail, std::size_t _count) noexcept {
+    auto freeSize = N - (_tail - m_cachedHead);
+    if (freeSize < _count) {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        freeSize = N - (_tail - m_cachedHead);
+    }
+
+    return std::min(freeSize, _count);
+}
+
+template<class T, std::size_t N>
+std::size_t FastSpscRingBuffer<T, N>::queuedItems(std::size_t _head, std::size_t _count) noexcept {
+    auto queued = m_cachedTail - _head;
+    if (queued < _count) {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        queued = m_cachedTail - _head;
+    }
+
+    return std::min(queued, _count);
+}
+
+template<class T, std::size_t N>
+template<class... Args_t>
+bool FastSpscRingBuffer<T, N>::tryEmplace(Args_t &&..._args) noexcept(std::is_nothrow_constructible_v<T, Args_t...>) {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    if (freeSlots(tail, 1) == 0) {
+        return false;
+    }
+
+    ::new (static_cast<void *>(item(tail))) T(std::forward<Args_t>(_args)...);
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+template<class T, std::size_t N>
+bool FastSpscRingBuffer<T, N>::tryPush(const T &_value) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    return tryEmplace(_value);
+}
+
+template<class T, std::size_t N>
+bool FastSpscRingBuffer<T, N>::tryPush(T &&_value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    return tryEmplace(std::move(_value));
+}
+
+template<class T, std::size_t N>
+std::size_t FastSpscRingBuffer<T, N>::pushBatch(const T *_values, std::size_t _count) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    const auto count = freeSlots(tail, _count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        ::new (static_cast<void *>(item(tail + i))) T(_values[i]);
+    }
+
+    m_tail.store(tail + count, std::memory_order_release);
+
+    return count;
+}
+
+template<class T, std::size_t N>
+std::optional<T> FastSpscRingBuffer<T, N>::tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    if (queuedItems(head, 1) == 0) {
+        return std::nullopt;
+    }
+
+    std::optional<T> value(std::move(*item(head)));
+    item(head)->~T();
+    m_head.store(head + 1, std::memory_order_release);
+
+    return value;
+}
+
+template<class T, std::size_t N>
+std::size_t FastSpscRingBuffer<T, N>::popBatch(T *_out, std::size_t _count) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    const auto count = queuedItems(head, _count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        _out[i] = std::move(*item(head + i));
+        item(head + i)->~T();
+    }
+
+    m_head.store(head + count, std::memory_order_release);
+
+    return count;
+}
+
+template<class T, std::size_t N>
+std::size_t FastSpscRingBuffer<T, N>::size() const noexcept {
+    return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+}
+
+template<class T, std::size_t N>
+bool FastSpscRingBuffer<T, N>::isEmpty() const noexcept {
+    return size() == 0;
+}
+
+template<class T, std::size_t N>
+FastMpmcRingBuffer<T, N>::FastMpmcRingBuffer() noexcept {
+    for (std::size_t i = 0; i < N; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template<class T, std::size_t N>
+FastMpmcRingBuffer<T, N>::~FastMpmcRingBuffer() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        const auto tail = m_enqueuePos.load(std::memory_order_relaxed);
+        for (auto head = m_dequeuePos.load(std::memory_order_relaxed); head != tail; ++head) {
+            m_slots[head & (N - 1)].item()->~T();
+        }
+    }
+}
+
+template<class T, std::size_t N>
+std::pair<std::size_t, std::size_t> FastMpmcRingBuffer<T, N>::claim(std::atomic<std::size_t> &_position, std::size_t _offset, std::size_t _count) noexcept {
+    auto position = _position.load(std::memory_order_relaxed);
+
+    while (true) {
+        const auto sequence = m_slots[position & (N - 1)].sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + _offset);
+
+        if (diff < 0) {
+            return {position, 0};
+        }
+
+        if (diff > 0) {
+            // another thread has claimed the position.
+            position = _position.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        // the slots after the first one are claimable in order, the run stops at the first one which is not.
+        std::size_t count = 1;
+        while (count < _count &&
+               m_slots[(position + count) & (N - 1)].sequence.load(std::memory_order_acquire) == position + count + _offset) {
+            ++count;
+        }
+
+        if (_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            return {position, count};
+        }
+    }
+}
+
+template<class T, std::size_t N>
+template<class... Args_t>
+bool FastMpmcRingBuffer<T, N>::tryEmplace(Args_t &&..._args) noexcept(std::is_nothrow_constructible_v<T, Args_t...>) {
+    const auto [position, count] = claim(m_enqueuePos, 0, 1);
+    if (count == 0) {
+        return false;
+    }
+
+    auto &slot = m_slots[position & (N - 1)];
+    ::new (static_cast<void *>(slot.storage)) T(std::forward<Args_t>(_args)...);
+    slot.sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+template<class T, std::size_t N>
+bool FastMpmcRingBuffer<T, N>::tryPush(const T &_value) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    return tryEmplace(_value);
+}
+
+template<class T, std::size_t N>
+bool FastMpmcRingBuffer<T, N>::tryPush(T &&_value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    return tryEmplace(std::move(_value));
+}
+
+template<class T, std::size_t N>
+std::size_t FastMpmcRingBuffer<T, N>::pushBatch(const T *_values, std::size_t _count) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    if (_count == 0) {
+        return 0;
+    }
+
+    const auto [position, count] = claim(m_enqueuePos, 0, _count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto &slot = m_slots[(position + i) & (N - 1)];
+        ::new (static_cast<void *>(slot.storage)) T(_values[i]);
+        slot.sequence.store(position + i + 1, std::memory_order_release);
+    }
+
+    return count;
+}
+
+template<class T, std::size_t N>
+std::optional<T> FastMpmcRingBuffer<T, N>::tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+    const auto [position, count] = claim(m_dequeuePos, 1, 1);
+    if (count == 0) {
+        return std::nullopt;
+    }
+
+    auto &slot = m_slots[position & (N - 1)];
+    std::optional<T> value(std::move(*slot.item()));
+    slot.item()->~T();
+    slot.sequence.store(position + N, std::memory_order_release);
+
+    return value;
+}
+
+template<class T, std::size_t N>
+std::size_t FastMpmcRingBuffer<T, N>::popBatch(T *_out, std::size_t _count) noexcept(std::is_nothrow_move_assignable_v<T>) {
+    if (_count == 0) {
+        return 0;
+    }
+
+    const auto [position, count] = claim(m_dequeuePos, 1, _count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto &slot = m_slots[(position + i) & (N - 1)];
+        _out[i] = std::move(*slot.item());
+        slot.item()->~T();
+        slot.sequence.store(position + i + N, std::memory_order_release);
+    }
+
+    return count;
+}
+
+template<class T, std::size_t N>
+std::size_t FastMpmcRingBuffer<T, N>::size() const noexcept {
+    const auto head = m_dequeuePos.load(std::memory_order_relaxed);
+    const auto tail = m_enqueuePos.load(std::memory_order_relaxed);
+
+    return tail > head ? std::min(tail - head, N) : 0;
+}
+
+template<class T, std::size_t N>
+bool FastMpmcRingBuffer<T, N>::isEmpty() const noexcept {
+    return size() == 0;
+}
@@ -0,0 +1,774 @@
+#pragma once
+
+#include "FastStackBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/*!
+ * @brief GrowOnOverflow makes CharFastStackBuffer spill to the heap when the values do not fit into the stack,
+ * the buffer is a FastSmallVector then.
+ */
+struct GrowOnOverflow {
+    //! The values which do not fit are dropped instead of calling overflow().
+    static constexpr bool Truncates = false;
+};
+
+/*!
+ * @brief IsGrowingPolicy_v is true if the buffer grows instead of applying the overflow policy.
+ * @tparam OverflowPolicy_t - the overflow policy.
+ */
+template<class OverflowPolicy_t>
+inline constexpr bool IsGrowingPolicy_v = std::is_same_v<OverflowPolicy_t, GrowOnOverflow>;
+
+/*!
+ * @brief The FastSmallVector class is a vector which keeps the first N items in the inline storage and
+ * moves them to the heap when they do not fit. Once the items are on the heap, clear() keeps the block,
+ * so a reused vector allocates only when it grows beyond its largest size.
+ * The interface is a superset of the FastStackBuffer one, so it can be the storage of CharFastStackBuffer.
+ * @tparam T - element type.
+ * @tparam N - the inline capacity.
+ */
+template<class T, std::size_t N = 16>
+class FastSmallVector {
+    static_assert(N > 0, "The inline capacity must not be 0");
+
+public:
+    /*!
+     * @brief The overflow policy of the storage of CharFastStackBuffer.
+     */
+    using OverflowPolicy = GrowOnOverflow;
+    /*!
+     * @brief The size type.
+     */
+    using Distance_t = std::ptrdiff_t;
+
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    /*!
+     * @brief The inline capacity.
+     */
+    static constexpr std::size_t InlineCapacity = N;
+
+    /*!
+     * @brief Construct an empty FastSmallVector object. The storage is not initialized.
+     */
+    FastSmallVector() noexcept {}
+
+    /*!
+     * @brief Construct the vector with the copies of the values.
+     */
+    FastSmallVector(std::initializer_list<T> _values);
+
+    /*!
+     * @brief Copy constructor. The copy is inline if the items fit into the inline storage.
+     */
+    FastSmallVector(const FastSmallVector &_other);
+
+    /*!
+     * @brief Move constructor. The heap block of the source is stolen, the inline items are moved,
+     * trivially relocatable ones by memcpy. The source becomes empty and inline.
+     */
+    FastSmallVector(FastSmallVector &&_other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Copy operator.
+     */
+    FastSmallVector &operator=(const FastSmallVector &_other);
+
+    /*!
+     * @brief Move operator. The heap block of the source is stolen, the inline items are moved into the current storage.
+     * The source becomes empty and inline.
+     */
+    FastSmallVector &operator=(FastSmallVector &&_other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Destroy the FastSmallVector object, the items are destroyed and the heap block is freed.
+     */
+    ~FastSmallVector();
+
+    /*!
+     * @brief Appends the value, the vector grows if it is full.
+     */
+    void push(const T &_val);
+
+    /*!
+     * @brief Appends the value, the vector grows if it is full.
+     */
+    void push(T &&_val);
+
+    /*!
+     * @brief Constructs a value at the end. The arguments may refer to the items of the vector.
+     * @return The pointer to the constructed value.
+     */
+    template<class... Args_t>
+    T *emplace(Args_t &&..._args);
+
+    /*!
+     * @brief Appends the values with one capacity check. Trivially copyable values are copied by memcpy.
+     * @param _values - the values, they may be the items of the vector.
+     * @param _count - number of the values.
+     */
+    void append(const T *_values, std::size_t _count);
+
+    /*!
+     * @brief Appends the values of the range with one capacity check if the range is sized.
+     * @param _range - the range, contiguous ranges are copied by memcpy.
+     */
+    template<class Range_t>
+    void append(const Range_t &_range);
+
+    /*!
+     * @brief Inserts the value before the position.
+     * @return The pointer to the inserted value.
+     */
+    T *insert(const T *_position, const T &_val);
+
+    /*!
+     * @brief Inserts the value before the position.
+     * @return The pointer to the inserted value.
+     */
+    T *insert(const T *_position, T &&_val);
+
+    /*!
+     * @brief Inserts the values before the position with one capacity check.
+     * @param _values - the values, they may be the items of the vector.
+     * @return The pointer to the first inserted value.
+     */
+    T *insert(const T *_position, const T *_values, std::size_t _count);
+
+    /*!
+     * @brief Constructs a value before the position.
+     * @return The pointer to the constructed value.
+     */
+    template<class... Args_t>
+    T *emplaceAt(const T *_position, Args_t &&..._args);
+
+    /*!
+     * @brief Removes the item at the position.
+     * @return The pointer to the item which followed the removed one.
+     */
+    T *erase(const T *_position);
+
+    /*!
+     * @brief Removes the items in [_first, _last).
+     * @return The pointer to the item which followed the removed ones.
+     */
+    T *erase(const T *_first, const T *_last);
+
+    /*!
+     * @brief Changes the size, the new items are value-initialized.
+     */
+    void resize(std::size_t _size);
+
+    /*!
+     * @brief Changes the size, the new items are copies of the value.
+     */
+    void resize(std::size_t _size, const T &_val);
+
+    /*!
+     * @brief Changes the size. The values between the old and the new size are not assigned,
+     * the caller writes them through data(). Only for the trivial types.
+     */
+    void resizeUninitialized(std::size_t _size);
+
+    /*!
+     * @brief Makes the capacity at least the given one.
+     */
+    void reserve(std::size_t _capacity);
+
+    /*!
+     * @brief Moves the items back into the inline storage if they fit and frees the heap block.
+     */
+    void shrinkToFit() noexcept(IsTriviallyRelocatable_v<T> || std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Destroys all items, the heap block is kept. The truncated() counter is reset too.
+     */
+    void clear() noexcept;
+
+    /*!
+     * @brief Returns the number of values dropped by the caller, the vector itself never drops values.
+     */
+    [[nodiscard]]
+    std::size_t truncated() const noexcept { return m_truncated; }
+
+    /*!
+     * @brief Adds the number of values dropped by the caller to truncated().
+     */
+    void addTruncated(std::size_t _count) noexcept { m_truncated += _count; }
+
+    /*!
+     * @brief Returns the pointer to the first item.
+     */
+    [[nodiscard]]
+    T *data() noexcept { return m_items; }
+
+    /*!
+     * @brief Returns the pointer to the first item.
+     */
+    [[nodiscard]]
+    const T *data() const noexcept { return m_items; }
+
+    [[nodiscard]]
+    T &operator[](std::size_t _index) noexcept { return m_items[_index]; }
+
+    [[nodiscard]]
+    const T &operator[](std::size_t _index) const noexcept { return m_items[_index]; }
+
+    /*!
+     * @brief Returns the item at the index.
+     * @throw UserException - if the index is out of range.
+     */
+    [[nodiscard]]
+    T &at(std::size_t _index);
+
+    /*!
+     * @brief Returns the item at the index.
+     * @throw UserException - if the index is out of range.
+     */
+    [[nodiscard]]
+    const T &at(std::size_t _index) const;
+
+    [[nodiscard]]
+    T *begin() noexcept { return m_items; }
+
+    [[nodiscard]]
+    const T *begin() const noexcept { return m_items; }
+
+    [[nodiscard]]
+    T *end() noexcept { return m_items + m_size; }
+
+    [[nodiscard]]
+    const T *end() const noexcept { return m_items + m_size; }
+
+    /*!
+     * @brief Removes the last item and returns it.
+     * @throw UserException - if the vector is empty.
+     */
+    [[nodiscard]]
+    T pop();
+
+    /*!
+     * @brief Returns the last item.
+     * @throw UserException - if the vector is empty.
+     */
+    [[nodiscard]]
+    T &top() const;
+
+    /*!
+     * @brief Returns true if the vector contains no items; otherwise returns false.
+     */
+    [[nodiscard]]
+    constexpr bool isEmpty() const noexcept { return m_size == 0; }
+
+    /*!
+     * @brief Returns the size of the vector.
+     */
+    [[nodiscard]]
+    constexpr Distance_t size() const noexcept { return static_cast<Distance_t>(m_size); }
+
+    /*!
+     * @brief Returns the number of the items which fit without an allocation.
+     */
+    [[nodiscard]]
+    constexpr std::size_t capacity() const noexcept { return m_capacity; }
+
+    /*!
+     * @brief Returns true if the next item needs an allocation; otherwise returns false.
+     */
+    [[nodiscard]]
+    constexpr bool isFull() const noexcept { return m_size == m_capacity; }
+
+    /*!
+     * @brief Returns true if the items are in the inline storage; otherwise returns false.
+     */
+    [[nodiscard]]
+    bool isInline() const noexcept { return m_items == inlineItems(); }
+
+protected:
+    /*!
+     * @brief Returns the pointer to the inline storage.
+     */
+    T *inlineItems() const noexcept {
+        return std::launder(reinterpret_cast<T *>(const_cast<unsigned char *>(m_storage)));
+    }
+
+    /*!
+     * @brief Returns the capacity of the next heap block which holds at least the given number of items.
+     */
+    std::size_t grownCapacity(std::size_t _size) const noexcept {
+        return std::max(_size, m_capacity * 2);
+    }
+
+    /*!
+     * @brief Moves the items to the uninitialized memory and ends their lifetime, trivially relocatable ones by memcpy.
+     * If T may throw on the move, the items are copied, so the source is intact if a copy throws.
+     */
+    static void relocate(T *_from, std::size_t _count, T *_to);
+
+    /*!
+     * @brief Copies the values to the uninitialized memory, trivially copyable ones by memcpy.
+     */
+    static void copyValues(const T *_values, std::size_t _count, T *_to);
+
+    /*!
+     * @brief Returns true if the values overlap the items of the vector.
+     */
+    bool overlapsItems(const T *_values, std::size_t _count) const noexcept {
+        return std::less<const T *>()(_values, m_items + m_size) && std::less<const T *>()(m_items, _values + _count);
+    }
+
+    /*!
+     * @brief Moves the items into the heap block of the capacity.
+     */
+    void reallocate(std::size_t _capacity);
+
+    /*!
+     * @brief Frees the heap block and points the vector to the inline storage. The items must be destroyed or relocated.
+     */
+    void releaseBlock() noexcept;
+
+    /*!
+     * @brief Destroys the items above the size.
+     */
+    void destroyFrom(std::size_t _size) noexcept;
+
+    /*!
+     * @brief Moves the items of the other vector into the empty vector and empties the other vector.
+     */
+    void moveFrom(FastSmallVector &_other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief The items, in the inline storage or in the heap block.
+     */
+    T *m_items = reinterpret_cast<T *>(m_storage);
+    /*!
+     * @brief The number of items.
+     */
+    std::size_t m_size = 0;
+    /*!
+     * @brief The number of items which fit into the current storage.
+     */
+    std::size_t m_capacity = N;
+    /*!
+     * @brief The number of values dropped by the caller.
+     */
+    std::size_t m_truncated = 0;
+    /*!
+     * @brief The inline storage of the items.
+     */
+    alignas(T) unsigned char m_storage[N * sizeof(T)];
+};
+
+template<class T, std::size_t N>
+FastSmallVector<T, N>::FastSmallVector(std::initializer_list<T> _values) {
+    append(_values.begin(), _values.size());
+}
+
+template<class T, std::size_t N>
+FastSmallVector<T, N>::FastSmallVector(const FastSmallVector &_other) : m_truncated(_other.m_truncated) {
+    append(_other.data(), _other.m_size);
+}
+
+template<class T, std::size_t N>
+FastSmallVector<T, N>::FastSmallVector(FastSmallVector &&_other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : m_truncated(_other.m_truncated) {
+    moveFrom(_other);
+}
+
+template<class T, std::size_t N>
+FastSmallVector<T, N> &FastSmallVector<T, N>::operator=(const FastSmallVector &_other) {
+    if (this != &_other) {
+        clear();
+        append(_other.data(), _other.m_size);
+        m_truncated = _other.m_truncated;
+    }
+
+    return *this;
+}
+
+template<class T, std::size_t N>
+FastSmallVector<T, N> &FastSmallVector<T, N>::operator=(FastSmallVector &&_other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this != &_other) {
+        clear();
+        if (!_other.isInline()) {
+            releaseBlock();
+        }
+        m_truncated = _other.m_truncated;
+        moveFrom(_other);
+    }
+
+    return *this;
+}
+
+template<class T, std::size_t N>
+FastSmallVector<T, N>::~FastSmallVector() {
+    destroyFrom(0);
+    releaseBlock();
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::push(const T &_val) {
+    emplace(_val);
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::push(T &&_val) {
+    emplace(std::move(_val));
+}
+
+template<class T, std::size_t N>
+template<class... Args_t>
+T *FastSmallVector<T, N>::emplace(Args_t &&..._args) {
+    if (!isFull()) {
+        T *item = ::new (static_cast<void *>(m_items + m_size)) T(std::forward<Args_t>(_args)...);
+        ++m_size;
+
+        return item;
+    }
+
+    // the value is constructed in the new block before the items are relocated, so the arguments may refer to them.
+    const auto capacity = grownCapacity(m_size + 1);
+    T *items = std::allocator<T>().allocate(capacity);
+    T *item = nullptr;
+    try {
+        item = ::new (static_cast<void *>(items + m_size)) T(std::forward<Args_t>(_args)...);
+        relocate(m_items, m_size, items);
+    } catch (...) {
+        if (item != nullptr) {
+            item->~T();
+        }
+        std::allocator<T>().deallocate(items, capacity);
+        throw;
+    }
+
+    releaseBlock();
+    m_items = items;
+    m_capacity = capacity;
+    ++m_size;
+
+    return item;
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::append(const T *_values, std::size_t _count) {
+    if (_count <= m_capacity - m_size) {
+        copyValues(_values, _count, m_items + m_size);
+        m_size += _count;
+        return;
+    }
+
+    // the values are copied into the new block before the items are relocated, so they may be the items.
+    const auto capacity = grownCapacity(m_size + _count);
+    T *items = std::allocator<T>().allocate(capacity);
+    bool copied = false;
+    try {
+        copyValues(_values, _count, items + m_size);
+        copied = true;
+        relocate(m_items, m_size, items);
+    } catch (...) {
+        if (copied) {
+            std::destroy_n(items + m_size, _count);
+        }
+        std::allocator<T>().deallocate(items, capacity);
+        throw;
+    }
+
+    releaseBlock();
+    m_items = items;
+    m_capacity = capacity;
+    m_size += _count;
+}
+
+template<class T, std::size_t N>
+template<class Range_t>
+void FastSmallVector<T, N>::append(const Range_t &_range) {
+    using Value_t = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(_range))>>;
+    using Iterator_t = decltype(std::begin(_range));
+
+    if constexpr (std::is_same_v<Value_t, T> && IsContiguousRange<Range_t>::value) {
+        append(std::data(_range), std::size(_range));
+    } else if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                           typename std::iterator_traits<Iterator_t>::iterator_category>) {
+        const auto count = static_cast<std::size_t>(std::distance(std::begin(_range), std::end(_range)));
+        reserve(m_size + count);
+
+        std::uninitialized_copy_n(std::begin(_range), count, m_items + m_size);
+        m_size += count;
+    } else {
+        for (const auto &value : _range) {
+            push(value);
+        }
+    }
+}
+
+template<class T, std::size_t N>
+T *FastSmallVector<T, N>::insert(const T *_position, const T &_val) {
+    return emplaceAt(_position, _val);
+}
+
+template<class T, std::size_t N>
+T *FastSmallVector<T, N>::insert(const T *_position, T &&_val) {
+    return emplaceAt(_position, std::move(_val));
+}
+
+template<class T, std::size_t N>
+T *FastSmallVector<T, N>::insert(const T *_position, const T *_values, std::size_t _count) {
+    const auto index = static_cast<std::size_t>(_position - m_items);
+    const auto oldSize = m_size;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (!overlapsItems(_values, _count)) {
+            if (_count > m_capacity - m_size) {
+                reallocate(grownCapacity(m_size + _count));
+            }
+            if (_count != 0) {
+                std::memmove(static_cast<void *>(m_items + index + _count), m_items + index, (oldSize - index) * sizeof(T));
+                std::memcpy(static_cast<void *>(m_items + index), _values, _count * sizeof(T));
+            }
+            m_size += _count;
+
+            return m_items + index;
+        }
+    }
+
+    // the values are appended first: append() handles the growth and the values which are the items.
+    append(_values, _count);
+    std::rotate(m_items + index, m_items + oldSize, m_items + m_size);
+
+    return m_items + index;
+}
+
+template<class T, std::size_t N>
+template<class... Args_t>
+T *FastSmallVector<T, N>::emplaceAt(const T *_position, Args_t &&..._args) {
+    const auto index = static_cast<std::size_t>(_position - m_items);
+    // the value is appended first: emplace() handles the growth and the arguments which refer to the items.
+    emplace(std::forward<Args_t>(_args)...);
+    if (index + 1 == m_size) {
+        return m_items + index;
+    }
+
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        const T value = m_items[m_size - 1];
+        std::memmove(static_cast<void *>(m_items + index + 1), m_items + index, (m_size - 1 - index) * sizeof(T));
+        m_items[index] = value;
+    } else {
+        std::rotate(m_items + index, m_items + m_size - 1, m_items + m_size);
+    }
+
+    return m_items + index;
+}
+
+template<class T, std::size_t N>
+T *FastSmallVector<T, N>::erase(const T *_position) {
+    return erase(_position, _position + 1);
+}
+
+template<class T, std::size_t N>
+T *FastSmallVector<T, N>::erase(const T *_first, const T *_last) {
+    T *first = m_items + (_first - m_items);
+    T *last = m_items + (_last - m_items);
+    if (first != last) {
+        destroyFrom(static_cast<std::size_t>(std::move(last, end(), first) - m_items));
+    }
+
+    return first;
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::resize(std::size_t _size) {
+    if (_size <= m_size) {
+        destroyFrom(_size);
+        return;
+    }
+
+    reserve(_size);
+    std::uninitialized_value_construct(m_items + m_size, m_items + _size);
+    m_size = _size;
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::resize(std::size_t _size, const T &_val) {
+    if (_size <= m_size) {
+        destroyFrom(_size);
+        return;
+    }
+
+    while (m_size < _size) {
+        emplace(_val);
+    }
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::resizeUninitialized(std::size_t _size) {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "resizeUninitialized() needs a trivial type");
+
+    if (_size > m_capacity) {
+        reallocate(grownCapacity(_size));
+    }
+
+    m_size = _size;
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::reserve(std::size_t _capacity) {
+    if (_capacity > m_capacity) {
+        reallocate(_capacity);
+    }
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::shrinkToFit() noexcept(IsTriviallyRelocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+    if (isInline() || m_size > N) {
+        return;
+    }
+
+    T *items = m_items;
+    const auto capacity = m_capacity;
+    relocate(items, m_size, inlineItems());
+    m_items = inlineItems();
+    m_capacity = N;
+    std::allocator<T>().deallocate(items, capacity);
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::clear() noexcept {
+    destroyFrom(0);
+    m_truncated = 0;
+}
+
+template<class T, std::size_t N>
+T &FastSmallVector<T, N>::at(std::size_t _index) {
+    if (_index >= m_size) {
+        throw UserException(UserException::Static, "Index is out of range", "_index >= size()", __PRETTY_FUNCTION__);
+    }
+
+    return m_items[_index];
+}
+
+template<class T, std::size_t N>
+const T &FastSmallVector<T, N>::at(std::size_t _index) const {
+    if (_index >= m_size) {
+        throw UserException(UserException::Static, "Index is out of range", "_index >= size()", __PRETTY_FUNCTION__);
+    }
+
+    return m_items[_index];
+}
+
+template<class T, std::size_t N>
+T FastSmallVector<T, N>::pop() {
+    if (isEmpty()) {
+        throw UserException(UserException::Static, "Vector is empty", "isEmpty()", __PRETTY_FUNCTION__);
+    }
+
+    T value(std::move(m_items[m_size - 1]));
+    destroyFrom(m_size - 1);
+
+    return value;
+}
+
+template<class T, std::size_t N>
+T &FastSmallVector<T, N>::top() const {
+    if (isEmpty()) {
+        throw UserException(UserException::Static, "Vector is empty", "isEmpty()", __PRETTY_FUNCTION__);
+    }
+
+    return m_items[m_size - 1];
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::relocate(T *_from, std::size_t _count, T *_to) {
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        if (_count != 0) {
+            std::memcpy(static_cast<void *>(_to), static_cast<const void *>(_from), _count * sizeof(T));
+        }
+    } else {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(_from, _count, _to);
+        } else {
+            std::uninitialized_copy_n(_from, _count, _to);
+        }
+        std::destroy_n(_from, _count);
+    }
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::copyValues(const T *_values, std::size_t _count, T *_to) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (_count != 0) {
+            std::memcpy(static_cast<void *>(_to), _values, _count * sizeof(T));
+        }
+    } else {
+        std::uninitialized_copy_n(_values, _count, _to);
+    }
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::reallocate(std::size_t _capacity) {
+    T *items = std::allocator<T>().allocate(_capacity);
+    try {
+        relocate(m_items, m_size, items);
+    } catch (...) {
+        std::allocator<T>().deallocate(items, _capacity);
+        throw;
+    }
+
+    releaseBlock();
+    m_items = items;
+    m_capacity = _capacity;
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::releaseBlock() noexcept {
+    if (!isInline()) {
+        std::allocator<T>().deallocate(m_items, m_capacity);
+        m_items = inlineItems();
+        m_capacity = N;
+    }
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::destroyFrom(std::size_t _size) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy(m_items + _size, m_items + m_size);
+    }
+
+    m_size = _size;
+}
+
+template<class T, std::size_t N>
+void FastSmallVector<T, N>::moveFrom(FastSmallVector &_other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (!_other.isInline()) {
+        // the heap block is stolen, the items stay where they are.
+        m_items = _other.m_items;
+        m_capacity = _other.m_capacity;
+        m_size = _other.m_size;
+        _other.m_items = _other.inlineItems();
+        _other.m_capacity = N;
+        _other.m_size = 0;
+    } else {
+        if constexpr (IsTriviallyRelocatable_v<T>) {
+            if (_other.m_size != 0) {
+                std::memcpy(static_cast<void *>(m_items), static_cast<const void *>(_other.m_items), _other.m_size * sizeof(T));
+            }
+            m_size = _other.m_size;
+            _other.m_size = 0;
+        } else {
+            std::uninitialized_move_n(_other.m_items, _other.m_size, m_items);
+            m_size = _other.m_size;
+            _other.destroyFrom(0);
+        }
+    }
+
+    _other.m_truncated = 0;
+}
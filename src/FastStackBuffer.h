@@ -2,25 +2,114 @@
 
 #include "UserException.h"
 
-#include <array>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
 #include <string_view>
+#include <type_traits>
 
-template<class T, std::size_t N>
+/*!
+ * @brief ThrowOnOverflow throws UserException when the values do not fit into the stack.
+ */
+struct ThrowOnOverflow {
+    //! The values which do not fit are dropped instead of calling overflow().
+    static constexpr bool Truncates = false;
+
+    /*!
+     * @brief Called when the values do not fit into the stack.
+     * @param _dbMsg - debug message with the static storage duration.
+     * @param _funcInfo - function name with the static storage duration.
+     */
+    [[noreturn]]
+    static void overflow(const char *_dbMsg, const char *_funcInfo) {
+        throw UserException(UserException::Static, "Stack is full", _dbMsg, _funcInfo);
+    }
+};
+
+/*!
+ * @brief TerminateOnOverflow asserts and terminates the process when the values do not fit into the stack.
+ */
+struct TerminateOnOverflow {
+    //! The values which do not fit are dropped instead of calling overflow().
+    static constexpr bool Truncates = false;
+
+    /*!
+     * @brief Called when the values do not fit into the stack.
+     */
+    [[noreturn]]
+    static void overflow([[maybe_unused]] const char *_dbMsg, [[maybe_unused]] const char *_funcInfo) noexcept {
+        assert(!"FastStackBuffer overflow");
+        std::terminate();
+    }
+};
+
+/*!
+ * @brief TruncateOnOverflow silently drops the values which do not fit into the stack.
+ */
+struct TruncateOnOverflow {
+    //! The values which do not fit are dropped instead of calling overflow().
+    static constexpr bool Truncates = true;
+    //! CharFastStackBuffer::writeTruncationMarker() writes the marker.
+    static constexpr bool WritesMarker = false;
+};
+
+/*!
+ * @brief TruncateWithMarkerOnOverflow drops the values which do not fit into the stack,
+ * CharFastStackBuffer::writeTruncationMarker() replaces the tail with "...[truncated N bytes]".
+ */
+struct TruncateWithMarkerOnOverflow {
+    //! The values which do not fit are dropped instead of calling overflow().
+    static constexpr bool Truncates = true;
+    //! CharFastStackBuffer::writeTruncationMarker() writes the marker.
+    static constexpr bool WritesMarker = true;
+};
+
+template<class T, std::size_t N, class OverflowPolicy_t>
 class FastStackBuffer;
 
+/*!
+ * @brief IsTriviallyRelocatable is true if moving the value to a new address and ending the lifetime of the source
+ * is equivalent to memcpy. It is true for the trivially copyable types; specialize it for other types,
+ * e.g. the ones which hold a pointer to the heap.
+ * @tparam T - value type.
+ */
+template<class T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template<class T>
+inline constexpr bool IsTriviallyRelocatable_v = IsTriviallyRelocatable<T>::value;
+
+/*!
+ * @brief IsContiguousRange is true if the range provides std::data() and std::size().
+ * @tparam Range_t - range type.
+ */
+template<class Range_t, class = void>
+struct IsContiguousRange : std::false_type {};
+
+template<class Range_t>
+struct IsContiguousRange<Range_t, std::void_t<decltype(std::data(std::declval<const Range_t &>())),
+                                              decltype(std::size(std::declval<const Range_t &>()))>>
+        : std::true_type {};
+
 /*!
  * @brief Output iterator.
  * @tparam T - stack element type.
  * @tparam N - the stack size.
+ * @tparam OverflowPolicy_t - the stack overflow policy.
  */
-template<class T, std::size_t N = 1024>
+template<class T, std::size_t N = 1024, class OverflowPolicy_t = ThrowOnOverflow>
 class FastStackBufferOutputIterator {
 public:
     /*!
      * @brief Constructor.
      * @param _stackBuffer - stack implementation.
      */
-    explicit  FastStackBufferOutputIterator(FastStackBuffer<T, N> &_stackBuffer): m_instance(&_stackBuffer){}
+    explicit  FastStackBufferOutputIterator(FastStackBuffer<T, N, OverflowPolicy_t> &_stackBuffer): m_instance(&_stackBuffer){}
 
 private:
     //! Proxy class.
@@ -56,38 +145,153 @@ public:
 
 private:
     //! The instance of stack buffer.
-    FastStackBuffer<T, N> *m_instance;
+    FastStackBuffer<T, N, OverflowPolicy_t> *m_instance;
 };
 
 /*!
  * @brief The FastStackBuffer class is a simple stack implementation.
+ * The items live in the aligned raw storage: they are constructed by push() and emplace() and destroyed by pop() and clear(),
+ * so creating and destroying the stack costs O(size()), and T does not need a default constructor.
  * @tparam T - stack element type.
  * @tparam N - the stack size.
+ * @tparam OverflowPolicy_t - what happens when the values do not fit into the stack: ThrowOnOverflow,
+ * TerminateOnOverflow, TruncateOnOverflow or TruncateWithMarkerOnOverflow.
  */
-template<class T, std::size_t N = 1024>
+template<class T, std::size_t N = 1024, class OverflowPolicy_t = ThrowOnOverflow>
 class FastStackBuffer {
 public:
     /*!
-     * @brief The array iterator type.
+     * @brief The stack overflow policy.
+     */
+    using OverflowPolicy = OverflowPolicy_t;
+    /*!
+     * @brief The size type.
+     */
+    using Distance_t = std::ptrdiff_t;
+
+    /*!
+     * @brief Construct an empty FastStackBuffer object. The storage is not initialized.
+     */
+    FastStackBuffer() noexcept {}
+
+    /*!
+     * @brief Copy constructor. Trivially copyable values are copied by memcpy.
+     */
+    FastStackBuffer(const FastStackBuffer &_other);
+
+    /*!
+     * @brief Move constructor. The values are moved, trivially relocatable ones by memcpy. The source becomes empty.
+     */
+    FastStackBuffer(FastStackBuffer &&_other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Copy operator.
+     */
+    FastStackBuffer &operator=(const FastStackBuffer &_other);
+
+    /*!
+     * @brief Move operator. The source becomes empty.
      */
-    using array_iterator_t = typename std::array<T, N>::iterator;
+    FastStackBuffer &operator=(FastStackBuffer &&_other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
     /*!
-     * @brief The iterator distance type.
+     * @brief Destroy the FastStackBuffer object, the items are destroyed.
      */
-    using Distance_t = typename std::iterator_traits<array_iterator_t>::difference_type;
+    ~FastStackBuffer();
 
     /**
-     * @brief Push a value onto the stack. Returns true if the operation is successful; otherwise returns false.
-     * @throw UserException - if stack is full.
+     * @brief Push a value onto the stack. If the stack is full, the overflow policy is applied.
+     * @throw UserException - if stack is full and the policy is ThrowOnOverflow.
      */
     void push(const T &_val);
 
     /**
-     * @brief Push a value onto the stack. Returns true if the operation is successful; otherwise returns false.
-     * @throw UserException - if stack is full.
+     * @brief Push a value onto the stack. If the stack is full, the overflow policy is applied.
+     * @throw UserException - if stack is full and the policy is ThrowOnOverflow.
      */
     void push(T &&_val);
 
+    /**
+     * @brief Constructs a value on the top of the stack. If the stack is full, the overflow policy is applied.
+     * @return The pointer to the constructed value or nullptr if the value is dropped by a truncating policy.
+     * @throw UserException - if stack is full and the policy is ThrowOnOverflow.
+     */
+    template<class... Args_t>
+    T *emplace(Args_t &&..._args);
+
+    /**
+     * @brief Push a value onto the stack. Returns true if the operation is successful; otherwise returns false.
+     */
+    [[nodiscard]]
+    bool tryPush(const T &_val) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+    /**
+     * @brief Push a value onto the stack. Returns true if the operation is successful; otherwise returns false.
+     */
+    [[nodiscard]]
+    bool tryPush(T &&_val) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /**
+     * @brief Constructs a value on the top of the stack.
+     * @return The pointer to the constructed value or nullptr if the stack is full.
+     */
+    template<class... Args_t>
+    [[nodiscard]]
+    T *tryEmplace(Args_t &&..._args) noexcept(std::is_nothrow_constructible_v<T, Args_t...>);
+
+    /*!
+     * @brief Pushes the values onto the stack with one capacity check. Trivially copyable values are copied by memcpy.
+     * @param _values - the values.
+     * @param _count - number of the values.
+     * @throw UserException - if the values do not fit into the stack and the policy is ThrowOnOverflow.
+     */
+    void append(const T *_values, std::size_t _count);
+
+    /*!
+     * @brief Pushes the values of the range onto the stack with one capacity check.
+     * @param _range - the range, contiguous ranges are copied by memcpy.
+     * @throw UserException - if the values do not fit into the stack and the policy is ThrowOnOverflow.
+     */
+    template<class Range_t>
+    void append(const Range_t &_range);
+
+    /*!
+     * @brief Changes the size of the stack. The values between the old and the new size are not assigned,
+     * the caller writes them through data(). A truncating policy limits the size to the capacity.
+     * Only for the trivial types, whose lifetime does not need construction and destruction.
+     * @throw UserException - if the size is greater than the capacity and the policy is ThrowOnOverflow.
+     */
+    void resizeUninitialized(std::size_t _size);
+
+    /*!
+     * @brief Destroys all items. The truncated() counter is reset too.
+     */
+    void clear() noexcept;
+
+    /*!
+     * @brief Returns the number of values dropped by a truncating overflow policy.
+     */
+    [[nodiscard]]
+    std::size_t truncated() const noexcept;
+
+    /*!
+     * @brief Adds the number of values dropped by the caller to truncated(),
+     * e.g. the chars which did not fit into the stream put area.
+     */
+    void addTruncated(std::size_t _count) noexcept;
+
+    /*!
+     * @brief Returns the pointer to the bottom item of the stack.
+     */
+    [[nodiscard]]
+    T *data() noexcept;
+
+    /*!
+     * @brief Returns the pointer to the bottom item of the stack.
+     */
+    [[nodiscard]]
+    const T *data() const noexcept;
+
     /*!
      * @brief Removes the top item from the stack and returns it.
      * @throw UserException - if stack is empty;
@@ -102,6 +306,18 @@ public:
     [[nodiscard]]
     T &top() const;
 
+    /*!
+     * @brief Removes the top item from the stack and returns it. Returns std::nullopt if the stack is empty.
+     */
+    [[nodiscard]]
+    std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Returns the pointer to the top item of the stack or nullptr if the stack is empty.
+     */
+    [[nodiscard]]
+    T *tryTop() const noexcept;
+
 
     /*!
      * @brief Returns true if the stack contains no items; otherwise returns false.
@@ -129,72 +345,324 @@ public:
 
 protected:
     /*!
-     * @brief Underlying array.
+     * @brief Returns the pointer to the bottom item of the stack.
      */
-    std::array<T, N> m_buffer;
+    T *items() const noexcept {
+        return std::launder(reinterpret_cast<T *>(const_cast<unsigned char *>(m_storage)));
+    }
+
+    /*!
+     * @brief Destroys the items above the size.
+     */
+    void destroyFrom(std::size_t _size) noexcept;
+
     /*!
-     * @brief End of stack iterator.
+     * @brief Copies the items of the other stack into the empty stack.
      */
-    array_iterator_t m_nextIt{m_buffer.begin()};
+    void copyFrom(const FastStackBuffer &_other);
+
+    /*!
+     * @brief Moves the items of the other stack into the empty stack and empties the other stack.
+     */
+    void moveFrom(FastStackBuffer &_other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /*!
+     * @brief Returns the number of the values which fit, applying the overflow policy to the rest.
+     */
+    std::size_t reserve(std::size_t _count, const char *_dbMsg, const char *_funcInfo);
+
+    /*!
+     * @brief The raw storage of the items.
+     */
+    alignas(T) unsigned char m_storage[N * sizeof(T)];
+    /*!
+     * @brief The number of items.
+     */
+    std::size_t m_size = 0;
+    /*!
+     * @brief The number of values dropped by a truncating overflow policy.
+     */
+    std::size_t m_truncated = 0;
 };
 
-template<class T, size_t N>
-void FastStackBuffer<T, N>::push(const T &_val) {
+template<class T, size_t N, class OverflowPolicy_t>
+FastStackBuffer<T, N, OverflowPolicy_t>::FastStackBuffer(const FastStackBuffer &_other) : m_truncated(_other.m_truncated) {
+    copyFrom(_other);
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+FastStackBuffer<T, N, OverflowPolicy_t>::FastStackBuffer(FastStackBuffer &&_other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : m_truncated(_other.m_truncated) {
+    moveFrom(_other);
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+FastStackBuffer<T, N, OverflowPolicy_t> &FastStackBuffer<T, N, OverflowPolicy_t>::operator=(const FastStackBuffer &_other) {
+    if (this != &_other) {
+        clear();
+        copyFrom(_other);
+        m_truncated = _other.m_truncated;
+    }
+
+    return *this;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+FastStackBuffer<T, N, OverflowPolicy_t> &FastStackBuffer<T, N, OverflowPolicy_t>::operator=(FastStackBuffer &&_other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this != &_other) {
+        clear();
+        m_truncated = _other.m_truncated;
+        moveFrom(_other);
+    }
+
+    return *this;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+FastStackBuffer<T, N, OverflowPolicy_t>::~FastStackBuffer() {
+    destroyFrom(0);
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::push(const T &_val) {
+    emplace(_val);
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::push(T &&_val) {
+    emplace(std::move(_val));
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+template<class... Args_t>
+T *FastStackBuffer<T, N, OverflowPolicy_t>::emplace(Args_t &&..._args) {
     if (isFull()) {
-        throw UserException("Stack is full", "isFull()", __PRETTY_FUNCTION__);
+        if constexpr (OverflowPolicy_t::Truncates) {
+            ++m_truncated;
+            return nullptr;
+        } else {
+            OverflowPolicy_t::overflow("isFull()", __PRETTY_FUNCTION__);
+        }
     }
 
-    *m_nextIt = _val;
+    T *item = ::new (static_cast<void *>(items() + m_size)) T(std::forward<Args_t>(_args)...);
+    ++m_size;
+
+    return item;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+bool FastStackBuffer<T, N, OverflowPolicy_t>::tryPush(const T &_val) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+    return tryEmplace(_val) != nullptr;
+}
 
-    ++m_nextIt;
+template<class T, size_t N, class OverflowPolicy_t>
+bool FastStackBuffer<T, N, OverflowPolicy_t>::tryPush(T &&_val) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    return tryEmplace(std::move(_val)) != nullptr;
 }
 
-template<class T, size_t N>
-void FastStackBuffer<T, N>::push(T &&_val) {
+template<class T, size_t N, class OverflowPolicy_t>
+template<class... Args_t>
+T *FastStackBuffer<T, N, OverflowPolicy_t>::tryEmplace(Args_t &&..._args) noexcept(std::is_nothrow_constructible_v<T, Args_t...>) {
     if (isFull()) {
-        throw UserException("Stack is full", "isFull()", __PRETTY_FUNCTION__);
+        return nullptr;
     }
 
-    *m_nextIt = std::move(_val);
+    T *item = ::new (static_cast<void *>(items() + m_size)) T(std::forward<Args_t>(_args)...);
+    ++m_size;
 
-    ++m_nextIt;
+    return item;
 }
 
-template<class T, size_t N>
-T FastStackBuffer<T, N>::pop() {
+template<class T, size_t N, class OverflowPolicy_t>
+std::size_t FastStackBuffer<T, N, OverflowPolicy_t>::reserve(std::size_t _count, const char *_dbMsg, const char *_funcInfo) {
+    if (const auto freeSize = N - m_size; _count > freeSize) {
+        if constexpr (OverflowPolicy_t::Truncates) {
+            m_truncated += _count - freeSize;
+            return freeSize;
+        } else {
+            OverflowPolicy_t::overflow(_dbMsg, _funcInfo);
+        }
+    }
+
+    return _count;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::append(const T *_values, std::size_t _count) {
+    _count = reserve(_count, "_count > N - size()", __PRETTY_FUNCTION__);
+    if (_count == 0) {
+        return;
+    }
+
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memcpy(static_cast<void *>(items() + m_size), _values, _count * sizeof(T));
+    } else {
+        std::uninitialized_copy_n(_values, _count, items() + m_size);
+    }
+
+    m_size += _count;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+template<class Range_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::append(const Range_t &_range) {
+    using Value_t = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(_range))>>;
+    using Iterator_t = decltype(std::begin(_range));
+
+    if constexpr (std::is_same_v<Value_t, T> && IsContiguousRange<Range_t>::value) {
+        append(std::data(_range), std::size(_range));
+    } else if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                           typename std::iterator_traits<Iterator_t>::iterator_category>) {
+        const auto count = reserve(static_cast<std::size_t>(std::distance(std::begin(_range), std::end(_range))),
+                                   "count > N - size()", __PRETTY_FUNCTION__);
+
+        std::uninitialized_copy_n(std::begin(_range), count, items() + m_size);
+        m_size += count;
+    } else {
+        for (const auto &value : _range) {
+            push(value);
+        }
+    }
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::resizeUninitialized(std::size_t _size) {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "resizeUninitialized() needs a trivial type");
+
+    if (_size > N) {
+        if constexpr (OverflowPolicy_t::Truncates) {
+            m_truncated += _size - N;
+            _size = N;
+        } else {
+            OverflowPolicy_t::overflow("_size > N", __PRETTY_FUNCTION__);
+        }
+    }
+
+    m_size = _size;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::clear() noexcept {
+    destroyFrom(0);
+    m_truncated = 0;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::destroyFrom(std::size_t _size) noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        std::destroy(items() + _size, items() + m_size);
+    }
+
+    m_size = _size;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::copyFrom(const FastStackBuffer &_other) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memcpy(static_cast<void *>(items()), _other.items(), _other.m_size * sizeof(T));
+    } else {
+        std::uninitialized_copy_n(_other.items(), _other.m_size, items());
+    }
+
+    m_size = _other.m_size;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::moveFrom(FastStackBuffer &_other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if constexpr (IsTriviallyRelocatable_v<T>) {
+        // the items are relocated: the source items end their lifetime without the destructor call.
+        std::memcpy(static_cast<void *>(items()), static_cast<const void *>(_other.items()), _other.m_size * sizeof(T));
+        m_size = _other.m_size;
+        _other.m_size = 0;
+    } else {
+        std::uninitialized_move_n(_other.items(), _other.m_size, items());
+        m_size = _other.m_size;
+        _other.destroyFrom(0);
+    }
+
+    _other.m_truncated = 0;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+std::size_t FastStackBuffer<T, N, OverflowPolicy_t>::truncated() const noexcept {
+    return m_truncated;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+void FastStackBuffer<T, N, OverflowPolicy_t>::addTruncated(std::size_t _count) noexcept {
+    m_truncated += _count;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+T *FastStackBuffer<T, N, OverflowPolicy_t>::data() noexcept {
+    return items();
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+const T *FastStackBuffer<T, N, OverflowPolicy_t>::data() const noexcept {
+    return items();
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+T FastStackBuffer<T, N, OverflowPolicy_t>::pop() {
     if (isEmpty()) {
-        throw UserException("Stack is empty", "isEmpty()", __PRETTY_FUNCTION__);
+        throw UserException(UserException::Static, "Stack is empty", "isEmpty()", __PRETTY_FUNCTION__);
     }
 
-    return std::move(*(--m_nextIt));
+    T value(std::move(items()[m_size - 1]));
+    destroyFrom(m_size - 1);
+
+    return value;
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+T &FastStackBuffer<T, N, OverflowPolicy_t>::top() const {
+    if (isEmpty()) {
+        throw UserException(UserException::Static, "Stack is empty", "isEmpty()", __PRETTY_FUNCTION__);
+    }
+
+    return items()[m_size - 1];
+}
+
+template<class T, size_t N, class OverflowPolicy_t>
+std::optional<T> FastStackBuffer<T, N, OverflowPolicy_t>::tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (isEmpty()) {
+        return std::nullopt;
+    }
+
+    std::optional<T> value(std::move(items()[m_size - 1]));
+    destroyFrom(m_size - 1);
+
+    return value;
 }
 
-template<class T, size_t N>
-T &FastStackBuffer<T, N>::top() const {
+template<class T, size_t N, class OverflowPolicy_t>
+T *FastStackBuffer<T, N, OverflowPolicy_t>::tryTop() const noexcept {
     if (isEmpty()) {
-        throw UserException("Stack is empty", "isEmpty()", __PRETTY_FUNCTION__);
+        return nullptr;
     }
 
-    auto prevIt = m_nextIt;
-    return *(--prevIt);
+    return items() + m_size - 1;
 }
 
-template<class T, size_t N>
-inline constexpr bool FastStackBuffer<T, N>::isEmpty() const noexcept {
-    return m_nextIt == m_buffer.begin();
+template<class T, size_t N, class OverflowPolicy_t>
+inline constexpr bool FastStackBuffer<T, N, OverflowPolicy_t>::isEmpty() const noexcept {
+    return m_size == 0;
 }
 
-template<class T, size_t N>
-inline constexpr typename FastStackBuffer<T, N>::Distance_t FastStackBuffer<T, N>::size() const noexcept {
-    return m_nextIt - m_buffer.begin();
+template<class T, size_t N, class OverflowPolicy_t>
+inline constexpr typename FastStackBuffer<T, N, OverflowPolicy_t>::Distance_t FastStackBuffer<T, N, OverflowPolicy_t>::size() const noexcept {
+    return static_cast<Distance_t>(m_size);
 }
 
-template<class T, size_t N>
-inline constexpr size_t FastStackBuffer<T, N>::capacity() const noexcept {
+template<class T, size_t N, class OverflowPolicy_t>
+inline constexpr size_t FastStackBuffer<T, N, OverflowPolicy_t>::capacity() const noexcept {
     return N;
 }
 
-template<class T, size_t N>
-inline constexpr bool FastStackBuffer<T, N>::isFull() const noexcept {
-    return size() == N;
+template<class T, size_t N, class OverflowPolicy_t>
+inline constexpr bool FastStackBuffer<T, N, OverflowPolicy_t>::isFull() const noexcept {
+    return m_size == N;
 }
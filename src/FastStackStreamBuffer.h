@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <ostream>
 #include <string>
 
@@ -7,9 +8,15 @@
 
 /*!
  * @brief FastStackStreamBuffer is stream stack based buffer.
+ * The free part of the stack buffer is the put area of the stream buffer, so the stream writes into the stack buffer directly.
+ * The written characters are committed to the stack buffer by sync(), e.g. by std::ostream::flush().
+ * If the overflow policy truncates, the characters which do not fit are counted by the stack buffer
+ * and the stream stays good; with GrowOnOverflow the stack buffer grows and the put area follows it;
+ * otherwise they are discarded and the stream fails.
  * @tparam N - the buffer size.
+ * @tparam OverflowPolicy_t - the stack overflow policy, see FastStackBuffer.
  */
-template <class Char_t = char, size_t N = 1024>
+template <class Char_t = char, size_t N = 1024, class OverflowPolicy_t = ThrowOnOverflow>
 class FastStackStreamBuffer final : public std::basic_streambuf<Char_t> {
    public:
     using char_traits = std::char_traits<Char_t>;
@@ -19,7 +26,7 @@ class FastStackStreamBuffer final : public std::basic_streambuf<Char_t> {
      * @param _impl - instance of CharFastStackBuffer.
      * @param _freeze - is ownership mark. If _freeze is true, the buffer does not control the object's lifetime.
      */
-    explicit FastStackStreamBuffer(CharFastStackBuffer<Char_t, N> &_impl, bool _freeze = true);
+    explicit FastStackStreamBuffer(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_impl, bool _freeze = true);
     
     /*!
      * @brief Destroy the FastStackStreamBuffer object
@@ -32,13 +39,13 @@ class FastStackStreamBuffer final : public std::basic_streambuf<Char_t> {
      * @note Now this object has no control over the buffer lifetime.
      * @return Stack buffer.
      */
-    CharFastStackBuffer<Char_t, N> *buffer();
+    CharFastStackBuffer<Char_t, N, OverflowPolicy_t> *buffer();
     /*!
      * @brief Set the Buffer object
      * @param _impl - instance of CharFastStackBuffer.
      * @param _freeze - is ownership mark. If _freeze is true, the buffer does not control the object's lifetime.
      */
-    void setBuffer(CharFastStackBuffer<Char_t, N> &_impl, bool _freeze = true);
+    void setBuffer(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_impl, bool _freeze = true);
     /*!
      * @brief Set the Freeze object
      * @param _freeze is ownership mark. If _freeze is true, the buffer does not control the object's lifetime
@@ -57,19 +64,25 @@ class FastStackStreamBuffer final : public std::basic_streambuf<Char_t> {
     */
     typename char_traits::int_type overflow(typename char_traits::int_type _c = char_traits::eof()) override;
     /*!
-     * @brief Writes count characters to the output sequence from the character array whose first element is pointed to by s. The characters are written as if by repeated calls to sputc(). 
-     * Writing stops when either count characters are written or a call to sputc() would have returned Traits::eof().
+     * @brief Writes count characters to the output sequence from the character array whose first element is pointed to by s.
+     * The characters are copied into the put area with one memcpy; the characters which do not fit into the buffer are discarded.
      * @param _s - characters.
      * @param _count - number of characters.
-     * @return std::streamsize - the number of characters successfully written.
+     * @return std::streamsize - the number of characters successfully written, or _count if the overflow policy truncates.
      */
-    virtual std::streamsize xputn(const typename char_traits::char_type *_s, std::streamsize _count);
+    std::streamsize xsputn(const typename char_traits::char_type *_s, std::streamsize _count) override;
+    /*!
+     * @brief Commits the characters written to the put area to the stack buffer and points the put area
+     * to the free part of the stack buffer.
+     * @return 0 on success, -1 if there is no buffer.
+     */
+    int sync() override;
 
    private:
    /*!
     * @brief The Stack buffer.
     */
-    CharFastStackBuffer<Char_t, N> *m_impl;
+    CharFastStackBuffer<Char_t, N, OverflowPolicy_t> *m_impl;
     /**
      * @brief The ownership mark.
      * 
@@ -77,56 +90,109 @@ class FastStackStreamBuffer final : public std::basic_streambuf<Char_t> {
     bool m_freeze;
 };
 
-template <class Char_t, size_t N>
-FastStackStreamBuffer<Char_t, N>::FastStackStreamBuffer(CharFastStackBuffer<Char_t, N> &_impl, bool _freeze) : m_impl(&_impl), m_freeze(_freeze) {
+template <class Char_t, size_t N, class OverflowPolicy_t>
+FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::FastStackStreamBuffer(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_impl, bool _freeze) : m_impl(&_impl), m_freeze(_freeze) {
+    sync();
 }
 
-template <class Char_t, size_t N>
-FastStackStreamBuffer<Char_t, N>::~FastStackStreamBuffer() {
+template <class Char_t, size_t N, class OverflowPolicy_t>
+FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::~FastStackStreamBuffer() {
+    sync();
+
     if (!m_freeze) {
         delete m_impl;
     }
 }
 
-template <class Char_t, size_t N>
-CharFastStackBuffer<Char_t, N> *FastStackStreamBuffer<Char_t, N>::buffer() {
+template <class Char_t, size_t N, class OverflowPolicy_t>
+CharFastStackBuffer<Char_t, N, OverflowPolicy_t> *FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::buffer() {
+    sync();
+
     m_freeze = true;
     return m_impl;
 }
 
-template <class Char_t, size_t N>
-void FastStackStreamBuffer<Char_t, N>::setBuffer(CharFastStackBuffer<Char_t, N> &_impl, bool _freeze) {
-    m_impl = _impl;
+template <class Char_t, size_t N, class OverflowPolicy_t>
+void FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::setBuffer(CharFastStackBuffer<Char_t, N, OverflowPolicy_t> &_impl, bool _freeze) {
+    sync();
+
+    if (!m_freeze && m_impl != &_impl) {
+        delete m_impl;
+    }
+
+    m_impl = &_impl;
     m_freeze = _freeze;
+    this->setp(nullptr, nullptr);
+
+    sync();
 }
 
-template <class Char_t, size_t N>
-inline void FastStackStreamBuffer<Char_t, N>::setFreeze(bool _freeze) {
+template <class Char_t, size_t N, class OverflowPolicy_t>
+inline void FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::setFreeze(bool _freeze) {
     m_freeze = _freeze;
 }
 
-template <class Char_t, size_t N>
-std::streamsize FastStackStreamBuffer<Char_t, N>::xputn(const typename char_traits::char_type *_s, std::streamsize _count) {
-    for (unsigned int i = 0; i < _count; ++i) {
-            typename char_traits::char_type c = _s[i];
-            if (c == char_traits::eof()) {
-                return i;
-            }
+template <class Char_t, size_t N, class OverflowPolicy_t>
+int FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::sync() {
+    if (m_impl == nullptr) {
+        return -1;
+    }
+
+    const auto written = static_cast<size_t>(this->pptr() - this->pbase());
+    if (written != 0) {
+        m_impl->resizeUninitialized(static_cast<size_t>(m_impl->size()) + written);
+    }
+
+    Char_t *begin = m_impl->data();
+    this->setp(begin + m_impl->size(), begin + m_impl->capacity());
 
-            m_impl->push(c);
+    return 0;
+}
+
+template <class Char_t, size_t N, class OverflowPolicy_t>
+std::streamsize FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::xsputn(const typename char_traits::char_type *_s, std::streamsize _count) {
+    if constexpr (IsGrowingPolicy_v<OverflowPolicy_t>) {
+        if (_count > this->epptr() - this->pptr()) {
+            // the buffer grows, the put area is moved to the new storage.
+            sync();
+            m_impl->append(_s, static_cast<size_t>(_count));
+            sync();
+            return _count;
         }
+    }
+
+    const auto count = std::min<std::streamsize>(_count, this->epptr() - this->pptr());
+    if (count > 0) {
+        char_traits::copy(this->pptr(), _s, static_cast<size_t>(count));
+        this->pbump(static_cast<int>(count));
+    }
+
+    if constexpr (OverflowPolicy_t::Truncates) {
+        m_impl->addTruncated(static_cast<size_t>(_count - count));
+        return _count;
+    }
 
-    return _count;
+    return count;
 }
 
-template <class Char_t, size_t N>
-typename FastStackStreamBuffer<Char_t, N>::char_traits::int_type FastStackStreamBuffer<Char_t, N>::overflow(typename char_traits::int_type _c) {
-    if (m_impl == nullptr || m_impl->isFull() || char_traits::eq_int_type(_c, char_traits::eof())) {
+template <class Char_t, size_t N, class OverflowPolicy_t>
+typename FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::char_traits::int_type FastStackStreamBuffer<Char_t, N, OverflowPolicy_t>::overflow(typename char_traits::int_type _c) {
+    if (sync() != 0 || char_traits::eq_int_type(_c, char_traits::eof())) {
+        return char_traits::eof();
+    }
+
+    if (m_impl->isFull() && !IsGrowingPolicy_v<OverflowPolicy_t>) {
+        if constexpr (OverflowPolicy_t::Truncates) {
+            m_impl->addTruncated(1);
+            return char_traits::not_eof(_c);
+        }
+
         return char_traits::eof();
     }
 
     typename std::char_traits<Char_t>::char_type ch = char_traits::to_char_type(_c);
     m_impl->push(ch);
+    sync();
 
     return char_traits::not_eof(_c);
 }
@@ -0,0 +1,201 @@
+#include "FdLogSink.h"
+
+#include "LogCompression.h"
+#include "UserException.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+//! The maximum number of parts written by one writev call.
+constexpr std::size_t MaxParts = 8;
+
+bool fileExists(const std::string &_path) noexcept {
+    struct stat status {};
+    return ::stat(_path.c_str(), &status) == 0;
+}
+
+/*!
+ * @brief Writes the vectors, a partial write continues from the first unwritten byte.
+ * @return false if the write failed.
+ */
+bool writeVectors(int _fd, iovec *_first, int _count) noexcept {
+    while (_count > 0) {
+        auto written = ::writev(_fd, _first, _count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return false;
+        }
+
+        while (_count > 0 && static_cast<std::size_t>(written) >= _first->iov_len) {
+            written -= static_cast<ssize_t>(_first->iov_len);
+            ++_first;
+            --_count;
+        }
+
+        if (_count > 0) {
+            _first->iov_base = static_cast<char *>(_first->iov_base) + written;
+            _first->iov_len -= static_cast<std::size_t>(written);
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * @brief Moves the file, plain or compressed, one place up. The shifted file replaces both forms of the older one.
+ * @return false if the existing file cannot be renamed.
+ */
+bool shiftFile(const std::string &_from, const std::string &_to) noexcept {
+    if (!fileExists(_from)) {
+        std::remove(_to.c_str());
+        return true;
+    }
+
+    return std::rename(_from.c_str(), _to.c_str()) == 0;
+}
+}  // namespace
+
+FdLogSink::FdLogSink(int _fd, FlushPolicy _policy, bool _ownsFd) : BufferedLogSink(_policy), m_fd(_fd), m_ownsFd(_ownsFd) {
+}
+
+FdLogSink::~FdLogSink() {
+    flush();
+
+    if (m_ownsFd && m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+void FdLogSink::writeOutput(const std::string_view *_parts, std::size_t _count) {
+    std::size_t total = 0;
+    for (std::size_t batch = 0; batch < _count; batch += MaxParts) {
+        iovec vectors[MaxParts];
+        int count = 0;
+        for (std::size_t i = batch; i < _count && i < batch + MaxParts; ++i) {
+            if (!_parts[i].empty()) {
+                vectors[count].iov_base = const_cast<char *>(_parts[i].data());
+                vectors[count].iov_len = _parts[i].size();
+                total += _parts[i].size();
+                ++count;
+            }
+        }
+
+        if (!writeVectors(m_fd, vectors, count)) {
+            // the records are lost, the logging must not fail the caller.
+            return;
+        }
+    }
+
+    onWritten(total);
+}
+
+void FdLogSink::replaceFd(int _fd) noexcept {
+    if (m_ownsFd && m_fd >= 0) {
+        ::close(m_fd);
+    }
+
+    m_fd = _fd;
+}
+
+StdoutLogSink::StdoutLogSink(FlushPolicy _policy) : FdLogSink(STDOUT_FILENO, _policy) {
+}
+
+StderrLogSink::StderrLogSink(FlushPolicy _policy) : FdLogSink(STDERR_FILENO, _policy) {
+}
+
+FileLogSink::FileLogSink(std::string _path, FlushPolicy _policy)
+    : FdLogSink(openFile(_path, false), _policy, true), m_path(std::move(_path)) {
+    if (m_fd < 0) {
+        throw UserException("Cannot open the log file", m_path, __PRETTY_FUNCTION__);
+    }
+}
+
+const std::string &FileLogSink::path() const noexcept {
+    return m_path;
+}
+
+int FileLogSink::openFile(const std::string &_path, bool _truncate) noexcept {
+    return ::open(_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (_truncate ? O_TRUNC : 0), 0644);
+}
+
+RotatingFileLogSink::RotatingFileLogSink(std::string _path, std::size_t _maxFileSize, std::size_t _maxFiles, FlushPolicy _policy)
+    : FileLogSink(std::move(_path), _policy), m_maxFileSize(_maxFileSize), m_maxFiles(_maxFiles), m_fileSize(0) {
+    struct stat status {};
+    if (::fstat(m_fd, &status) == 0) {
+        m_fileSize = static_cast<std::size_t>(status.st_size);
+    }
+}
+
+void RotatingFileLogSink::onWritten(std::size_t _bytes) {
+    m_fileSize += _bytes;
+    if (m_fileSize >= m_maxFileSize) {
+        rotate();
+    }
+}
+
+void RotatingFileLogSink::rotate() {
+    // if a step fails, the records go on to the current descriptor and the next write retries the step.
+    if (m_maxFiles == 0) {
+        if (const auto fd = openFile(m_path, true); fd >= 0) {
+            replaceFd(fd);
+            m_fileSize = 0;
+        }
+        return;
+    }
+
+    if (m_rotatedPath.empty()) {
+        m_rotatedPath = rotateFiles(m_path, m_maxFiles);
+        if (m_rotatedPath.empty()) {
+            return;
+        }
+    }
+
+    const auto fd = openFile(m_path, false);
+    if (fd < 0) {
+        return;
+    }
+
+    replaceFd(fd);
+    m_fileSize = 0;
+    onRotated(std::exchange(m_rotatedPath, std::string()));
+}
+
+std::string RotatingFileLogSink::rotateFiles(const std::string &_path, std::size_t _maxFiles) {
+    std::lock_guard lock(rotationMutex());
+
+    for (auto index = _maxFiles; index > 1; --index) {
+        const auto from = _path + '.' + std::to_string(index - 1);
+        const auto to = _path + '.' + std::to_string(index);
+        if (!fileExists(from) && !fileExists(from + LogCompression::FileSuffix)) {
+            continue;
+        }
+
+        if (!shiftFile(from, to) ||
+            !shiftFile(from + LogCompression::FileSuffix, to + LogCompression::FileSuffix)) {
+            return std::string();
+        }
+    }
+
+    auto rotatedPath = _path + ".1";
+    if (std::rename(_path.c_str(), rotatedPath.c_str()) != 0) {
+        return std::string();
+    }
+    std::remove((rotatedPath + LogCompression::FileSuffix).c_str());
+
+    return rotatedPath;
+}
+
+std::mutex &RotatingFileLogSink::rotationMutex() noexcept {
+    static std::mutex mutex;
+    return mutex;
+}
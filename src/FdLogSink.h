@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include "LogSink.h"
+
+/*!
+ * @brief FdLogSink writes the records to a file descriptor. The kept records and the record which triggered
+ * the write go out by one writev call, without the iostream locking and buffering.
+ */
+class FdLogSink : public BufferedLogSink {
+public:
+    /*!
+     * @brief Construct a new FdLogSink object.
+     * @param _fd - file descriptor.
+     * @param _policy - flush policy.
+     * @param _ownsFd - the sink closes the descriptor.
+     */
+    explicit FdLogSink(int _fd, FlushPolicy _policy = FlushPolicy{}, bool _ownsFd = false);
+
+    /*!
+     * @brief Destroy the FdLogSink object, the kept records are written.
+     */
+    ~FdLogSink() override;
+
+    FdLogSink(const FdLogSink &) = delete;
+    FdLogSink &operator=(const FdLogSink &) = delete;
+
+protected:
+    void writeOutput(const std::string_view *_parts, std::size_t _count) override;
+
+    /*!
+     * @brief Called under the sink lock after the bytes are written.
+     * @param _bytes - number of written bytes.
+     */
+    virtual void onWritten([[maybe_unused]] std::size_t _bytes) {}
+
+    /*!
+     * @brief Closes the owned descriptor and uses the new one. Called under the sink lock.
+     */
+    void replaceFd(int _fd) noexcept;
+
+    /*!
+     * @brief File descriptor.
+     */
+    int m_fd;
+
+private:
+    /*!
+     * @brief The sink closes the descriptor.
+     */
+    bool m_ownsFd;
+};
+
+/*!
+ * @brief StdoutLogSink writes the records to the standard output.
+ */
+class StdoutLogSink final : public FdLogSink {
+public:
+    /*!
+     * @brief Construct a new StdoutLogSink object.
+     * @param _policy - flush policy, by default every record is written at once.
+     */
+    explicit StdoutLogSink(FlushPolicy _policy = FlushPolicy{0});
+};
+
+/*!
+ * @brief StderrLogSink writes the records to the standard error. It is the default sink of LogHelper.
+ */
+class StderrLogSink final : public FdLogSink {
+public:
+    /*!
+     * @brief Construct a new StderrLogSink object.
+     * @param _policy - flush policy, by default every record is written at once.
+     */
+    explicit StderrLogSink(FlushPolicy _policy = FlushPolicy{0});
+};
+
+/*!
+ * @brief FileLogSink appends the records to a file.
+ */
+class FileLogSink : public FdLogSink {
+public:
+    /*!
+     * @brief Construct a new FileLogSink object, the file is created if it does not exist.
+     * @param _path - file path.
+     * @param _policy - flush policy.
+     * @throw UserException - if the file cannot be opened.
+     */
+    explicit FileLogSink(std::string _path, FlushPolicy _policy = FlushPolicy{});
+
+    /*!
+     * @brief Returns the file path.
+     */
+    [[nodiscard]]
+    const std::string &path() const noexcept;
+
+protected:
+    /*!
+     * @brief Opens the file for appending.
+     * @param _path - file path.
+     * @param _truncate - the file content is removed.
+     * @return File descriptor or -1.
+     */
+    static int openFile(const std::string &_path, bool _truncate) noexcept;
+
+    /*!
+     * @brief File path.
+     */
+    const std::string m_path;
+};
+
+/*!
+ * @brief RotatingFileLogSink starts a new file when the current one reaches the size limit.
+ * The full file is renamed to "path.1", the older files are shifted to "path.2" ... "path.<maxFiles>",
+ * the oldest one is removed. A rotated file compressed by LogCompressor keeps its place as "path.<n>.lz".
+ */
+class RotatingFileLogSink : public FileLogSink {
+public:
+    /*!
+     * @brief Construct a new RotatingFileLogSink object.
+     * @param _path - file path.
+     * @param _maxFileSize - the file size which triggers the rotation.
+     * @param _maxFiles - number of the rotated files kept, 0 truncates the current file instead.
+     * @param _policy - flush policy.
+     * @throw UserException - if the file cannot be opened.
+     */
+    RotatingFileLogSink(std::string _path, std::size_t _maxFileSize, std::size_t _maxFiles, FlushPolicy _policy = FlushPolicy{});
+
+    /*!
+     * @brief Shifts the rotated files, plain or compressed, and renames the file to "path.1".
+     * It stops at the first failed rename, so no file is overwritten, and the rotation may be retried.
+     * @param _path - file path.
+     * @param _maxFiles - number of the rotated files kept, at least 1.
+     * @return The new path of the file or an empty string if a rename failed.
+     */
+    static std::string rotateFiles(const std::string &_path, std::size_t _maxFiles);
+
+    /*!
+     * @brief Guards the renames of the rotated files, LogCompressor replaces a rotated file under it.
+     */
+    static std::mutex &rotationMutex() noexcept;
+
+protected:
+    void onWritten(std::size_t _bytes) override;
+
+    /*!
+     * @brief Called under the sink lock after the full file has been renamed.
+     * @param _rotatedPath - the new path of the full file.
+     */
+    virtual void onRotated([[maybe_unused]] const std::string &_rotatedPath) {}
+
+private:
+    /*!
+     * @brief Renames the files and opens the new one. If a rename or the open fails, the current descriptor is kept
+     * and the next write retries.
+     */
+    void rotate();
+
+    /*!
+     * @brief The file size which triggers the rotation.
+     */
+    const std::size_t m_maxFileSize;
+    /*!
+     * @brief Number of the rotated files kept.
+     */
+    const std::size_t m_maxFiles;
+    /*!
+     * @brief The size of the current file.
+     */
+    std::size_t m_fileSize;
+    /*!
+     * @brief The path the current file has been renamed to, while the new file cannot be opened.
+     */
+    std::string m_rotatedPath;
+};
@@ -0,0 +1,442 @@
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <unistd.h>
+
+namespace {
+/*!
+ * @brief The header of a recorded record, the record chars follow it.
+ */
+struct EntryHeader {
+    std::uint32_t size;
+    std::uint8_t level;
+    std::uint8_t binary;
+    std::uint16_t reserved;
+};
+
+/*!
+ * @brief The circular buffer of a thread. The positions grow monotonically, the offset of a position is the position
+ * modulo the capacity. The owner thread records under the spin lock, the dumps take the records under it.
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(std::size_t _capacity) : data(std::make_unique<char[]>(_capacity)), capacity(_capacity) {}
+
+    void lock() noexcept {
+        while (busy.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    [[nodiscard]]
+    bool tryLock() noexcept {
+        return !busy.test_and_set(std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        busy.clear(std::memory_order_release);
+    }
+
+    /*!
+     * @brief Copies the bytes to the position, wrapping around the end of the buffer.
+     */
+    void copyIn(std::uint64_t _position, const void *_bytes, std::size_t _size) noexcept {
+        const auto offset = static_cast<std::size_t>(_position % capacity);
+        const auto first = std::min(_size, capacity - offset);
+        std::memcpy(data.get() + offset, _bytes, first);
+        std::memcpy(data.get(), static_cast<const char *>(_bytes) + first, _size - first);
+    }
+
+    /*!
+     * @brief Copies the bytes from the position, wrapping around the end of the buffer.
+     */
+    void copyOut(std::uint64_t _position, void *_bytes, std::size_t _size) const noexcept {
+        const auto offset = static_cast<std::size_t>(_position % capacity);
+        const auto first = std::min(_size, capacity - offset);
+        std::memcpy(_bytes, data.get() + offset, first);
+        std::memcpy(static_cast<char *>(_bytes) + first, data.get(), _size - first);
+    }
+
+    /*!
+     * @brief Moves the recorded entries into the string and empties the buffer.
+     */
+    std::string take() {
+        std::string entries;
+        lock();
+        try {
+            entries.resize(static_cast<std::size_t>(head - tail));
+        } catch (...) {
+            unlock();
+            throw;
+        }
+        copyOut(tail, entries.data(), entries.size());
+        tail = head;
+        count = 0;
+        unlock();
+
+        return entries;
+    }
+
+    /*!
+     * @brief Moves the newest entries which fit into a new buffer of the capacity, the older ones are dropped.
+     */
+    void resize(std::size_t _capacity) {
+        auto resized = std::make_unique<char[]>(_capacity);
+
+        lock();
+        while (head - tail > _capacity) {
+            EntryHeader oldest;
+            copyOut(tail, &oldest, sizeof(oldest));
+            tail += sizeof(oldest) + oldest.size;
+            --count;
+        }
+        copyOut(tail, resized.get(), static_cast<std::size_t>(head - tail));
+        head -= tail;
+        tail = 0;
+        data.swap(resized);
+        capacity = _capacity;
+        unlock();
+    }
+
+    std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    std::unique_ptr<char[]> data;
+    std::size_t capacity;
+    //! The position of the next entry.
+    std::uint64_t head = 0;
+    //! The position of the oldest entry.
+    std::uint64_t tail = 0;
+    //! The number of the entries.
+    std::size_t count = 0;
+};
+
+std::atomic<FlightRecorder::Output> g_output{nullptr};
+std::atomic<bool> g_dumpOnException{false};
+std::atomic<std::size_t> g_threadCapacity{FlightRecorder::Options{}.threadCapacity};
+
+/*!
+ * @brief The descriptor of the dump written by the fatal signal handler.
+ */
+std::atomic<int> g_signalFd{STDERR_FILENO};
+
+/*!
+ * @brief Guards g_buffers; the buffers are unregistered under it, so a dump never sees a destroyed buffer.
+ */
+std::mutex g_registryMutex;
+
+/*!
+ * @brief The buffers of the running threads.
+ */
+std::vector<ThreadBuffer *> g_buffers;
+
+/*!
+ * @brief The buffers seen by the fatal signal handler, which cannot lock g_registryMutex.
+ */
+std::array<std::atomic<ThreadBuffer *>, FlightRecorder::MaxSignalThreads> g_signalBuffers{};
+
+/*!
+ * @brief Set while a signal handler writes the buffer of the slot; the thread of the buffer frees it once clear.
+ * The buffer lock cannot do it, the handler would lock a freed buffer.
+ */
+std::array<std::atomic<bool>, FlightRecorder::MaxSignalThreads> g_signalBuffersBusy{};
+
+//! The signals handled by installSignalHandlers().
+constexpr std::array<int, 5> FatalSignals{SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+/*!
+ * @brief The actions replaced by installSignalHandlers(), by the index in FatalSignals.
+ */
+std::array<struct sigaction, FatalSignals.size()> g_previousActions{};
+
+/*!
+ * @brief The buffer of the thread has been destroyed, the records of later thread_local destructors are not recorded.
+ */
+thread_local bool t_bufferDestroyed = false;
+
+/*!
+ * @brief Registers the buffer of the thread and unregisters it when the thread finishes.
+ */
+struct ThreadBufferHolder {
+    ~ThreadBufferHolder() {
+        t_bufferDestroyed = true;
+        if (buffer == nullptr) {
+            return;
+        }
+
+        std::lock_guard lock(g_registryMutex);
+        g_buffers.erase(std::find(g_buffers.begin(), g_buffers.end(), buffer.get()));
+        if (signalSlot < g_signalBuffers.size()) {
+            // seq_cst: a handler either sees the cleared slot or has set the busy flag seen below.
+            g_signalBuffers[signalSlot].store(nullptr, std::memory_order_seq_cst);
+            while (g_signalBuffersBusy[signalSlot].load(std::memory_order_seq_cst)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::unique_ptr<ThreadBuffer> buffer;
+    //! The index of the buffer in g_signalBuffers or MaxSignalThreads if all slots are taken.
+    std::size_t signalSlot = FlightRecorder::MaxSignalThreads;
+};
+
+/*!
+ * @brief Returns the buffer of the thread, creating it if _create is true, or nullptr.
+ */
+ThreadBuffer *threadBuffer(bool _create) {
+    if (t_bufferDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadBufferHolder holder;
+    if (holder.buffer == nullptr && _create) {
+        auto buffer = std::make_unique<ThreadBuffer>(g_threadCapacity.load(std::memory_order_relaxed));
+
+        std::lock_guard lock(g_registryMutex);
+        g_buffers.push_back(buffer.get());
+        for (std::size_t index = 0; index < g_signalBuffers.size(); ++index) {
+            ThreadBuffer *expected = nullptr;
+            if (g_signalBuffers[index].compare_exchange_strong(expected, buffer.get())) {
+                holder.signalSlot = index;
+                break;
+            }
+        }
+        holder.buffer = std::move(buffer);
+    }
+
+    return holder.buffer.get();
+}
+
+/*!
+ * @brief Passes the entries taken from a buffer to the output.
+ */
+void writeEntries(std::string_view _entries, FlightRecorder::Output _output) {
+    while (_entries.size() >= sizeof(EntryHeader)) {
+        EntryHeader header;
+        std::memcpy(&header, _entries.data(), sizeof(header));
+        _entries.remove_prefix(sizeof(header));
+
+        _output(_entries.substr(0, header.size), static_cast<LogLevel>(header.level), header.binary != 0);
+        _entries.remove_prefix(std::min<std::size_t>(header.size, _entries.size()));
+    }
+}
+
+/*!
+ * @brief Writes all bytes by write(2), it is async-signal-safe.
+ */
+void writeAll(int _fd, const char *_bytes, std::size_t _size) noexcept {
+    while (_size > 0) {
+        const auto written = ::write(_fd, _bytes, _size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        _bytes += written;
+        _size -= static_cast<std::size_t>(written);
+    }
+}
+
+/*!
+ * @brief Writes the text entries of the buffer, the caller holds its lock.
+ */
+void writeEntriesSignalSafe(int _fd, const ThreadBuffer &_buffer) noexcept {
+    for (auto position = _buffer.tail; position + sizeof(EntryHeader) <= _buffer.head;) {
+        EntryHeader header;
+        _buffer.copyOut(position, &header, sizeof(header));
+        position += sizeof(header);
+        if (header.size > _buffer.head - position) {
+            return;
+        }
+
+        if (header.binary == 0) {
+            const auto offset = static_cast<std::size_t>(position % _buffer.capacity);
+            const auto first = std::min<std::size_t>(header.size, _buffer.capacity - offset);
+            writeAll(_fd, _buffer.data.get() + offset, first);
+            writeAll(_fd, _buffer.data.get(), header.size - first);
+            writeAll(_fd, "\n", 1);
+        }
+        position += header.size;
+    }
+}
+
+void fatalSignalHandler(int _signal) {
+    FlightRecorder::dumpSignalSafe(g_signalFd.load(std::memory_order_relaxed));
+
+    // the replaced action handles the signal, it is delivered when the handler returns. SA_RESETHAND has restored
+    // the default action, which is kept if the signal is unknown.
+    for (std::size_t index = 0; index < FatalSignals.size(); ++index) {
+        if (FatalSignals[index] == _signal) {
+            ::sigaction(_signal, &g_previousActions[index], nullptr);
+            break;
+        }
+    }
+    ::raise(_signal);
+}
+}  // namespace
+
+void FlightRecorder::enable(const Options &_options, Output _output) {
+    g_output.store(_output, std::memory_order_relaxed);
+    g_dumpOnException.store(_options.dumpOnException, std::memory_order_relaxed);
+    const auto capacity = std::max<std::size_t>(_options.threadCapacity, 1024);
+    {
+        std::lock_guard lock(g_registryMutex);
+        g_threadCapacity.store(capacity, std::memory_order_relaxed);
+        for (auto *buffer : g_buffers) {
+            if (buffer->capacity != capacity) {
+                buffer->resize(capacity);
+            }
+        }
+    }
+    s_sinkLevel.store(_options.sinkLevel, std::memory_order_relaxed);
+    s_dumpLevel.store(_options.dumpLevel, std::memory_order_relaxed);
+    s_enabled.store(true, std::memory_order_release);
+}
+
+void FlightRecorder::disable() noexcept {
+    s_enabled.store(false, std::memory_order_release);
+}
+
+void FlightRecorder::record(std::string_view _record, LogLevel _level, bool _binary) noexcept {
+    ThreadBuffer *buffer = nullptr;
+    try {
+        buffer = threadBuffer(true);
+    } catch (...) {
+    }
+    if (buffer == nullptr) {
+        return;
+    }
+
+    const EntryHeader header{static_cast<std::uint32_t>(_record.size()), static_cast<std::uint8_t>(_level),
+                             static_cast<std::uint8_t>(_binary), 0};
+    const auto size = sizeof(header) + _record.size();
+
+    buffer->lock();
+    // the capacity is changed by enable() under the lock.
+    if (size > buffer->capacity) {
+        buffer->unlock();
+        return;
+    }
+
+    // the oldest entries are overwritten.
+    while (buffer->head + size - buffer->tail > buffer->capacity) {
+        EntryHeader oldest;
+        buffer->copyOut(buffer->tail, &oldest, sizeof(oldest));
+        buffer->tail += sizeof(oldest) + oldest.size;
+        --buffer->count;
+    }
+
+    buffer->copyIn(buffer->head, &header, sizeof(header));
+    buffer->copyIn(buffer->head + sizeof(header), _record.data(), _record.size());
+    buffer->head += size;
+    ++buffer->count;
+    buffer->unlock();
+}
+
+void FlightRecorder::dumpThread() {
+    const auto output = g_output.load(std::memory_order_relaxed);
+    auto *buffer = threadBuffer(false);
+    if (output == nullptr || buffer == nullptr) {
+        return;
+    }
+
+    writeEntries(buffer->take(), output);
+}
+
+void FlightRecorder::dump() {
+    const auto output = g_output.load(std::memory_order_relaxed);
+    if (output == nullptr) {
+        return;
+    }
+
+    std::vector<std::string> entries;
+    {
+        std::lock_guard lock(g_registryMutex);
+        entries.reserve(g_buffers.size());
+        for (auto *buffer : g_buffers) {
+            entries.push_back(buffer->take());
+        }
+    }
+
+    for (const auto &threadEntries : entries) {
+        writeEntries(threadEntries, output);
+    }
+}
+
+void FlightRecorder::onException() noexcept {
+    if (!isEnabled() || !g_dumpOnException.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    try {
+        dumpThread();
+    } catch (...) {
+    }
+}
+
+void FlightRecorder::dumpSignalSafe(int _fd) noexcept {
+    static constexpr char title[] = "--- flight recorder ---\n";
+    writeAll(_fd, title, sizeof(title) - 1);
+
+    for (std::size_t index = 0; index < g_signalBuffers.size(); ++index) {
+        // a dump on another thread writes the buffer.
+        if (g_signalBuffersBusy[index].exchange(true, std::memory_order_seq_cst)) {
+            continue;
+        }
+
+        auto *buffer = g_signalBuffers[index].load(std::memory_order_seq_cst);
+        if (buffer != nullptr && buffer->tryLock()) {
+            writeEntriesSignalSafe(_fd, *buffer);
+            buffer->unlock();
+        }
+        g_signalBuffersBusy[index].store(false, std::memory_order_seq_cst);
+    }
+}
+
+bool FlightRecorder::installSignalHandlers(int _fd) noexcept {
+    g_signalFd.store(_fd, std::memory_order_relaxed);
+
+    struct sigaction action{};
+    action.sa_handler = &fatalSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESETHAND;
+
+    bool installed = true;
+    for (std::size_t index = 0; index < FatalSignals.size(); ++index) {
+        struct sigaction previous{};
+        if (::sigaction(FatalSignals[index], &action, &previous) != 0) {
+            installed = false;
+            continue;
+        }
+
+        // installed again, the action replaced the first time is kept.
+        if (previous.sa_handler != &fatalSignalHandler || (previous.sa_flags & SA_SIGINFO) != 0) {
+            g_previousActions[index] = previous;
+        }
+    }
+
+    return installed;
+}
+
+std::size_t FlightRecorder::threadRecordCount() noexcept {
+    auto *buffer = threadBuffer(false);
+    if (buffer == nullptr) {
+        return 0;
+    }
+
+    buffer->lock();
+    const auto count = buffer->count;
+    buffer->unlock();
+
+    return count;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+
+#include "LogLevel.h"
+
+/*!
+ * @brief FlightRecorder keeps the recent records of the less severe levels in a circular memory buffer per thread
+ * instead of writing them, the oldest records are overwritten. The buffers are dumped to the output when a severe
+ * record is logged, when UserException is constructed (optional), on dump() or by the fatal signal handler.
+ * A record costs one copy into the buffer of the thread under an uncontended spin lock, without I/O.
+ * LogHelper::enableFlightRecorder() enables it with the output of the current logging mode.
+ */
+class FlightRecorder {
+public:
+    /*!
+     * @brief The options of the recorder.
+     */
+    struct Options {
+        //! The records of this and the more severe levels are written as usual, the less severe ones are only recorded.
+        LogLevel sinkLevel = LogLevel::Warning;
+        //! A record of this or a more severe level dumps the buffer of its thread before it is written.
+        LogLevel dumpLevel = LogLevel::Error;
+        //! The UserException constructor dumps the buffer of its thread.
+        bool dumpOnException = false;
+        //! The size of the buffer of a thread, it is allocated by the first record of the thread or resized by enable().
+        std::size_t threadCapacity = 64 * 1024;
+    };
+
+    /*!
+     * @brief Writes a dumped record.
+     * @param _record - the record.
+     * @param _level - the level of the record.
+     * @param _binary - the record is a binary record of BinaryLogFormat.
+     */
+    using Output = void (*)(std::string_view _record, LogLevel _level, bool _binary);
+
+    /*!
+     * @brief The maximum number of the threads whose buffers the fatal signal handler dumps.
+     */
+    static constexpr std::size_t MaxSignalThreads = 256;
+
+    /*!
+     * @brief Enables the recorder. The buffers of the threads keep the recorded records.
+     * @param _options - the options. The existing buffers of another capacity are reallocated, they keep
+     * the newest records which fit.
+     * @param _output - the output of the dumped records.
+     */
+    static void enable(const Options &_options, Output _output);
+
+    /*!
+     * @brief Disables the recorder, the recorded records are kept until the next dump.
+     */
+    static void disable() noexcept;
+
+    /*!
+     * @brief Returns true if the recorder is enabled.
+     */
+    [[nodiscard]]
+    static bool isEnabled() noexcept {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief Returns true if the record of the level is only recorded.
+     */
+    [[nodiscard]]
+    static bool records(LogLevel _level) noexcept {
+        return isEnabled() && _level > s_sinkLevel.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief Returns true if the record of the level dumps the buffer of its thread.
+     */
+    [[nodiscard]]
+    static bool dumpsBefore(LogLevel _level) noexcept {
+        return isEnabled() && _level <= s_dumpLevel.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief Copies the record into the buffer of the thread. A record larger than the buffer is dropped.
+     * @param _binary - the record is a binary record of BinaryLogFormat.
+     */
+    static void record(std::string_view _record, LogLevel _level, bool _binary) noexcept;
+
+    /*!
+     * @brief Writes the records of the thread to the output, oldest first, and empties the buffer.
+     */
+    static void dumpThread();
+
+    /*!
+     * @brief Writes the records of all threads to the output and empties the buffers.
+     */
+    static void dump();
+
+    /*!
+     * @brief Called by the UserException constructor, dumps the buffer of the thread if Options::dumpOnException is set.
+     */
+    static void onException() noexcept;
+
+    /*!
+     * @brief Writes the text records of all threads to the descriptor by write(2) only, so it may be called
+     * from a signal handler. The binary records and the buffers locked by the interrupted code are skipped.
+     */
+    static void dumpSignalSafe(int _fd) noexcept;
+
+    /*!
+     * @brief Installs the handler of SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT, which calls dumpSignalSafe(),
+     * restores the replaced action and raises the signal again, so a handler installed before, e.g. by a crash
+     * reporter, still runs.
+     * @param _fd - the descriptor of the dump.
+     * @return false if a handler cannot be installed.
+     */
+    static bool installSignalHandlers(int _fd = 2) noexcept;
+
+    /*!
+     * @brief Returns the number of the records recorded by the thread and not dumped yet.
+     */
+    [[nodiscard]]
+    static std::size_t threadRecordCount() noexcept;
+
+private:
+    /*!
+     * @brief The state read by every record.
+     */
+    inline static std::atomic<bool> s_enabled{false};
+    inline static std::atomic<LogLevel> s_sinkLevel{LogLevel::Warning};
+    inline static std::atomic<LogLevel> s_dumpLevel{LogLevel::Error};
+};
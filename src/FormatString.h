@@ -0,0 +1,408 @@
+#pragma once
+
+#include "CharFastStackBuffer.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*!
+ * @brief The alignment of the formatted argument within its width.
+ */
+enum class FormatAlign : char {
+    //! The numbers are aligned to the right, the other values to the left.
+    Default,
+    Left,
+    Right,
+    Center
+};
+
+/*!
+ * @brief The parsed replacement field "{:[[fill]align][0][width][.precision][type]}".
+ */
+struct FormatSpec {
+    char fill = ' ';
+    FormatAlign align = FormatAlign::Default;
+    //! Pad the number with zeros after the sign.
+    bool zeroPad = false;
+    std::size_t width = 0;
+    //! The number of the decimals of the floating point value or the maximum size of the string, -1 if it is not set.
+    int precision = -1;
+    //! 'd', 'x', 'X', 'f', 'e', 'g', 's', 'c', 'p' or 0 if it is not set.
+    char type = 0;
+};
+
+/*!
+ * @brief A literal segment of the format string followed by a replacement field or by nothing.
+ */
+struct FormatSegment {
+    std::size_t literalBegin = 0;
+    std::size_t literalSize = 0;
+    bool hasArgument = false;
+    FormatSpec spec;
+};
+
+/*!
+ * @brief The error of the format string.
+ */
+enum class FormatError {
+    None,
+    //! A '{' without the closing '}' or a single '}'.
+    UnmatchedBrace,
+    //! The spec of a replacement field cannot be parsed.
+    InvalidSpec
+};
+
+/*!
+ * @brief The format string parsed at compile time.
+ * @tparam N - the maximum number of the segments.
+ */
+template<std::size_t N>
+struct ParsedFormat {
+    std::array<FormatSegment, N> segments{};
+    std::size_t segmentCount = 0;
+    std::size_t argumentCount = 0;
+    //! The total size of the literal segments.
+    std::size_t literalSize = 0;
+    FormatError error = FormatError::None;
+};
+
+/*!
+ * @brief Parses the format string at compile time. "{{" and "}}" are the escaped braces.
+ */
+template<std::size_t N>
+constexpr ParsedFormat<N> parseFormat(std::string_view _format) noexcept {
+    ParsedFormat<N> parsed;
+    const auto isDigit = [](char _c) { return _c >= '0' && _c <= '9'; };
+    const auto isAlign = [](char _c) { return _c == '<' || _c == '>' || _c == '^'; };
+    const auto toAlign = [](char _c) {
+        return _c == '<' ? FormatAlign::Left : (_c == '>' ? FormatAlign::Right : FormatAlign::Center);
+    };
+
+    std::size_t literalBegin = 0;
+    std::size_t i = 0;
+    const auto addSegment = [&parsed](std::size_t _begin, std::size_t _end, bool _hasArgument, FormatSpec _spec) {
+        auto &segment = parsed.segments[parsed.segmentCount++];
+        segment.literalBegin = _begin;
+        segment.literalSize = _end - _begin;
+        segment.hasArgument = _hasArgument;
+        segment.spec = _spec;
+        parsed.literalSize += _end - _begin;
+        parsed.argumentCount += _hasArgument ? 1 : 0;
+    };
+
+    while (i < _format.size()) {
+        const auto c = _format[i];
+        if (c == '}') {
+            if (i + 1 >= _format.size() || _format[i + 1] != '}') {
+                parsed.error = FormatError::UnmatchedBrace;
+                return parsed;
+            }
+
+            // the literal ends with the first brace, the second one is skipped.
+            addSegment(literalBegin, i + 1, false, FormatSpec());
+            i += 2;
+            literalBegin = i;
+            continue;
+        }
+
+        if (c != '{') {
+            ++i;
+            continue;
+        }
+
+        if (i + 1 < _format.size() && _format[i + 1] == '{') {
+            addSegment(literalBegin, i + 1, false, FormatSpec());
+            i += 2;
+            literalBegin = i;
+            continue;
+        }
+
+        const auto literalEnd = i;
+        ++i;
+        FormatSpec spec;
+        if (i < _format.size() && _format[i] == ':') {
+            ++i;
+            if (i + 1 < _format.size() && isAlign(_format[i + 1]) && _format[i] != '{' && _format[i] != '}') {
+                spec.fill = _format[i];
+                spec.align = toAlign(_format[i + 1]);
+                i += 2;
+            } else if (i < _format.size() && isAlign(_format[i])) {
+                spec.align = toAlign(_format[i]);
+                ++i;
+            }
+
+            if (i < _format.size() && _format[i] == '0') {
+                spec.zeroPad = true;
+                ++i;
+            }
+
+            while (i < _format.size() && isDigit(_format[i])) {
+                spec.width = spec.width * 10 + static_cast<std::size_t>(_format[i] - '0');
+                ++i;
+            }
+
+            if (i < _format.size() && _format[i] == '.') {
+                ++i;
+                if (i >= _format.size() || !isDigit(_format[i])) {
+                    parsed.error = FormatError::InvalidSpec;
+                    return parsed;
+                }
+
+                spec.precision = 0;
+                while (i < _format.size() && isDigit(_format[i])) {
+                    spec.precision = spec.precision * 10 + (_format[i] - '0');
+                    ++i;
+                }
+            }
+
+            if (i < _format.size() && _format[i] != '}') {
+                constexpr std::string_view types = "dxXfegscp";
+                if (types.find(_format[i]) == std::string_view::npos) {
+                    parsed.error = FormatError::InvalidSpec;
+                    return parsed;
+                }
+
+                spec.type = _format[i];
+                ++i;
+            }
+        }
+
+        if (i >= _format.size()) {
+            parsed.error = FormatError::UnmatchedBrace;
+            return parsed;
+        }
+        if (_format[i] != '}') {
+            parsed.error = FormatError::InvalidSpec;
+            return parsed;
+        }
+
+        addSegment(literalBegin, literalEnd, true, spec);
+        ++i;
+        literalBegin = i;
+    }
+
+    if (literalBegin < _format.size()) {
+        addSegment(literalBegin, _format.size(), false, FormatSpec());
+    }
+
+    return parsed;
+}
+
+/*!
+ * @brief FormatString is the format string checked at compile time, it is created by STDCORE_FMT.
+ * @tparam Literal_t - the type with static constexpr std::string_view value().
+ */
+template<class Literal_t>
+struct FormatString {
+    static constexpr std::string_view Format = Literal_t::value();
+    static constexpr auto Parsed = parseFormat<Format.size() + 1>(Format);
+
+    static_assert(Parsed.error != FormatError::UnmatchedBrace, "unmatched brace in the format string");
+    static_assert(Parsed.error != FormatError::InvalidSpec, "invalid replacement field in the format string");
+
+    //! The number of the replacement fields.
+    static constexpr std::size_t ArgumentCount = Parsed.argumentCount;
+    //! The number of the chars written besides the arguments.
+    static constexpr std::size_t LiteralSize = Parsed.literalSize;
+};
+
+/*!
+ * @brief Returns the FormatString of the string literal, e.g. STDCORE_FMT("{} took {:.2f} ms").
+ */
+#define STDCORE_FMT(_format)                                                      \
+    [] {                                                                          \
+        struct FormatLiteral {                                                    \
+            static constexpr std::string_view value() { return _format; }        \
+        };                                                                        \
+        return FormatString<FormatLiteral>();                                     \
+    }()
+
+/*!
+ * @brief FormatArgs is the format string with the arguments, see formatArgs(). It refers to the arguments,
+ * so it must be written in the statement which creates it.
+ */
+template<class Literal_t, class... Args_t>
+struct FormatArgs {
+    std::tuple<const Args_t &...> args;
+};
+
+/*!
+ * @brief Returns the format string with the arguments, e.g. STDCORE_LOG_ERROR << formatArgs(STDCORE_FMT("{:>8}|"), name);
+ */
+template<class Literal_t, class... Args_t>
+constexpr FormatArgs<Literal_t, Args_t...> formatArgs(FormatString<Literal_t>, const Args_t &..._args) noexcept {
+    return {std::tuple<const Args_t &...>(_args...)};
+}
+
+namespace format_detail {
+template<class T>
+inline constexpr bool IsString_v = std::is_convertible_v<const T &, std::string_view>;
+
+template<class T>
+inline constexpr bool IsNumber_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>;
+
+/*!
+ * @brief Writes the argument without the padding. The spec is checked against the type at compile time.
+ */
+template<class Format_t, std::size_t I, std::size_t N, class P, class T>
+void writeValue(CharFastStackBuffer<char, N, P> &_buffer, const T &_value) {
+    constexpr auto Spec = Format_t::Parsed.segments[I].spec;
+    constexpr auto type = Spec.type;
+    static_assert(Spec.precision < 0 || std::is_floating_point_v<T> || IsString_v<T>,
+                  "the precision needs a floating point or a string argument");
+    static_assert(!Spec.zeroPad || IsNumber_v<T>, "the zero padding needs a number argument");
+
+    if constexpr (std::is_same_v<T, bool>) {
+        static_assert(type == 0 || type == 's', "a bool argument takes the 's' type only");
+        _buffer << _value;
+    } else if constexpr (std::is_same_v<T, char>) {
+        static_assert(type == 0 || type == 'c', "a char argument takes the 'c' type only");
+        _buffer << _value;
+    } else if constexpr (std::is_integral_v<T>) {
+        static_assert(type == 0 || type == 'd' || type == 'x' || type == 'X', "an integer argument takes the 'd', 'x' and 'X' types only");
+        if constexpr (type == 'x' || type == 'X') {
+            const auto start = static_cast<std::size_t>(_buffer.size());
+            _buffer << hexFormat(_value);
+            if constexpr (type == 'X') {
+                std::transform(_buffer.data() + start, _buffer.data() + _buffer.size(), _buffer.data() + start, [](char _c) {
+                    return _c >= 'a' && _c <= 'f' ? static_cast<char>(_c - 'a' + 'A') : _c;
+                });
+            }
+        } else {
+            _buffer << _value;
+        }
+    } else if constexpr (std::is_floating_point_v<T>) {
+        static_assert(type == 0 || type == 'f' || type == 'e' || type == 'g', "a floating point argument takes the 'f', 'e' and 'g' types only");
+        if constexpr (type == 0 && Spec.precision < 0) {
+            _buffer << _value;
+        } else {
+            constexpr auto format = type == 'f' ? std::chars_format::fixed
+                                                : (type == 'e' ? std::chars_format::scientific : std::chars_format::general);
+            constexpr auto precision = Spec.precision < 0 ? 6 : Spec.precision;
+            _buffer.appendFormatted([&_value](char *_first, char *_last) {
+                return std::to_chars(_first, _last, _value, format, precision);
+            });
+        }
+    } else if constexpr (IsString_v<T>) {
+        static_assert(type == 0 || type == 's', "a string argument takes the 's' type only");
+        std::string_view view(_value);
+        if constexpr (Spec.precision >= 0) {
+            view = view.substr(0, static_cast<std::size_t>(Spec.precision));
+        }
+        _buffer << view;
+    } else if constexpr (std::is_pointer_v<T>) {
+        static_assert(type == 0 || type == 'p', "a pointer argument takes the 'p' type only");
+        _buffer << static_cast<const void *>(_value);
+    } else {
+        static_assert(IsBufferFormattable_v<T>, "the argument type is not formattable by CharFastStackBuffer");
+        static_assert(type == 0, "the argument type takes no type");
+        _buffer << _value;
+    }
+}
+
+/*!
+ * @brief Writes the argument and pads it to the width of the spec.
+ */
+template<class Format_t, std::size_t I, std::size_t N, class P, class T>
+void writeArgument(CharFastStackBuffer<char, N, P> &_buffer, const T &_value) {
+    constexpr auto Spec = Format_t::Parsed.segments[I].spec;
+    if constexpr (Spec.width == 0) {
+        writeValue<Format_t, I>(_buffer, _value);
+    } else {
+        const auto start = static_cast<std::size_t>(_buffer.size());
+        writeValue<Format_t, I>(_buffer, _value);
+        const auto size = static_cast<std::size_t>(_buffer.size()) - start;
+        if (size >= Spec.width) {
+            return;
+        }
+
+        constexpr auto align = Spec.align != FormatAlign::Default ? Spec.align : (IsNumber_v<T> || Spec.zeroPad ? FormatAlign::Right : FormatAlign::Left);
+        const auto padding = Spec.width - size;
+        const auto before = align == FormatAlign::Right ? padding : (align == FormatAlign::Center ? padding / 2 : 0);
+        for (std::size_t i = 0; i < padding; ++i) {
+            _buffer.push(Spec.zeroPad ? '0' : Spec.fill);
+        }
+
+        // moves the leading padding in front of the value, the zeros go after the sign.
+        auto *first = _buffer.data() + start;
+        if constexpr (Spec.zeroPad) {
+            if (size > 0 && (*first == '-' || *first == '+')) {
+                ++first;
+            }
+        }
+        auto *last = _buffer.data() + _buffer.size();
+        const auto pushed = static_cast<std::size_t>(last - (_buffer.data() + start)) - size;
+        const auto moved = std::min(before, pushed);
+        std::rotate(first, last - moved, last);
+    }
+}
+
+template<class Format_t, std::size_t I>
+constexpr std::size_t argumentIndex() noexcept {
+    std::size_t index = 0;
+    for (std::size_t i = 0; i < I; ++i) {
+        index += Format_t::Parsed.segments[i].hasArgument ? 1 : 0;
+    }
+
+    return index;
+}
+
+template<class Format_t, std::size_t I, std::size_t N, class P, class Tuple_t>
+void writeSegment(CharFastStackBuffer<char, N, P> &_buffer, const Tuple_t &_args) {
+    constexpr auto segment = Format_t::Parsed.segments[I];
+    if constexpr (segment.literalSize > 0) {
+        _buffer.append(Format_t::Format.data() + segment.literalBegin, segment.literalSize);
+    }
+
+    if constexpr (segment.hasArgument) {
+        writeArgument<Format_t, I>(_buffer, std::get<argumentIndex<Format_t, I>()>(_args));
+    }
+}
+
+template<class Format_t, std::size_t N, class P, class Tuple_t, std::size_t... I>
+void writeSegments(CharFastStackBuffer<char, N, P> &_buffer, const Tuple_t &_args, std::index_sequence<I...>) {
+    (writeSegment<Format_t, I>(_buffer, _args), ...);
+}
+}  // namespace format_detail
+
+/*!
+ * @brief Writes the arguments by the format string into the buffer. Every literal segment is one append(),
+ * every argument is written by the CharFastStackBuffer formatters. The number of the arguments and the specs
+ * are checked against the argument types at compile time.
+ */
+template<class Literal_t, std::size_t N, class P, class... Args_t>
+void formatTo(CharFastStackBuffer<char, N, P> &_buffer, FormatString<Literal_t>, const Args_t &..._args) {
+    using Format_t = FormatString<Literal_t>;
+    static_assert(Format_t::ArgumentCount == sizeof...(Args_t), "the number of the arguments does not match the format string");
+
+    format_detail::writeSegments<Format_t>(_buffer, std::tuple<const Args_t &...>(_args...),
+                                           std::make_index_sequence<Format_t::Parsed.segmentCount>());
+}
+
+template<class Literal_t, std::size_t N, class P, class... Args_t>
+CharFastStackBuffer<char, N, P> &operator<<(CharFastStackBuffer<char, N, P> &_buffer, const FormatArgs<Literal_t, Args_t...> &_format) {
+    using Format_t = FormatString<Literal_t>;
+    static_assert(Format_t::ArgumentCount == sizeof...(Args_t), "the number of the arguments does not match the format string");
+
+    format_detail::writeSegments<Format_t>(_buffer, _format.args, std::make_index_sequence<Format_t::Parsed.segmentCount>());
+
+    return _buffer;
+}
+
+template<class Literal_t, class... Args_t>
+inline constexpr bool IsBufferFormattable_v<FormatArgs<Literal_t, Args_t...>, char> = true;
+
+/*!
+ * @brief IsFormatArgs is true for FormatArgs.
+ */
+template<class T>
+inline constexpr bool IsFormatArgs_v = false;
+
+template<class Literal_t, class... Args_t>
+inline constexpr bool IsFormatArgs_v<FormatArgs<Literal_t, Args_t...>> = true;
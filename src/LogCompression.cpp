@@ -0,0 +1,308 @@
+#include "LogCompression.h"
+
+#include "UserException.h"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace {
+//! The minimum match length.
+constexpr std::size_t MinMatch = 4;
+
+//! The last bytes of a block are literals.
+constexpr std::size_t LastLiterals = 5;
+
+//! A match starts at least this many bytes before the end of a block.
+constexpr std::size_t MatchFindLimit = 12;
+
+//! The maximum match offset.
+constexpr std::size_t MaxOffset = 65535;
+
+//! The size of the match finder table is 2 ^ HashBits positions.
+constexpr unsigned HashBits = 12;
+
+std::uint32_t read32(const unsigned char *_data) noexcept {
+    std::uint32_t value;
+    std::memcpy(&value, _data, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash(std::uint32_t _sequence) noexcept {
+    return (_sequence * 2654435761u) >> (32 - HashBits);
+}
+
+/*!
+ * @brief Writes the extension bytes of the length: 255 while it is not smaller, then the rest.
+ */
+unsigned char *putLength(unsigned char *_output, std::size_t _length) noexcept {
+    for (; _length >= 255; _length -= 255) {
+        *_output++ = 255;
+    }
+    *_output++ = static_cast<unsigned char>(_length);
+
+    return _output;
+}
+
+/*!
+ * @brief Reads the extension bytes of the length.
+ * @return false if the input ends.
+ */
+bool getLength(const unsigned char *&_input, const unsigned char *_inputEnd, std::size_t &_length) noexcept {
+    unsigned char byte;
+    do {
+        if (_input == _inputEnd) {
+            return false;
+        }
+        byte = *_input++;
+        _length += byte;
+    } while (byte == 255);
+
+    return true;
+}
+
+void putU32(std::ostream &_os, std::uint32_t _value) {
+    _os.write(reinterpret_cast<const char *>(&_value), sizeof(_value));
+}
+
+bool getU32(std::istream &_is, std::uint32_t &_value) {
+    return static_cast<bool>(_is.read(reinterpret_cast<char *>(&_value), sizeof(_value)));
+}
+
+[[noreturn]] void throwCorrupted(const char *_reason, const char *_function) {
+    throw UserException(UserException::Static, "Corrupted compressed log", _reason, _function);
+}
+}  // namespace
+
+std::size_t LogCompression::compressBlock(const char *_input, std::size_t _size, char *_output, std::size_t _capacity) noexcept {
+    const auto *const input = reinterpret_cast<const unsigned char *>(_input);
+    const auto *const end = input + _size;
+    auto *op = reinterpret_cast<unsigned char *>(_output);
+    auto *const outputEnd = op + _capacity;
+    const unsigned char *anchor = input;
+
+    // writes the literals from the anchor followed by the match, if any.
+    auto putSequence = [&](const unsigned char *_literalsEnd, std::size_t _offset, std::size_t _matchLength) {
+        const auto literals = static_cast<std::size_t>(_literalsEnd - anchor);
+        const auto needed = 1 + literals / 255 + 1 + literals + (_matchLength != 0 ? 2 + _matchLength / 255 + 1 : 0);
+        if (needed > static_cast<std::size_t>(outputEnd - op)) {
+            return false;
+        }
+
+        auto *token = op++;
+        *token = static_cast<unsigned char>((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15) {
+            op = putLength(op, literals - 15);
+        }
+        std::memcpy(op, anchor, literals);
+        op += literals;
+
+        if (_matchLength != 0) {
+            *op++ = static_cast<unsigned char>(_offset & 0xff);
+            *op++ = static_cast<unsigned char>(_offset >> 8);
+
+            const auto length = _matchLength - MinMatch;
+            *token |= static_cast<unsigned char>(length >= 15 ? 15 : length);
+            if (length >= 15) {
+                op = putLength(op, length - 15);
+            }
+        }
+
+        return true;
+    };
+
+    if (_size > MatchFindLimit) {
+        std::uint32_t positions[1u << HashBits] = {};
+        const auto *const matchLimit = end - LastLiterals;
+        const auto *const findLimit = end - MatchFindLimit;
+
+        const unsigned char *ip = input + 1;
+        while (ip <= findLimit) {
+            const auto sequence = read32(ip);
+            const auto slot = hash(sequence);
+            const auto *match = input + positions[slot];
+            positions[slot] = static_cast<std::uint32_t>(ip - input);
+
+            if (match >= ip || static_cast<std::size_t>(ip - match) > MaxOffset || read32(match) != sequence) {
+                // the less the input matches, the longer the step.
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            while (ip > anchor && match > input && ip[-1] == match[-1]) {
+                --ip;
+                --match;
+            }
+
+            auto length = MinMatch;
+            while (ip + length < matchLimit && ip[length] == match[length]) {
+                ++length;
+            }
+
+            if (!putSequence(ip, static_cast<std::size_t>(ip - match), length)) {
+                return 0;
+            }
+
+            ip += length;
+            anchor = ip;
+            if (ip <= findLimit) {
+                positions[hash(read32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - input);
+            }
+        }
+    }
+
+    if (!putSequence(end, 0, 0)) {
+        return 0;
+    }
+
+    return static_cast<std::size_t>(op - reinterpret_cast<unsigned char *>(_output));
+}
+
+bool LogCompression::decompressBlock(const char *_input, std::size_t _size, char *_output, std::size_t _capacity,
+                                     std::size_t &_decompressed) noexcept {
+    const auto *ip = reinterpret_cast<const unsigned char *>(_input);
+    const auto *const inputEnd = ip + _size;
+    auto *const outputStart = reinterpret_cast<unsigned char *>(_output);
+    auto *const outputEnd = outputStart + _capacity;
+    auto *op = outputStart;
+
+    while (ip < inputEnd) {
+        const auto token = *ip++;
+
+        std::size_t literals = token >> 4;
+        if (literals == 15 && !getLength(ip, inputEnd, literals)) {
+            return false;
+        }
+        if (literals > static_cast<std::size_t>(inputEnd - ip) || literals > static_cast<std::size_t>(outputEnd - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        // the last sequence has no match.
+        if (ip == inputEnd) {
+            _decompressed = static_cast<std::size_t>(op - outputStart);
+            return true;
+        }
+
+        if (inputEnd - ip < 2) {
+            return false;
+        }
+        const auto offset = static_cast<std::size_t>(ip[0] | (ip[1] << 8));
+        ip += 2;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - outputStart)) {
+            return false;
+        }
+
+        std::size_t length = token & 15;
+        if (length == 15 && !getLength(ip, inputEnd, length)) {
+            return false;
+        }
+        length += MinMatch;
+        if (length > static_cast<std::size_t>(outputEnd - op)) {
+            return false;
+        }
+
+        const auto *match = op - offset;
+        if (offset >= length) {
+            std::memcpy(op, match, length);
+            op += length;
+        } else {
+            // the match overlaps the output, it repeats the last offset bytes.
+            for (std::size_t i = 0; i < length; ++i) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return false;
+}
+
+LogCompression::StreamSizes LogCompression::compressStream(std::istream &_is, std::ostream &_os) {
+    StreamSizes sizes;
+
+    _os.write(Magic, sizeof(Magic));
+    putU32(_os, Version);
+    sizes.output += sizeof(Magic) + sizeof(Version);
+
+    std::vector<char> input(BlockSize);
+    std::vector<char> output(compressBound(BlockSize));
+    while (_is.read(input.data(), static_cast<std::streamsize>(input.size())) || _is.gcount() > 0) {
+        const auto size = static_cast<std::size_t>(_is.gcount());
+        sizes.input += size;
+
+        const auto compressed = compressBlock(input.data(), size, output.data(), output.size());
+        if (compressed == 0 || compressed >= size) {
+            putU32(_os, static_cast<std::uint32_t>(size) | RawBlock);
+            _os.write(input.data(), static_cast<std::streamsize>(size));
+            sizes.output += sizeof(std::uint32_t) + size;
+        } else {
+            putU32(_os, static_cast<std::uint32_t>(compressed));
+            _os.write(output.data(), static_cast<std::streamsize>(compressed));
+            sizes.output += sizeof(std::uint32_t) + compressed;
+        }
+    }
+
+    putU32(_os, 0);
+    sizes.output += sizeof(std::uint32_t);
+
+    return sizes;
+}
+
+LogCompression::StreamSizes LogCompression::decompressStream(std::istream &_is, std::ostream &_os) {
+    char header[sizeof(Magic) + sizeof(Version)];
+    if (!_is.read(header, sizeof(header)) ||
+        std::string_view(header, sizeof(Magic)) != std::string_view(Magic, sizeof(Magic))) {
+        throw UserException(UserException::Static, "The stream is not a compressed log", "wrong magic", __PRETTY_FUNCTION__);
+    }
+
+    std::uint32_t version;
+    std::memcpy(&version, header + sizeof(Magic), sizeof(version));
+    if (version != Version) {
+        throw UserException(UserException::Static, "Unsupported compressed log version", "wrong version", __PRETTY_FUNCTION__);
+    }
+
+    StreamSizes sizes;
+    sizes.input += sizeof(header);
+
+    std::vector<char> input(compressBound(BlockSize));
+    std::vector<char> output(BlockSize);
+    for (;;) {
+        std::uint32_t blockHeader;
+        if (!getU32(_is, blockHeader)) {
+            throwCorrupted("the stream is truncated", __PRETTY_FUNCTION__);
+        }
+        sizes.input += sizeof(blockHeader);
+        if (blockHeader == 0) {
+            break;
+        }
+
+        const bool raw = (blockHeader & RawBlock) != 0;
+        const std::size_t size = blockHeader & ~RawBlock;
+        if (size > (raw ? BlockSize : input.size())) {
+            throwCorrupted("the block is too large", __PRETTY_FUNCTION__);
+        }
+        if (!_is.read(input.data(), static_cast<std::streamsize>(size))) {
+            throwCorrupted("the stream is truncated", __PRETTY_FUNCTION__);
+        }
+        sizes.input += size;
+
+        if (raw) {
+            _os.write(input.data(), static_cast<std::streamsize>(size));
+            sizes.output += size;
+            continue;
+        }
+
+        std::size_t decompressed = 0;
+        if (!decompressBlock(input.data(), size, output.data(), output.size(), decompressed)) {
+            throwCorrupted("the block is corrupted", __PRETTY_FUNCTION__);
+        }
+        _os.write(output.data(), static_cast<std::streamsize>(decompressed));
+        sizes.output += decompressed;
+    }
+
+    return sizes;
+}
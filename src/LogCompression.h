@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/*!
+ * @brief LogCompression compresses the log files by blocks of the LZ4 block format: a sequence is a token
+ * (literal length and match length nibbles), the extended literal length, the literals, the match offset (u16)
+ * and the extended match length; the minimum match is 4 bytes, the last 5 bytes of a block are literals.
+ * The compressed stream starts with Magic and Version, followed by the blocks. A block starts with its size (u32),
+ * RawBlock is set if the block is stored uncompressed; a zero size ends the stream. A block holds at most
+ * BlockSize bytes of the input, so the stream is compressed and decompressed without buffering the whole file.
+ * The numbers are stored in the native byte order.
+ */
+struct LogCompression {
+    /*!
+     * @brief The stream signature.
+     */
+    static constexpr char Magic[4] = {'S', 'C', 'L', 'Z'};
+
+    /*!
+     * @brief The format version.
+     */
+    static constexpr std::uint32_t Version = 1;
+
+    /*!
+     * @brief The maximum input size of a block.
+     */
+    static constexpr std::size_t BlockSize = 64 * 1024;
+
+    /*!
+     * @brief The block size flag of a block stored uncompressed.
+     */
+    static constexpr std::uint32_t RawBlock = 0x80000000u;
+
+    /*!
+     * @brief The file name suffix of a compressed log file.
+     */
+    static constexpr char FileSuffix[] = ".lz";
+
+    /*!
+     * @brief The sizes of the compressed or decompressed stream.
+     */
+    struct StreamSizes {
+        //! The read bytes.
+        std::uint64_t input = 0;
+        //! The written bytes.
+        std::uint64_t output = 0;
+    };
+
+    /*!
+     * @brief Returns the maximum compressed size of the input.
+     */
+    static constexpr std::size_t compressBound(std::size_t _size) noexcept {
+        return _size + _size / 255 + 16;
+    }
+
+    /*!
+     * @brief Compresses the block.
+     * @param _input - the input, at most BlockSize bytes.
+     * @param _size - the input size.
+     * @param _output - the output buffer.
+     * @param _capacity - the output buffer size.
+     * @return The compressed size or 0 if it does not fit into the output buffer.
+     */
+    static std::size_t compressBlock(const char *_input, std::size_t _size, char *_output, std::size_t _capacity) noexcept;
+
+    /*!
+     * @brief Decompresses the block.
+     * @param _input - the compressed block.
+     * @param _size - the compressed size.
+     * @param _output - the output buffer.
+     * @param _capacity - the output buffer size.
+     * @param _decompressed - the decompressed size.
+     * @return false if the block is corrupted or does not fit into the output buffer.
+     */
+    static bool decompressBlock(const char *_input, std::size_t _size, char *_output, std::size_t _capacity,
+                                std::size_t &_decompressed) noexcept;
+
+    /*!
+     * @brief Compresses the stream block by block.
+     * @param _is - the input stream.
+     * @param _os - the output stream, the caller checks its state.
+     * @return The input and the output sizes.
+     */
+    static StreamSizes compressStream(std::istream &_is, std::ostream &_os);
+
+    /*!
+     * @brief Decompresses the stream block by block.
+     * @param _is - the compressed stream positioned at the header.
+     * @param _os - the output stream.
+     * @return The input and the output sizes.
+     * @throw UserException - if the stream is not compressed or corrupted.
+     */
+    static StreamSizes decompressStream(std::istream &_is, std::ostream &_os);
+};
@@ -0,0 +1,166 @@
+#include "LogCompressor.h"
+
+#include "FdLogSink.h"
+#include "LogCompression.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+//! The lowest CPU priority.
+constexpr int IdleNice = 19;
+
+//! The arguments of ioprio_set(2) for the idle I/O class of the calling thread.
+constexpr int IoprioWhoProcess = 1;
+constexpr int IoprioClassIdle = 3;
+constexpr int IoprioClassShift = 13;
+
+/*!
+ * @brief Gives the calling thread the idle CPU and I/O priority, the compression yields to the service.
+ */
+void lowerPriority() noexcept {
+    // on Linux the priority of a thread id applies to the thread only.
+    static_cast<void>(::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), IdleNice));
+#ifdef SYS_ioprio_set
+    static_cast<void>(::syscall(SYS_ioprio_set, IoprioWhoProcess, 0, IoprioClassIdle << IoprioClassShift));
+#endif
+}
+
+/*!
+ * @brief Returns the rotated file "<path>.<n>" with the inode or an empty string if it has been removed.
+ * The caller holds RotatingFileLogSink::rotationMutex().
+ */
+std::string findRotated(const std::string &_path, ino_t _inode) {
+    for (std::size_t index = 1;; ++index) {
+        const auto rotated = _path + '.' + std::to_string(index);
+        struct stat status {};
+        if (::stat(rotated.c_str(), &status) == 0) {
+            if (status.st_ino == _inode) {
+                return rotated;
+            }
+        } else if (::stat((rotated + LogCompression::FileSuffix).c_str(), &status) != 0) {
+            return {};
+        }
+    }
+}
+}  // namespace
+
+LogCompressor::LogCompressor() : m_thread(&LogCompressor::run, this) {
+}
+
+LogCompressor::~LogCompressor() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+}
+
+void LogCompressor::compress(const std::string &_rotatedPath) noexcept {
+    struct stat status {};
+    const auto separator = _rotatedPath.rfind('.');
+    if (separator == std::string::npos || ::stat(_rotatedPath.c_str(), &status) != 0) {
+        return;
+    }
+
+    try {
+        std::lock_guard lock(m_mutex);
+        m_jobs.push_back(Job{_rotatedPath.substr(0, separator), status.st_ino});
+    } catch (const std::exception &) {
+        // the file stays uncompressed, the logging must not fail the caller.
+        return;
+    }
+    m_changed.notify_all();
+}
+
+void LogCompressor::flush() {
+    std::unique_lock lock(m_mutex);
+    m_changed.wait(lock, [this] { return m_jobs.empty() && !m_busy; });
+}
+
+std::size_t LogCompressor::compressedFiles() const noexcept {
+    return m_compressedFiles.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LogCompressor::inputBytes() const noexcept {
+    return m_inputBytes.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LogCompressor::outputBytes() const noexcept {
+    return m_outputBytes.load(std::memory_order_relaxed);
+}
+
+void LogCompressor::run() {
+    lowerPriority();
+
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_changed.wait(lock, [this] { return !m_jobs.empty() || m_stop; });
+        if (m_jobs.empty()) {
+            return;
+        }
+
+        const auto job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        try {
+            compressFile(job);
+        } catch (const std::exception &) {
+        }
+
+        lock.lock();
+        m_busy = false;
+        m_changed.notify_all();
+    }
+}
+
+void LogCompressor::compressFile(const Job &_job) {
+    std::ifstream input;
+    {
+        std::lock_guard lock(RotatingFileLogSink::rotationMutex());
+        const auto source = findRotated(_job.path, _job.inode);
+        if (source.empty()) {
+            return;
+        }
+        input.open(source, std::ios::binary);
+    }
+    if (!input.is_open()) {
+        return;
+    }
+
+    const auto temporaryPath = _job.path + ".compressing";
+    std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        return;
+    }
+
+    const auto sizes = LogCompression::compressStream(input, output);
+    output.close();
+    if (input.bad() || !output) {
+        std::remove(temporaryPath.c_str());
+        return;
+    }
+
+    // the file may have been shifted by the rotations meanwhile.
+    std::lock_guard lock(RotatingFileLogSink::rotationMutex());
+    const auto source = findRotated(_job.path, _job.inode);
+    if (source.empty()) {
+        std::remove(temporaryPath.c_str());
+        return;
+    }
+
+    std::rename(temporaryPath.c_str(), (source + LogCompression::FileSuffix).c_str());
+    std::remove(source.c_str());
+
+    m_compressedFiles.fetch_add(1, std::memory_order_relaxed);
+    m_inputBytes.fetch_add(sizes.input, std::memory_order_relaxed);
+    m_outputBytes.fetch_add(sizes.output, std::memory_order_relaxed);
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <sys/types.h>
+
+/*!
+ * @brief LogCompressor compresses the rotated log files in a background thread of the idle CPU and I/O priority.
+ * A file is compressed block by block (see LogCompression) into "<file>.lz", which then replaces the file
+ * at its current place among the rotated files, so a rotation meanwhile does not confuse them.
+ * StdCoreLogDecompress turns a compressed file back into text.
+ */
+class LogCompressor {
+public:
+    /*!
+     * @brief Construct a new LogCompressor object and start the compressing thread.
+     */
+    LogCompressor();
+
+    /*!
+     * @brief Destroy the LogCompressor object. The queued files are compressed before the thread stops.
+     */
+    ~LogCompressor();
+
+    LogCompressor(const LogCompressor &) = delete;
+    LogCompressor &operator=(const LogCompressor &) = delete;
+
+    /*!
+     * @brief Queues the rotated file "<path>.<n>". Called by the sink right after the rotation.
+     * @param _rotatedPath - the path of the rotated file.
+     */
+    void compress(const std::string &_rotatedPath) noexcept;
+
+    /*!
+     * @brief Blocks until the queued files are compressed.
+     */
+    void flush();
+
+    /*!
+     * @brief Returns the number of the compressed files.
+     */
+    [[nodiscard]]
+    std::size_t compressedFiles() const noexcept;
+
+    /*!
+     * @brief Returns the size of the compressed files before the compression.
+     */
+    [[nodiscard]]
+    std::uint64_t inputBytes() const noexcept;
+
+    /*!
+     * @brief Returns the size of the compressed files after the compression.
+     */
+    [[nodiscard]]
+    std::uint64_t outputBytes() const noexcept;
+
+private:
+    /*!
+     * @brief A queued file, it is found among the rotated files of the path by its inode.
+     */
+    struct Job {
+        std::string path;
+        ino_t inode;
+    };
+
+    /*!
+     * @brief The compressing thread.
+     */
+    void run();
+
+    /*!
+     * @brief Compresses the file and replaces it.
+     */
+    void compressFile(const Job &_job);
+
+    /*!
+     * @brief Guards the members below.
+     */
+    std::mutex m_mutex;
+    /*!
+     * @brief Notified when a file is queued or compressed, or the compressor stops.
+     */
+    std::condition_variable m_changed;
+    /*!
+     * @brief The queued files.
+     */
+    std::deque<Job> m_jobs;
+    /*!
+     * @brief A file is being compressed.
+     */
+    bool m_busy = false;
+    /*!
+     * @brief The thread must finish.
+     */
+    bool m_stop = false;
+    /*!
+     * @brief Number of the compressed files.
+     */
+    std::atomic<std::size_t> m_compressedFiles{0};
+    /*!
+     * @brief The sizes of the compressed files.
+     */
+    std::atomic<std::uint64_t> m_inputBytes{0};
+    std::atomic<std::uint64_t> m_outputBytes{0};
+    /*!
+     * @brief The compressing thread.
+     */
+    std::thread m_thread;
+};
+
+/*!
+ * @brief CompressingLogSink is a rotating sink, RotatingFileLogSink or MmapLogSink, whose rotated files
+ * are compressed by LogCompressor. The writers are not affected, the rotation only queues the file.
+ * @tparam Sink_t - the sink type.
+ */
+template<class Sink_t>
+class CompressingLogSink final : public Sink_t {
+public:
+    /*!
+     * @brief Construct a new CompressingLogSink object.
+     * @param _compressor - the compressor, it must outlive the sink.
+     * @param _args - the arguments of the sink constructor.
+     */
+    template<class... Args_t>
+    explicit CompressingLogSink(LogCompressor &_compressor, Args_t &&..._args)
+            : Sink_t(std::forward<Args_t>(_args)...), m_compressor(_compressor) {}
+
+protected:
+    void onRotated(const std::string &_rotatedPath) override {
+        m_compressor.compress(_rotatedPath);
+    }
+
+private:
+    /*!
+     * @brief The compressor.
+     */
+    LogCompressor &m_compressor;
+};
@@ -1,31 +1,830 @@
 #include "LogHelper.h"
 
+#include "FdLogSink.h"
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <ctime>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+//! The background thread checks the flush policy of the sink and the suppression summary this often.
+constexpr auto BackgroundInterval = std::chrono::milliseconds(10);
+
+/*!
+ * @brief The active asynchronous writer or nullptr in the synchronous mode.
+ */
+std::atomic<AsyncLogWriter *> g_asyncWriter{nullptr};
+
+/*!
+ * @brief The active binary writer or nullptr in the text mode.
+ */
+std::atomic<BinaryLogWriter *> g_binaryWriter{nullptr};
+
+/*!
+ * @brief The sink of the text records or nullptr for the default one.
+ */
+std::atomic<LogSink *> g_sink{nullptr};
+
+/*!
+ * @brief The format of the text records.
+ */
+std::atomic<RecordFormat> g_recordFormat{RecordFormat::Text};
+
+/*!
+ * @brief The rate limited statements write the suppression summary.
+ */
+std::atomic<bool> g_suppressionSummary{false};
+
+/*!
+ * @brief The period of the background suppression summary in milliseconds.
+ */
+std::atomic<std::chrono::milliseconds::rep> g_suppressionSummaryInterval{LogHelper::DefaultSuppressionSummaryInterval.count()};
+
+/*!
+ * @brief Counts the setSuppressionSummary() calls, the background thread restarts the summary period when it changes.
+ */
+std::atomic<std::uint64_t> g_suppressionSummaryGeneration{0};
+
+/*!
+ * @brief The rate limited statement which has written a record; the background thread writes its suppression summary.
+ */
+struct LimitedSite {
+    const LogSite *site;
+    LogLimiter *limiter;
+    LogLevel logLevel;
+};
+
+/*!
+ * @brief Guards g_limitedSites.
+ */
+std::mutex g_limitedSitesMutex;
+
+/*!
+ * @brief The registered rate limited statements, the sites are static so they are never unregistered.
+ */
+std::vector<LimitedSite> g_limitedSites;
+
+/*!
+ * @brief Writes the suppression summary of the registered statements which have suppressed records.
+ */
+void writeSuppressionSummary() {
+    std::vector<std::pair<LimitedSite, std::uint64_t>> summaries;
+    {
+        std::lock_guard lock(g_limitedSitesMutex);
+        for (const auto &site : g_limitedSites) {
+            if (const auto suppressed = site.limiter->takeSuppressed(); suppressed > 0) {
+                summaries.emplace_back(site, suppressed);
+            }
+        }
+    }
+
+    for (const auto &[site, suppressed] : summaries) {
+        LogHelper(site.logLevel, *site.site) << "suppressed " << suppressed << " messages";
+    }
+}
+
+/*!
+ * @brief The formatter of the record time stamps.
+ */
+std::atomic<TimestampFormatter> g_timestampFormatter{TimestampFormatter()};
+
+/*!
+ * @brief The mark of a thread which uses the sink or a writer: the depth of its nested SinkGuard scopes. Only its thread
+ * writes it, so a record touches no shared cache line; setSink() and the disabling of a writer wait until every other
+ * mark has been seen zero.
+ */
+struct SinkReader {
+    std::atomic<unsigned> depth{0};
+    //! The sinks replaced by setSink() inside a sink of this thread, they are released when the thread leaves the sinks.
+    std::vector<std::shared_ptr<LogSink>> retired;
+};
+
+/*!
+ * @brief Guards g_sinkReaders.
+ */
+std::mutex g_sinkReadersMutex;
+
+/*!
+ * @brief The marks of the threads which have used the sink.
+ */
+std::vector<std::shared_ptr<SinkReader>> g_sinkReaders;
+
+/*!
+ * @brief Number of the sink users without a mark, e.g. the records of thread_local destructors.
+ */
+std::atomic<std::size_t> g_unmarkedSinkReaders{0};
+
+/*!
+ * @brief The mark of the thread has been destroyed.
+ */
+thread_local bool t_sinkReaderDestroyed = false;
+
+/*!
+ * @brief Number of the SinkGuard scopes of the thread counted in g_unmarkedSinkReaders.
+ */
+thread_local std::size_t t_unmarkedDepth = 0;
+
+/*!
+ * @brief Registers the mark of the thread and unregisters it when the thread finishes.
+ */
+struct SinkReaderHolder {
+    SinkReaderHolder() {
+        std::lock_guard lock(g_sinkReadersMutex);
+        g_sinkReaders.push_back(reader);
+    }
+
+    ~SinkReaderHolder() {
+        t_sinkReaderDestroyed = true;
+
+        std::lock_guard lock(g_sinkReadersMutex);
+        g_sinkReaders.erase(std::find(g_sinkReaders.begin(), g_sinkReaders.end(), reader));
+    }
+
+    //! It is shared with setSink(), which may still read the mark after the thread has finished.
+    std::shared_ptr<SinkReader> reader = std::make_shared<SinkReader>();
+};
+
+/*!
+ * @brief Returns the mark of the thread or nullptr if it has been destroyed.
+ */
+SinkReader *sinkReader() {
+    if (t_sinkReaderDestroyed) {
+        return nullptr;
+    }
+
+    thread_local SinkReaderHolder holder;
+    return holder.reader.get();
+}
+
+/*!
+ * @brief Returns the mark of the calling thread or nullptr if it has been destroyed, the mark is registered if needed.
+ */
+SinkReader *currentSinkReader() {
+    return t_sinkReaderDestroyed ? nullptr : sinkReader();
+}
+
+/*!
+ * @brief Flushes and releases the sinks replaced inside a sink of the thread, the thread does not use them anymore.
+ */
+void releaseRetiredSinks(SinkReader &_reader) noexcept {
+    auto retired = std::move(_reader.retired);
+    _reader.retired.clear();
+    for (auto &sink : retired) {
+        try {
+            sink->flush();
+        } catch (...) {
+            // the records kept by the sink are lost.
+        }
+    }
+}
+
+/*!
+ * @brief Loads the current sink and keeps it alive while the guard exists, the writers loaded in its scope too.
+ */
+class SinkGuard {
+public:
+    SinkGuard() noexcept {
+        try {
+            m_reader = sinkReader();
+        } catch (...) {
+        }
+
+        // the mark is stored before the sink is loaded, so setSink() either sees the mark or this thread sees the new sink.
+        if (m_reader != nullptr) {
+            m_depth = m_reader->depth.load(std::memory_order_relaxed);
+            m_reader->depth.store(m_depth + 1);
+        } else {
+            ++t_unmarkedDepth;
+            g_unmarkedSinkReaders.fetch_add(1);
+        }
+        m_sink = g_sink.load();
+    }
+
+    ~SinkGuard() {
+        if (m_reader != nullptr) {
+            m_reader->depth.store(m_depth, std::memory_order_release);
+            if (m_depth == 0 && !m_reader->retired.empty()) {
+                releaseRetiredSinks(*m_reader);
+            }
+        } else {
+            --t_unmarkedDepth;
+            g_unmarkedSinkReaders.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    SinkGuard(const SinkGuard &) = delete;
+    SinkGuard &operator=(const SinkGuard &) = delete;
+
+    /*!
+     * @brief Returns the sink loaded by the guard.
+     */
+    [[nodiscard]]
+    LogSink &sink() const noexcept;
+
+private:
+    SinkReader *m_reader = nullptr;
+    unsigned m_depth = 0;
+    LogSink *m_sink = nullptr;
+};
+
+/*!
+ * @brief Waits until the other threads have left the sinks they loaded before the call. The calling thread may be
+ * inside a sink itself, e.g. a sink which replaces itself on an error, so its own mark is not waited for.
+ * @param _self - the mark of the calling thread or nullptr.
+ */
+void waitForSinkReaders(const SinkReader *_self) {
+    std::vector<std::shared_ptr<SinkReader>> readers;
+    {
+        std::lock_guard lock(g_sinkReadersMutex);
+        readers = g_sinkReaders;
+    }
+
+    for (const auto &reader : readers) {
+        while (reader.get() != _self && reader->depth.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    while (g_unmarkedSinkReaders.load() != t_unmarkedDepth) {
+        std::this_thread::yield();
+    }
+}
+
+/*!
+ * @brief The sink of the asynchronous writers, it forwards every call to the current sink, so the writers follow setSink().
+ */
+class CurrentLogSink final : public LogSink {
+public:
+    void write(std::string_view _record, LogLevel _level) override {
+        SinkGuard guard;
+        guard.sink().write(_record, _level);
+    }
+
+    void flush() override {
+        SinkGuard guard;
+        guard.sink().flush();
+    }
+
+    void flushIfDue() override {
+        SinkGuard guard;
+        guard.sink().flushIfDue();
+    }
+};
+
+/*!
+ * @brief Owns the writers and the sinks. A disabled writer is stopped and freed once no SinkGuard scope,
+ * in which the writers are loaded, can still hold it. The sinks are declared first, so they outlive
+ * the asynchronous writer which writes to them; the file is declared before the binary writer which writes to it.
+ */
+struct WriterStorage {
+    std::mutex mutex;
+    std::condition_variable backgroundCv;
+    bool stopBackground = false;
+    std::thread background;
+    StderrLogSink defaultSink;
+    std::shared_ptr<LogSink> sink;
+    //! The sinks replaced inside a sink by a thread without a mark.
+    std::vector<std::shared_ptr<LogSink>> retiredSinks;
+    CurrentLogSink currentSink;
+    std::unique_ptr<std::ofstream> file;
+    std::unique_ptr<AsyncLogWriter> asyncWriter;
+    std::unique_ptr<BinaryLogWriter> binaryWriter;
+
+    ~WriterStorage() {
+        {
+            std::lock_guard lock(mutex);
+            stopBackground = true;
+        }
+        backgroundCv.notify_all();
+        if (background.joinable()) {
+            background.join();
+        }
+
+        g_asyncWriter.store(nullptr);
+        g_binaryWriter.store(nullptr);
+        if (asyncWriter != nullptr) {
+            asyncWriter->stop();
+        }
+        if (binaryWriter != nullptr) {
+            binaryWriter->stop();
+        }
+
+        g_sink.store(nullptr);
+        if (sink != nullptr) {
+            sink->flush();
+        }
+        for (auto &retired : retiredSinks) {
+            retired->flush();
+        }
+    }
+};
+
+WriterStorage &writerStorage() {
+    static WriterStorage storage;
+    return storage;
+}
+
+/*!
+ * @brief The background thread: it writes the records which the sink has kept longer than its flush policy allows,
+ * so the time limit holds when no more records come, and the periodic suppression summary.
+ */
+void runBackground(WriterStorage &_storage) {
+    // the first summary is written one interval after the summary is enabled.
+    std::uint64_t summaryGeneration = 0;
+    auto nextSummary = std::chrono::steady_clock::time_point::max();
+    std::unique_lock lock(_storage.mutex);
+    while (!_storage.stopBackground) {
+        _storage.backgroundCv.wait_for(lock, BackgroundInterval);
+        lock.unlock();
+        {
+            SinkGuard guard;
+            guard.sink().flushIfDue();
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto interval = std::chrono::milliseconds(g_suppressionSummaryInterval.load(std::memory_order_relaxed));
+        if (const auto generation = g_suppressionSummaryGeneration.load(std::memory_order_acquire); generation != summaryGeneration) {
+            summaryGeneration = generation;
+            nextSummary = now + interval;
+        } else if (g_suppressionSummary.load(std::memory_order_relaxed) && now >= nextSummary) {
+            nextSummary = now + interval;
+            try {
+                writeSuppressionSummary();
+            } catch (const std::exception &) {
+                // the summary is retried in the next period.
+            }
+        }
+        lock.lock();
+    }
+}
+
+/*!
+ * @brief Starts the background thread unless it is running, the storage mutex is locked.
+ */
+void startBackground(WriterStorage &_storage) {
+    if (!_storage.background.joinable()) {
+        _storage.background = std::thread(&runBackground, std::ref(_storage));
+    }
+}
+
+LogSink &SinkGuard::sink() const noexcept {
+    if (m_sink != nullptr) {
+        return *m_sink;
+    }
+
+    return writerStorage().defaultSink;
+}
+
+/*!
+ * @brief Writes the text record to the asynchronous writer or, in the synchronous mode, to the sink.
+ */
+void writeText(std::string_view _record, LogLevel _level) {
+    SinkGuard guard;
+    if (auto *writer = g_asyncWriter.load();
+        writer != nullptr && writer->push(_record, _level) != AsyncLogWriter::PushResult::Stopped) {
+        return;
+    }
+
+    if constexpr (LogMetrics::Enabled) {
+        const auto start = LogMetrics::now();
+        guard.sink().write(_record, _level);
+        LogMetrics::addLatency(LogMetrics::Latency::SinkWrite, LogMetrics::now() - start);
+    } else {
+        guard.sink().write(_record, _level);
+    }
+}
+
+/*!
+ * @brief Writes the binary record to the binary writer or, if it is disabled, decodes it and writes it by writeText().
+ */
+void writeBinary(std::string_view _record, LogLevel _level) {
+    {
+        SinkGuard guard;
+        if (auto *writer = g_binaryWriter.load(); writer != nullptr && writer->push(_record)) {
+            return;
+        }
+    }
+
+    // the binary mode has been disabled meanwhile, the record goes where a text one goes.
+    std::string text;
+    try {
+        std::ostringstream stream;
+        BinaryLogDecoder decoder(BinaryLogDecoder::Options{LogHelper::timestampFormatter()});
+        decoder.decode(_record, stream);
+        text = stream.str();
+    } catch (const std::exception &) {
+        return;
+    }
+
+    if (!text.empty() && text.back() == '\n') {
+        text.pop_back();
+    }
+    writeText(text, _level);
+}
+
+/*!
+ * @brief The output of the flight recorder, the records are written in the mode they were recorded in.
+ */
+void writeRecorded(std::string_view _record, LogLevel _level, bool _binary) {
+    if (_binary) {
+        writeBinary(_record, _level);
+    } else {
+        writeText(_record, _level);
+    }
+}
+
+/*!
+ * @brief The record pool of the thread has been destroyed, the records logged by later thread_local destructors are not pooled.
+ */
+thread_local bool t_recordPoolDestroyed = false;
+}  // namespace
+
+/*!
+ * @brief A nested logging statement, e.g. in operator<< of a logged value, takes one more record,
+ * so the pool keeps a few of them.
+ */
+struct LogHelper::RecordPool {
+    static constexpr std::size_t MaxRecords = 4;
+
+    RecordPool() {
+        records.reserve(MaxRecords);
+    }
+
+    ~RecordPool() {
+        t_recordPoolDestroyed = true;
+    }
+
+    /*!
+     * @brief Returns the pool of the thread or nullptr if it has been destroyed.
+     */
+    static RecordPool *instance() noexcept {
+        if (t_recordPoolDestroyed) {
+            return nullptr;
+        }
+
+        thread_local RecordPool pool;
+        return &pool;
+    }
+
+    std::vector<std::unique_ptr<Record>> records;
+};
+
+void LogHelper::Record::reset() noexcept {
+    buffer.clear();
+    fields.clear();
+    if (!streamUsed) {
+        return;
+    }
+
+    // points the put area to the empty buffer.
+    streamBuff.pubsync();
+    streamUsed = false;
+
+    ostream.clear();
+    ostream.flags(std::ios_base::skipws | std::ios_base::dec);
+    ostream.precision(6);
+    ostream.width(0);
+    ostream.fill(' ');
+}
+
+LogHelper::Record *LogHelper::acquireRecord() {
+    if (auto *pool = RecordPool::instance(); pool != nullptr && !pool->records.empty()) {
+        auto *record = pool->records.back().release();
+        pool->records.pop_back();
+        record->reset();
+
+        return record;
+    }
+
+    return new Record;
+}
+
+void LogHelper::releaseRecord(Record *_record) noexcept {
+    if (auto *pool = RecordPool::instance(); pool != nullptr && pool->records.size() < RecordPool::MaxRecords) {
+        pool->records.emplace_back(_record);
+        return;
+    }
+
+    delete _record;
+}
+
+LogHelper::LogHelper(LogLevel _logLevel): m_logLevel(_logLevel), m_enabled(isEnabled(_logLevel)), m_site(nullptr) {
+    if (m_enabled) {
+        m_record = acquireRecord();
+        beginRecord();
+    }
+}
+
+LogHelper::LogHelper(LogLevel _logLevel, const LogSite &_site): m_logLevel(_logLevel), m_enabled(isEnabled(_logLevel)), m_site(&_site) {
+    if (m_enabled) {
+        m_record = acquireRecord();
+        beginRecord();
+    }
+}
+
+LogHelper::LogHelper(LogLevel _logLevel, const LogSite &_site, LogLimiter &_limiter)
+        : m_logLevel(_logLevel), m_enabled(isEnabled(_logLevel)), m_site(&_site) {
+    if (!m_enabled) {
+        return;
+    }
+
+    if (_limiter.registerOnce()) {
+        std::lock_guard lock(g_limitedSitesMutex);
+        g_limitedSites.push_back(LimitedSite{&_site, &_limiter, _logLevel});
+    }
+
+    if (g_suppressionSummary.load(std::memory_order_relaxed)) {
+        if (const auto suppressed = _limiter.takeSuppressed(); suppressed > 0) {
+            LogHelper(_logLevel, _site) << "suppressed " << suppressed << " messages";
+        }
+    }
 
-LogHelper::LogHelper(LogLevel _logLevel): m_logLevel(_logLevel) {
-    m_buffer << timestamp() << " ";
+    m_record = acquireRecord();
+    beginRecord();
 }
 
 LogHelper::~LogHelper() {
-    std::cerr << m_buffer << std::endl;
+    if (!m_enabled) {
+        return;
+    }
+
+    endRecord();
+    releaseRecord(m_record);
+}
+
+void LogHelper::endRecord() {
+    auto &buffer = m_record->buffer;
+    if (m_binary) {
+        BinaryLogFormat::endRecord(buffer);
+        if constexpr (LogMetrics::Enabled) {
+            LogMetrics::addLatency(LogMetrics::Latency::Format, LogMetrics::now() - m_start);
+            LogMetrics::addRecord(m_logLevel, static_cast<std::size_t>(buffer.size()), buffer.truncated() != 0);
+        }
+
+        if (FlightRecorder::records(m_logLevel)) {
+            FlightRecorder::record(buffer.view(), m_logLevel, true);
+            return;
+        }
+        if (FlightRecorder::dumpsBefore(m_logLevel)) {
+            FlightRecorder::dumpThread();
+        }
+
+        writeBinary(buffer.view(), m_logLevel);
+        return;
+    }
+
+    const auto truncated = buffer.truncated() != 0 || m_record->fields.truncated() != 0;
+    buffer.writeTruncationMarker();
+    auto record = buffer.view();
+    if (m_format != RecordFormat::Text) {
+        StructuredLogFormat::endRecord(m_record->fields, m_format, record);
+        record = m_record->fields.view();
+    }
+
+    if constexpr (LogMetrics::Enabled) {
+        LogMetrics::addLatency(LogMetrics::Latency::Format, LogMetrics::now() - m_start);
+        LogMetrics::addRecord(m_logLevel, record.size(), truncated);
+    }
+
+    if (FlightRecorder::records(m_logLevel)) {
+        FlightRecorder::record(record, m_logLevel, false);
+        return;
+    }
+    if (FlightRecorder::dumpsBefore(m_logLevel)) {
+        FlightRecorder::dumpThread();
+    }
+
+    writeText(record, m_logLevel);
 }
 
-std::string LogHelper::timestamp() const noexcept {
-    auto time =
-        std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    std::string timeStr(std::ctime(&time));
-    // remove line feed.
-    timeStr.resize(timeStr.size() - 1);
+void LogHelper::setLogLevel(LogLevel _logLevel) noexcept {
+    s_logLevel.store(_logLevel, std::memory_order_relaxed);
+}
 
-    return timeStr;
+LogHelper::LogLevel LogHelper::logLevel() noexcept {
+    return s_logLevel.load(std::memory_order_relaxed);
 }
 
-std::basic_ostream<char> &LogHelper::stream() {
-    if (!m_ostream.has_value()) {
-        m_ostream.emplace(m_buffer);
+void LogHelper::setTimestampFormatter(TimestampFormatter _formatter) noexcept {
+    // the calibration sleeps, it is done here instead of in the first record.
+    if (_formatter.clockSource() == TimestampFormatter::ClockSource::Tsc) {
+        TimestampFormatter::calibrate();
+    }
+    g_timestampFormatter.store(_formatter, std::memory_order_relaxed);
+}
+
+TimestampFormatter LogHelper::timestampFormatter() noexcept {
+    return g_timestampFormatter.load(std::memory_order_relaxed);
+}
+
+void LogHelper::setRecordFormat(RecordFormat _format) noexcept {
+    g_recordFormat.store(_format, std::memory_order_relaxed);
+}
+
+RecordFormat LogHelper::recordFormat() noexcept {
+    return g_recordFormat.load(std::memory_order_relaxed);
+}
+
+void LogHelper::setSuppressionSummary(bool _enabled, std::chrono::milliseconds _interval) {
+    g_suppressionSummaryInterval.store(_interval.count(), std::memory_order_relaxed);
+    g_suppressionSummary.store(_enabled, std::memory_order_relaxed);
+    g_suppressionSummaryGeneration.fetch_add(1, std::memory_order_release);
+    if (_enabled) {
+        auto &storage = writerStorage();
+        std::lock_guard lock(storage.mutex);
+        startBackground(storage);
+    }
+}
+
+bool LogHelper::suppressionSummary() noexcept {
+    return g_suppressionSummary.load(std::memory_order_relaxed);
+}
+
+void LogHelper::setSink(std::shared_ptr<LogSink> _sink) {
+    auto &storage = writerStorage();
+    std::shared_ptr<LogSink> previous;
+    {
+        std::lock_guard lock(storage.mutex);
+        previous = std::exchange(storage.sink, std::move(_sink));
+        g_sink.store(storage.sink.get());
+
+        if (storage.sink != nullptr) {
+            startBackground(storage);
+        }
+    }
+
+    // the locks are not held while waiting, so a waited thread may log its first record, finish or call setSink() too.
+    auto *self = currentSinkReader();
+    waitForSinkReaders(self);
+
+    if (previous == nullptr) {
+        return;
+    }
+
+    // the calling thread is inside a sink, which may be the previous one; it is released when the thread leaves it.
+    if (self != nullptr && self->depth.load(std::memory_order_relaxed) != 0) {
+        self->retired.push_back(std::move(previous));
+        return;
+    }
+    if (t_unmarkedDepth != 0) {
+        std::lock_guard lock(storage.mutex);
+        storage.retiredSinks.push_back(std::move(previous));
+        return;
+    }
+
+    // no record uses the previous sink anymore, it is released unless the caller keeps it.
+    previous->flush();
+}
+
+LogSink &LogHelper::sink() noexcept {
+    if (auto *sink = g_sink.load(std::memory_order_acquire); sink != nullptr) {
+        return *sink;
+    }
+
+    return writerStorage().defaultSink;
+}
+
+void LogHelper::enableAsync(std::size_t _queueCapacity, AsyncLogWriter::OverflowPolicy _policy) {
+    auto &storage = writerStorage();
+    std::lock_guard lock(storage.mutex);
+
+    if (storage.asyncWriter != nullptr) {
+        return;
+    }
+
+    storage.asyncWriter = std::make_unique<AsyncLogWriter>(storage.currentSink, _queueCapacity, _policy);
+    g_asyncWriter.store(storage.asyncWriter.get(), std::memory_order_release);
+}
+
+void LogHelper::disableAsync() {
+    auto &storage = writerStorage();
+    std::unique_ptr<AsyncLogWriter> writer;
+    {
+        std::lock_guard lock(storage.mutex);
+        g_asyncWriter.store(nullptr);
+        writer = std::move(storage.asyncWriter);
+    }
+
+    if (writer != nullptr) {
+        writer->stop();
+        waitForSinkReaders(currentSinkReader());
+    }
+}
+
+bool LogHelper::enableBinary(const std::string &_path) {
+    auto &storage = writerStorage();
+    std::lock_guard lock(storage.mutex);
+
+    if (storage.binaryWriter != nullptr) {
+        return true;
+    }
+
+    auto file = std::make_unique<std::ofstream>(_path, std::ios::binary | std::ios::trunc);
+    if (!file->is_open()) {
+        return false;
+    }
+
+    storage.binaryWriter = std::make_unique<BinaryLogWriter>(*file);
+    storage.file = std::move(file);
+    g_binaryWriter.store(storage.binaryWriter.get(), std::memory_order_release);
+
+    return true;
+}
+
+void LogHelper::enableBinary(std::ostream &_os, BinaryLogWriter::Output _output) {
+    auto &storage = writerStorage();
+    std::lock_guard lock(storage.mutex);
+
+    if (storage.binaryWriter != nullptr) {
+        return;
+    }
+
+    storage.binaryWriter = std::make_unique<BinaryLogWriter>(_os, _output, BinaryLogDecoder::Options{timestampFormatter()});
+    g_binaryWriter.store(storage.binaryWriter.get(), std::memory_order_release);
+}
+
+void LogHelper::disableBinary() {
+    auto &storage = writerStorage();
+    // the writer is destroyed before the file it writes to.
+    std::unique_ptr<std::ofstream> file;
+    std::unique_ptr<BinaryLogWriter> writer;
+    {
+        std::lock_guard lock(storage.mutex);
+        g_binaryWriter.store(nullptr);
+        writer = std::move(storage.binaryWriter);
+        file = std::move(storage.file);
+    }
+
+    if (writer != nullptr) {
+        writer->stop();
+        waitForSinkReaders(currentSinkReader());
+    }
+}
+
+void LogHelper::enableFlightRecorder(const FlightRecorder::Options &_options) {
+    FlightRecorder::enable(_options, &writeRecorded);
+}
+
+void LogHelper::disableFlightRecorder() {
+    FlightRecorder::disable();
+    FlightRecorder::dump();
+}
+
+void LogHelper::flush() {
+    SinkGuard guard;
+    if (auto *writer = g_binaryWriter.load(); writer != nullptr) {
+        writer->flush();
+    }
+
+    if (auto *writer = g_asyncWriter.load(); writer != nullptr) {
+        writer->flush();
+    }
+
+    guard.sink().flush();
+}
+
+void LogHelper::beginRecord() {
+    if constexpr (LogMetrics::Enabled) {
+        m_start = LogMetrics::now();
+    }
+
+    const auto formatter = g_timestampFormatter.load(std::memory_order_relaxed);
+
+    m_binary = g_binaryWriter.load(std::memory_order_acquire) != nullptr;
+    if (m_binary) {
+        const auto siteId = m_site != nullptr ? BinaryLogWriter::siteId(*m_site) : 0;
+        BinaryLogFormat::beginRecord(m_record->buffer, static_cast<std::uint8_t>(m_logLevel), siteId, formatter.now());
+        return;
+    }
+
+    char timestamp[TimestampFormatter::MaxSize + 1];
+    auto size = formatter.format(timestamp);
+
+    m_format = g_recordFormat.load(std::memory_order_relaxed);
+    if (m_format != RecordFormat::Text) {
+        StructuredLogFormat::beginRecord(m_record->fields, m_format, std::string_view(timestamp, size), m_logLevel);
+        return;
     }
 
-    return m_ostream->ostream;
+    timestamp[size++] = ' ';
+
+    m_record->buffer << std::string_view(timestamp, size);
+}
+
+std::basic_ostream<char> &LogHelper::stream() {
+    // the buffer may have grown since the last write to the stream.
+    m_record->streamBuff.pubsync();
+    m_record->streamUsed = true;
+
+    return m_record->ostream;
 }
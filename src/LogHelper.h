@@ -1,9 +1,39 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <optional>
+#include <ostream>
 
+#include "AsyncLogWriter.h"
+#include "BinaryLogWriter.h"
 #include "CharFastStackBuffer.h"
 #include "FastStackStreamBuffer.h"
+#include "FlightRecorder.h"
+#include "LogLimiter.h"
+#include "LogMetrics.h"
+#include "LogSink.h"
+#include "StackMemoryResource.h"
+#include "StructuredLogFormat.h"
+#include "TimestampFormatter.h"
+
+/*!
+ * @brief The numeric values of the logging levels, usable in the preprocessor.
+ */
+#define STDCORE_LOG_LEVEL_CRITICAL 0
+#define STDCORE_LOG_LEVEL_ERROR 1
+#define STDCORE_LOG_LEVEL_WARNING 2
+#define STDCORE_LOG_LEVEL_INFORMATION 3
+
+/*!
+ * @brief The least severe logging level compiled in. Statements of less severe levels are compiled out.
+ */
+#ifndef STDCORE_LOG_MIN_LEVEL
+#define STDCORE_LOG_MIN_LEVEL STDCORE_LOG_LEVEL_INFORMATION
+#endif
 
 /*!
  * @brief LogHelper - class foк logging.
@@ -13,12 +43,7 @@ public:
     /*!
      * @brief Logging level.
      */
-    enum class LogLevel {
-        Critical,
-        Error,
-        Warning,
-        Information
-    };
+    using LogLevel = ::LogLevel;
 
     /*!
      * @brief Construct a new LogHelper object
@@ -26,65 +51,501 @@ public:
      */
     explicit LogHelper(LogLevel _logLevel = LogLevel::Warning);
 
+    /*!
+     * @brief Construct a new LogHelper object
+     * @param _logLevel - login level.
+     * @param _site - the logging statement, it must have the static storage duration.
+     */
+    LogHelper(LogLevel _logLevel, const LogSite &_site);
+
+    /*!
+     * @brief Construct a new LogHelper object of the rate limited statement, the limiter has allowed the record.
+     * If the suppression summary is enabled and the limiter has suppressed records, the summary record is written first.
+     * @param _logLevel - login level.
+     * @param _site - the logging statement, it must have the static storage duration.
+     * @param _limiter - the limiter of the statement.
+     */
+    LogHelper(LogLevel _logLevel, const LogSite &_site, LogLimiter &_limiter);
+
     /*!
      * @brief Destroy the LogHelper object
      */
     ~LogHelper();
 
+    LogHelper(const LogHelper &) = delete;
+    LogHelper &operator=(const LogHelper &) = delete;
+
+    /*!
+     * @brief Returns the memory resource of the record, a scope of the thread resource: the transient allocations
+     * made while the record is built, e.g. std::pmr::string or UserException messages, cost a few pointer bumps
+     * and are released at once after the record is written. They must not be used after the LogHelper is destroyed.
+     */
+    [[nodiscard]]
+    std::pmr::memory_resource *memoryResource() noexcept {
+        if (!m_memoryScope) {
+            m_memoryScope.emplace();
+        }
+
+        return m_memoryScope->resource();
+    }
+
+    /*!
+     * @brief The maximum size of a record.
+     */
+    static constexpr std::size_t RecordCapacity = STDCORE_LOG_RECORD_CAPACITY;
+
+    /*!
+     * @brief The default period of the suppression summary.
+     */
+    static constexpr std::chrono::milliseconds DefaultSuppressionSummaryInterval{1000};
+
+    /*!
+     * @brief Sets the least severe logging level which is written. Records of less severe levels are skipped.
+     */
+    static void setLogLevel(LogLevel _logLevel) noexcept;
+
+    /*!
+     * @brief Returns the least severe logging level which is written.
+     */
+    [[nodiscard]]
+    static LogLevel logLevel() noexcept;
+
+    /*!
+     * @brief Returns true if the level is not compiled out by STDCORE_LOG_MIN_LEVEL.
+     */
+    [[nodiscard]]
+    static constexpr bool isCompiledIn(LogLevel _logLevel) noexcept {
+        return static_cast<int>(_logLevel) <= STDCORE_LOG_MIN_LEVEL;
+    }
+
+    /*!
+     * @brief Returns true if records of the level are written. Costs one relaxed atomic load.
+     */
+    [[nodiscard]]
+    static bool isEnabled(LogLevel _logLevel) noexcept {
+        return isCompiledIn(_logLevel) && _logLevel <= s_logLevel.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief Sets the formatter of the record time stamps. The Tsc clock source is calibrated by the call, which then
+     * takes about 10 ms once per process.
+     */
+    static void setTimestampFormatter(TimestampFormatter _formatter) noexcept;
+
+    /*!
+     * @brief Returns the formatter of the record time stamps.
+     */
+    [[nodiscard]]
+    static TimestampFormatter timestampFormatter() noexcept;
+
+    /*!
+     * @brief Sets the format of the text records. Json and Logfmt write the timestamp, the level, the kv() fields
+     * and the message as fields, Text writes the kv() fields into the message as "key=value".
+     * The binary mode always keeps the fields in the message.
+     */
+    static void setRecordFormat(RecordFormat _format) noexcept;
+
+    /*!
+     * @brief Returns the format of the text records.
+     */
+    [[nodiscard]]
+    static RecordFormat recordFormat() noexcept;
+
+    /*!
+     * @brief Enables the "suppressed N messages" record of the rate limited statements. It is disabled by default.
+     * A statement writes it before its next allowed record; a background thread, started by the first call, writes it
+     * every interval for the statements which have suppressed records since, e.g. the STDCORE_LOG_FIRST_N ones.
+     * A statement is summarized once it has written a record.
+     * @param _enabled - true to write the summary.
+     * @param _interval - the period of the background summary.
+     */
+    static void setSuppressionSummary(bool _enabled, std::chrono::milliseconds _interval = DefaultSuppressionSummaryInterval);
+
+    /*!
+     * @brief Returns true if the suppression summary is enabled.
+     */
+    [[nodiscard]]
+    static bool suppressionSummary() noexcept;
+
+    /*!
+     * @brief Turns the logging expression into void, it is used by the STDCORE_LOG macro.
+     */
+    struct Voidify {
+        void operator&(const LogHelper &) const noexcept {}
+    };
+
+    /*!
+     * @brief Sets the sink of the text records. The default sink is StderrLogSink, which writes every record at once.
+     * The call waits until no record of another thread uses the previous sink, then flushes and releases it. A sink may
+     * call it from its write() or flush(), e.g. to fall back on an I/O error; the previous sink is then flushed and
+     * released when the calling thread leaves it. The asynchronous
+     * writer follows the change. A buffering sink keeps the records until its flush policy, flush() or exit writes them;
+     * the time limit of the policy is checked by a background thread started by the first call.
+     * @param _sink - the sink or nullptr to restore the default one.
+     */
+    static void setSink(std::shared_ptr<LogSink> _sink);
+
+    /*!
+     * @brief Returns the sink of the text records. The reference is valid until the sink is replaced by setSink().
+     */
+    [[nodiscard]]
+    static LogSink &sink() noexcept;
+
+    /*!
+     * @brief Switches logging to the asynchronous mode. Records are written to the current sink, see setSink(), by a background thread.
+     * Does nothing if the asynchronous mode is already enabled.
+     * @param _queueCapacity - number of records the queue holds.
+     * @param _policy - full queue policy.
+     */
+    static void enableAsync(std::size_t _queueCapacity = AsyncLogWriter::DefaultQueueCapacity,
+                            AsyncLogWriter::OverflowPolicy _policy = AsyncLogWriter::OverflowPolicy::Block);
+
+    /*!
+     * @brief Writes all queued records and switches logging back to the synchronous mode.
+     */
+    static void disableAsync();
+
+    /*!
+     * @brief Switches logging to the binary mode. Records keep the raw arguments instead of the text, they are staged
+     * per thread and written to the file by a background thread. StdCoreLogDecoder turns the file into text.
+     * The binary mode takes precedence over the asynchronous mode. Does nothing if the binary mode is already enabled.
+     * @param _path - binary log file path.
+     * @return false if the file cannot be opened.
+     */
+    static bool enableBinary(const std::string &_path);
+
+    /*!
+     * @brief Switches logging to the binary mode.
+     * @param _os - output stream, it must outlive the binary mode.
+     * @param _output - Binary writes the binary log, Text writes text records formatted by the background thread.
+     */
+    static void enableBinary(std::ostream &_os, BinaryLogWriter::Output _output = BinaryLogWriter::Output::Binary);
+
+    /*!
+     * @brief Writes all staged records and switches logging back to the text mode.
+     */
+    static void disableBinary();
+
+    /*!
+     * @brief Enables the flight recorder: the records less severe than Options::sinkLevel are kept in the memory buffer
+     * of their thread and written to the current sink or binary writer only when the buffer is dumped, e.g. by a record
+     * of Options::dumpLevel. The records are still filtered by logLevel(), set it to Information to record all of them.
+     * @param _options - the recorder options.
+     */
+    static void enableFlightRecorder(const FlightRecorder::Options &_options = {});
+
+    /*!
+     * @brief Writes the recorded records and disables the flight recorder.
+     */
+    static void disableFlightRecorder();
+
+    /*!
+     * @brief Blocks until all records logged before the call are written.
+     */
+    static void flush();
+
 private:
+    /*!
+     * @brief The least severe logging level which is written.
+     */
+    inline static std::atomic<LogLevel> s_logLevel{LogLevel::Information};
+
     /*!
      * @brief The Loging level.
      */
     LogLevel m_logLevel;
 
     /*!
-     * @brief Stack buffer.
+     * @brief The record is written, its level is enabled.
      */
-    CharFastStackBuffer<char, 1024> m_buffer;
+    bool m_enabled;
 
     /*!
-     * @brief Redirects the output stream.
+     * @brief The logging statement or nullptr if it is unknown.
      */
-    struct LazyInitedStream {
-        explicit LazyInitedStream(CharFastStackBuffer<char, 1024> &_buff) : streamBuff(_buff),
-                                                                            ostream(&streamBuff) {}
+    const LogSite *m_site;
 
-        FastStackStreamBuffer<char, 1024> streamBuff;
+    /*!
+     * @brief The record is encoded in the binary format, the binary writer is loaded again when the record ends.
+     */
+    bool m_binary = false;
+
+    /*!
+     * @brief The format of the record.
+     */
+    RecordFormat m_format = RecordFormat::Text;
+
+    /*!
+     * @brief The scope of the thread memory resource, it is opened by memoryResource() and closed after the record is written.
+     */
+    std::optional<MemoryResourceScope> m_memoryScope;
+
+    /*!
+     * @brief The start of the record, it is taken if LogMetrics is enabled.
+     */
+    std::chrono::steady_clock::time_point m_start;
+
+    /*!
+     * @brief The record buffer. A record which does not fit is truncated and ends with the truncation marker.
+     */
+    using RecordBuffer = CharFastStackBuffer<char, RecordCapacity, TruncateWithMarkerOnOverflow>;
+
+    static_assert(RecordCapacity <= BinaryLogWriter::StagingCapacity, "a binary record must fit into the staging buffer");
+
+    /*!
+     * @brief The record buffer with the output stream over it. The records are pooled per thread,
+     * so the stream and its locale are built once per thread instead of once per record.
+     */
+    struct Record {
+        Record() : streamBuff(buffer), ostream(&streamBuff) {}
+
+        Record(const Record &) = delete;
+        Record &operator=(const Record &) = delete;
+
+        /*!
+         * @brief Clears the buffer and restores the default stream format if the stream has been used.
+         * A locale set by imbue() is kept.
+         */
+        void reset() noexcept;
+
+        //! The message.
+        RecordBuffer buffer;
+        //! The structured record: the header and the fields, the message is appended at the end.
+        RecordBuffer fields;
+        //! The field value formatted before it is escaped.
+        RecordBuffer scratch;
+        FastStackStreamBuffer<char, RecordCapacity, TruncateWithMarkerOnOverflow> streamBuff;
         std::basic_ostream<char> ostream;
+        bool streamUsed = false;
     };
 
     /*!
-     * @brief output stream.
+     * @brief The record taken from the pool of the thread, nullptr if the level is disabled.
+     */
+    Record *m_record = nullptr;
+
+    /*!
+     * @brief The records of a thread which are not in use.
      */
-    std::optional<LazyInitedStream> m_ostream;
+    struct RecordPool;
 
     /*!
-     * @brief Returns the current time stamp.
+     * @brief Takes a reset record from the pool of the thread or creates one.
      */
-    std::string timestamp() const noexcept;
+    static Record *acquireRecord();
 
     /*!
-     * @brief Returns the output stream reference.
+     * @brief Returns the record to the pool of the thread.
+     */
+    static void releaseRecord(Record *_record) noexcept;
+
+    /*!
+     * @brief Writes the current time stamp to the buffer in the text mode or the record header in the binary mode.
+     */
+    void beginRecord();
+
+    /*!
+     * @brief Passes the finished record to the writer of the current mode.
+     */
+    void endRecord();
+
+    /*!
+     * @brief Returns the output stream reference. The stream writes to the free part of the buffer.
      */
     std::basic_ostream<char> &stream();
 
+    /*!
+     * @brief Formats the value into the scratch buffer of the record.
+     * @return The view of the formatted value.
+     */
+    template<class V>
+    std::string_view formatValue(const V &_value);
+
     /*!
      * @brief Streaming operator.
      */
     template<class T>
     friend LogHelper &operator<<(LogHelper &_lh, const T &_val);
+
+    /*!
+     * @brief Streaming operator for the structured fields.
+     */
+    template<class V>
+    friend LogHelper &operator<<(LogHelper &_lh, const KeyValue<V> &_field);
 };
 
+template<class V>
+std::string_view LogHelper::formatValue(const V &_value) {
+    auto &scratch = m_record->scratch;
+    scratch.clear();
+
+    if constexpr (IsBufferFormattable_v<V>) {
+        scratch << _value;
+    } else {
+        m_record->streamBuff.setBuffer(scratch);
+        stream() << _value;
+        m_record->streamBuff.setBuffer(m_record->buffer);
+    }
+
+    return scratch.view();
+}
+
 template<class T>
 LogHelper &operator<<(LogHelper &_lh, const T &_val) {
-    if constexpr (std::is_convertible_v<T, std::string_view>
-                  || std::is_base_of_v<std::exception, T>
-                  || std::is_integral_v<T>
-                  || std::is_floating_point_v<T>) {
-        _lh.m_buffer << _val;
+    if (!_lh.m_enabled) {
+        return _lh;
+    }
+
+    auto &record = *_lh.m_record;
+    if (_lh.m_binary) {
+        if constexpr (IsBufferFormattable_v<T>) {
+            BinaryLogFormat::encode(record.buffer, _val);
+        } else {
+            const auto position = BinaryLogFormat::beginString(record.buffer);
+            if (position == BinaryLogFormat::NoPosition) {
+                return _lh;
+            }
+
+            _lh.stream() << _val;
+            record.streamBuff.pubsync();
+            BinaryLogFormat::endString(record.buffer, position);
+        }
+
+        return _lh;
+    }
+
+    if constexpr (IsBufferFormattable_v<T>) {
+        record.buffer << _val;
     } else {
         _lh.stream() << _val;
+        // commits the written chars to the buffer.
+        record.streamBuff.pubsync();
     }
 
     return _lh;
-}
\ No newline at end of file
+}
+
+template<class V>
+LogHelper &operator<<(LogHelper &_lh, const KeyValue<V> &_field) {
+    if (!_lh.m_enabled) {
+        return _lh;
+    }
+
+    if (_lh.m_binary || _lh.m_format == RecordFormat::Text) {
+        const auto message = _lh.m_record->buffer.view();
+        if (_lh.m_binary || (!message.empty() && message.back() != ' ')) {
+            _lh << ' ';
+        }
+
+        return _lh << _field.key << '=' << _field.value;
+    }
+
+    auto &fields = _lh.m_record->fields;
+    if constexpr (std::is_arithmetic_v<V> || std::is_convertible_v<const V &, std::string_view>) {
+        StructuredLogFormat::writeField(fields, _lh.m_format, _field.key, _field.value);
+    } else {
+        StructuredLogFormat::writeField(fields, _lh.m_format, _field.key, _lh.formatValue(_field.value));
+    }
+
+    return _lh;
+}
+
+/*!
+ * @brief Streaming operator for the temporary LogHelper.
+ */
+template<class T>
+LogHelper &operator<<(LogHelper &&_lh, const T &_val) {
+    return _lh << _val;
+}
+
+/*!
+ * @brief Returns the LogSite of the statement. The site is constant-initialized, so there is no initialization guard.
+ */
+#define STDCORE_LOG_SITE()                                          \
+    []() -> const LogSite & {                                       \
+        static const LogSite site(__FILE__, __LINE__);              \
+        return site;                                                \
+    }()
+
+/*!
+ * @brief Logs a record of the level. If the level is disabled, the streamed arguments are not evaluated.
+ * Usage: STDCORE_LOG(LogHelper::LogLevel::Error) << "value: " << value;
+ */
+#define STDCORE_LOG(_logLevel)                \
+    !LogHelper::isEnabled(_logLevel) ? (void)0 \
+                                     : LogHelper::Voidify() & LogHelper(_logLevel, STDCORE_LOG_SITE())
+
+/*!
+ * @brief Expands to a statement which is never executed and folds away at compile time.
+ */
+#define STDCORE_LOG_DISABLED(_logLevel) \
+    true ? (void)0 : LogHelper::Voidify() & LogHelper(_logLevel)
+
+#define STDCORE_LOG_CRITICAL STDCORE_LOG(LogHelper::LogLevel::Critical)
+
+#if STDCORE_LOG_MIN_LEVEL >= STDCORE_LOG_LEVEL_ERROR
+#define STDCORE_LOG_ERROR STDCORE_LOG(LogHelper::LogLevel::Error)
+#else
+#define STDCORE_LOG_ERROR STDCORE_LOG_DISABLED(LogHelper::LogLevel::Error)
+#endif
+
+#if STDCORE_LOG_MIN_LEVEL >= STDCORE_LOG_LEVEL_WARNING
+#define STDCORE_LOG_WARNING STDCORE_LOG(LogHelper::LogLevel::Warning)
+#else
+#define STDCORE_LOG_WARNING STDCORE_LOG_DISABLED(LogHelper::LogLevel::Warning)
+#endif
+
+#if STDCORE_LOG_MIN_LEVEL >= STDCORE_LOG_LEVEL_INFORMATION
+#define STDCORE_LOG_INFORMATION STDCORE_LOG(LogHelper::LogLevel::Information)
+#else
+#define STDCORE_LOG_INFORMATION STDCORE_LOG_DISABLED(LogHelper::LogLevel::Information)
+#endif
+
+/*!
+ * @brief Returns the LimitedLogSite of the statement. The site is constant-initialized if the limiter arguments are constants.
+ */
+#define STDCORE_LOG_LIMITED_SITE(_Limiter_t, ...)                                     \
+    [&]() -> LimitedLogSite<_Limiter_t> & {                                           \
+        static LimitedLogSite<_Limiter_t> site(__FILE__, __LINE__, __VA_ARGS__);      \
+        return site;                                                                  \
+    }()
+
+/*!
+ * @brief Logs a record of the level through the LimitedLogSite if its limiter allows it. The limiter is checked after
+ * the level and before the time stamp is taken, a suppressed record does not evaluate the streamed arguments.
+ * The site stays registered for the suppression summary once it has written a record, so it must never be destroyed.
+ * The macro is a statement, it cannot be used as an expression.
+ */
+#define STDCORE_LOG_LIMITED_AT(_logLevel, _site)                                            \
+    if (auto &stdcoreLimitedSite_ = (_site);                                                \
+        !LogHelper::isEnabled(_logLevel) || !stdcoreLimitedSite_.limiter.allow()) {        \
+    } else                                                                                  \
+        LogHelper::Voidify() & LogHelper(_logLevel, stdcoreLimitedSite_, stdcoreLimitedSite_.limiter)
+
+/*!
+ * @brief Logs a record of the level if the limiter of the statement allows it, see STDCORE_LOG_LIMITED_AT.
+ */
+#define STDCORE_LOG_LIMITED(_logLevel, _Limiter_t, ...) \
+    STDCORE_LOG_LIMITED_AT(_logLevel, STDCORE_LOG_LIMITED_SITE(_Limiter_t, __VA_ARGS__))
+
+/*!
+ * @brief Logs the 1st, (N+1)th, (2N+1)th... record of the statement.
+ * Usage: STDCORE_LOG_EVERY_N(LogHelper::LogLevel::Warning, 100) << "queue is full";
+ */
+#define STDCORE_LOG_EVERY_N(_logLevel, _n) STDCORE_LOG_LIMITED(_logLevel, LogEveryN, _n)
+
+/*!
+ * @brief Logs the first N records of the statement.
+ */
+#define STDCORE_LOG_FIRST_N(_logLevel, _n) STDCORE_LOG_LIMITED(_logLevel, LogFirstN, _n)
+
+/*!
+ * @brief Logs at most one record of the statement per interval, e.g. std::chrono::seconds(1).
+ */
+#define STDCORE_LOG_EVERY_INTERVAL(_logLevel, _interval) STDCORE_LOG_LIMITED(_logLevel, LogEveryInterval, _interval)
+
+/*!
+ * @brief Logs the records of the statement at the average rate per second with bursts up to the bucket size.
+ */
+#define STDCORE_LOG_RATE_LIMITED(_logLevel, _perSecond, _burst) \
+    STDCORE_LOG_LIMITED(_logLevel, LogTokenBucket, _perSecond, _burst)
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string_view>
+
+/*!
+ * @brief The maximum size of a text log record, longer records are truncated. The library and its users must agree on it,
+ * set it by the STDCORE_LOG_RECORD_CAPACITY CMake cache variable.
+ */
+#ifndef STDCORE_LOG_RECORD_CAPACITY
+#define STDCORE_LOG_RECORD_CAPACITY 1024
+#endif
+
+/*!
+ * @brief Logging level. The lower the value, the more severe the level.
+ */
+enum class LogLevel {
+    Critical,
+    Error,
+    Warning,
+    Information
+};
+
+/*!
+ * @brief Returns the name of the logging level, e.g. "Error", or "Unknown".
+ */
+constexpr std::string_view logLevelName(LogLevel _level) noexcept {
+    switch (_level) {
+        case LogLevel::Critical:
+            return "Critical";
+        case LogLevel::Error:
+            return "Error";
+        case LogLevel::Warning:
+            return "Warning";
+        case LogLevel::Information:
+            return "Information";
+    }
+
+    return "Unknown";
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "BinaryLogFormat.h"
+#include "LogMetrics.h"
+
+/*!
+ * @brief LogLimiter is the base of the per-site limiters used by the STDCORE_LOG_EVERY_N, STDCORE_LOG_FIRST_N,
+ * STDCORE_LOG_EVERY_INTERVAL and STDCORE_LOG_RATE_LIMITED macros. A limiter decides by a few relaxed atomic operations,
+ * before the record takes the timestamp or formats anything, and counts the suppressed records.
+ */
+class LogLimiter {
+public:
+    /*!
+     * @brief Returns the number of the records suppressed since the last call and resets it.
+     */
+    std::uint64_t takeSuppressed() noexcept {
+        // the load keeps the cache line shared while nothing is suppressed.
+        return m_suppressed.load(std::memory_order_relaxed) == 0 ? 0 : m_suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    /*!
+     * @brief Returns true on the first call only, the caller registers the limiter for the periodic suppression summary.
+     */
+    bool registerOnce() noexcept {
+        return !m_registered.load(std::memory_order_relaxed) && !m_registered.exchange(true, std::memory_order_relaxed);
+    }
+
+protected:
+    constexpr LogLimiter() noexcept = default;
+
+    /*!
+     * @brief Counts the suppressed record.
+     * @return false.
+     */
+    bool suppress() noexcept {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        if constexpr (LogMetrics::Enabled) {
+            LogMetrics::add(LogMetrics::Counter::Suppressed);
+        }
+
+        return false;
+    }
+
+    /*!
+     * @brief Returns the steady clock time in nanoseconds.
+     */
+    static std::int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+private:
+    /*!
+     * @brief Number of the suppressed records.
+     */
+    std::atomic<std::uint64_t> m_suppressed{0};
+    /*!
+     * @brief The limiter has been registered for the periodic suppression summary.
+     */
+    std::atomic<bool> m_registered{false};
+};
+
+/*!
+ * @brief LogEveryN allows the 1st, (N+1)th, (2N+1)th... record.
+ */
+class LogEveryN : public LogLimiter {
+public:
+    /*!
+     * @brief Construct a new LogEveryN object.
+     * @param _n - the period, 0 is treated as 1.
+     */
+    constexpr explicit LogEveryN(std::uint64_t _n) noexcept : m_n(_n == 0 ? 1 : _n) {}
+
+    /*!
+     * @brief Returns true if the record is written.
+     */
+    bool allow() noexcept {
+        return m_count.fetch_add(1, std::memory_order_relaxed) % m_n == 0 || suppress();
+    }
+
+private:
+    const std::uint64_t m_n;
+    std::atomic<std::uint64_t> m_count{0};
+};
+
+/*!
+ * @brief LogFirstN allows the first N records.
+ */
+class LogFirstN : public LogLimiter {
+public:
+    /*!
+     * @brief Construct a new LogFirstN object.
+     * @param _n - number of the written records.
+     */
+    constexpr explicit LogFirstN(std::uint64_t _n) noexcept : m_n(_n) {}
+
+    /*!
+     * @brief Returns true if the record is written.
+     */
+    bool allow() noexcept {
+        // the load keeps the counter from growing once the limit has been reached.
+        if (m_count.load(std::memory_order_relaxed) >= m_n) {
+            return suppress();
+        }
+
+        return m_count.fetch_add(1, std::memory_order_relaxed) < m_n || suppress();
+    }
+
+private:
+    const std::uint64_t m_n;
+    std::atomic<std::uint64_t> m_count{0};
+};
+
+/*!
+ * @brief LogEveryInterval allows at most one record per interval.
+ */
+class LogEveryInterval : public LogLimiter {
+public:
+    /*!
+     * @brief Construct a new LogEveryInterval object.
+     * @param _interval - the interval.
+     */
+    constexpr explicit LogEveryInterval(std::chrono::nanoseconds _interval) noexcept : m_interval(_interval.count()) {}
+
+    /*!
+     * @brief Returns true if the record is written.
+     */
+    bool allow() noexcept {
+        const auto time = now();
+        auto next = m_next.load(std::memory_order_relaxed);
+
+        return (time >= next && m_next.compare_exchange_strong(next, time + m_interval, std::memory_order_relaxed)) || suppress();
+    }
+
+private:
+    const std::int64_t m_interval;
+    /*!
+     * @brief The time the next record is allowed.
+     */
+    std::atomic<std::int64_t> m_next{0};
+};
+
+/*!
+ * @brief LogTokenBucket allows the records at the average rate with bursts up to the bucket size.
+ * The bucket is a single atomic: the theoretical arrival time of the generic cell rate algorithm.
+ */
+class LogTokenBucket : public LogLimiter {
+public:
+    /*!
+     * @brief Construct a new LogTokenBucket object.
+     * @param _perSecond - the average number of the records per second, 0 is treated as 1.
+     * @param _burst - the bucket size, 0 is treated as 1.
+     */
+    constexpr LogTokenBucket(std::uint64_t _perSecond, std::uint64_t _burst) noexcept
+            : m_emissionInterval(1'000'000'000 / static_cast<std::int64_t>(_perSecond == 0 ? 1 : _perSecond)),
+              m_tolerance(m_emissionInterval * static_cast<std::int64_t>(_burst == 0 ? 0 : _burst - 1)) {}
+
+    /*!
+     * @brief Returns true if the record is written.
+     */
+    bool allow() noexcept {
+        const auto time = now();
+        auto arrival = m_arrival.load(std::memory_order_relaxed);
+        do {
+            if (time < arrival - m_tolerance) {
+                return suppress();
+            }
+        } while (!m_arrival.compare_exchange_weak(arrival, std::max(arrival, time) + m_emissionInterval, std::memory_order_relaxed));
+
+        return true;
+    }
+
+private:
+    /*!
+     * @brief The time one token takes to refill, in nanoseconds.
+     */
+    const std::int64_t m_emissionInterval;
+    /*!
+     * @brief The time the bucket takes to refill, without one token.
+     */
+    const std::int64_t m_tolerance;
+    /*!
+     * @brief The theoretical arrival time of the next record.
+     */
+    std::atomic<std::int64_t> m_arrival{0};
+};
+
+/*!
+ * @brief LimitedLogSite is the LogSite with the limiter of the statement.
+ */
+template<class Limiter_t>
+struct LimitedLogSite : LogSite {
+    template<class... Args_t>
+    constexpr LimitedLogSite(const char *_file, int _line, Args_t... _args) noexcept : LogSite(_file, _line), limiter(_args...) {}
+
+    Limiter_t limiter;
+};
@@ -0,0 +1,191 @@
+#include "LogMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace {
+/*!
+ * @brief The counters of a thread. Only the owner thread writes them, so an update is a relaxed load and store.
+ */
+struct ThreadMetrics {
+    std::array<std::atomic<std::uint64_t>, LogMetrics::LevelCount> records{};
+    std::array<std::atomic<std::uint64_t>, LogMetrics::CounterCount> counters{};
+
+    struct Histogram {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sumNs{0};
+        std::array<std::atomic<std::uint64_t>, LogMetrics::Histogram::BucketCount> buckets{};
+    };
+
+    std::array<Histogram, LogMetrics::LatencyCount> latencies{};
+};
+
+void increment(std::atomic<std::uint64_t> &_value, std::uint64_t _delta) noexcept {
+    _value.store(_value.load(std::memory_order_relaxed) + _delta, std::memory_order_relaxed);
+}
+
+/*!
+ * @brief Guards the registry of the threads and the counters of the finished threads.
+ */
+std::mutex g_metricsMutex;
+
+/*!
+ * @brief The counters of the running threads.
+ */
+std::vector<ThreadMetrics *> g_threadMetrics;
+
+/*!
+ * @brief The merged counters of the finished threads.
+ */
+LogMetrics::Snapshot g_finishedMetrics;
+
+/*!
+ * @brief Adds the counters of the thread to the snapshot.
+ */
+void merge(const ThreadMetrics &_metrics, LogMetrics::Snapshot &_snapshot) noexcept {
+    for (std::size_t i = 0; i < _metrics.records.size(); ++i) {
+        _snapshot.records[i] += _metrics.records[i].load(std::memory_order_relaxed);
+    }
+
+    for (std::size_t i = 0; i < _metrics.counters.size(); ++i) {
+        _snapshot.counters[i] += _metrics.counters[i].load(std::memory_order_relaxed);
+    }
+
+    for (std::size_t i = 0; i < _metrics.latencies.size(); ++i) {
+        const auto &latency = _metrics.latencies[i];
+        auto &histogram = _snapshot.latencies[i];
+        histogram.count += latency.count.load(std::memory_order_relaxed);
+        histogram.sumNs += latency.sumNs.load(std::memory_order_relaxed);
+        for (std::size_t bucket = 0; bucket < histogram.buckets.size(); ++bucket) {
+            histogram.buckets[bucket] += latency.buckets[bucket].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/*!
+ * @brief Registers the counters of the thread and merges them into g_finishedMetrics when the thread finishes.
+ */
+struct ThreadMetricsHolder {
+    ThreadMetricsHolder() {
+        std::lock_guard lock(g_metricsMutex);
+        g_threadMetrics.push_back(&metrics);
+    }
+
+    ~ThreadMetricsHolder();
+
+    ThreadMetrics metrics;
+};
+
+/*!
+ * @brief The counters of the thread have been destroyed, the updates made by later thread_local destructors are not counted.
+ */
+thread_local bool t_metricsDestroyed = false;
+
+ThreadMetricsHolder::~ThreadMetricsHolder() {
+    t_metricsDestroyed = true;
+
+    std::lock_guard lock(g_metricsMutex);
+    merge(metrics, g_finishedMetrics);
+    g_threadMetrics.erase(std::find(g_threadMetrics.begin(), g_threadMetrics.end(), &metrics));
+}
+
+/*!
+ * @brief Returns the counters of the thread or nullptr if they have been destroyed.
+ */
+ThreadMetrics *threadMetrics() noexcept {
+    if (t_metricsDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadMetricsHolder holder;
+    return &holder.metrics;
+}
+}  // namespace
+
+std::uint64_t LogMetrics::Histogram::quantileNs(double _quantile) const noexcept {
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto rank = static_cast<std::uint64_t>(std::clamp(_quantile, 0.0, 1.0) * static_cast<double>(count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::uint64_t(1) << i;
+        }
+    }
+
+    return std::uint64_t(1) << (buckets.size() - 1);
+}
+
+void LogMetrics::add(Counter _counter, std::uint64_t _value) noexcept {
+    if (auto *metrics = threadMetrics(); metrics != nullptr) {
+        increment(metrics->counters[static_cast<std::size_t>(_counter)], _value);
+    }
+}
+
+void LogMetrics::addRecord(LogLevel _level, std::size_t _bytes, bool _truncated) noexcept {
+    auto *metrics = threadMetrics();
+    if (metrics == nullptr) {
+        return;
+    }
+
+    increment(metrics->records[std::min(static_cast<std::size_t>(_level), LevelCount - 1)], 1);
+    increment(metrics->counters[static_cast<std::size_t>(Counter::Bytes)], _bytes);
+    if (_truncated) {
+        increment(metrics->counters[static_cast<std::size_t>(Counter::Truncated)], 1);
+    }
+}
+
+void LogMetrics::addLatency(Latency _latency, std::chrono::nanoseconds _duration) noexcept {
+    auto *metrics = threadMetrics();
+    if (metrics == nullptr) {
+        return;
+    }
+
+    const auto ns = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(_duration.count(), 0));
+    std::size_t bucket = 0;
+    for (auto value = ns; value != 0 && bucket + 1 < Histogram::BucketCount; value >>= 1) {
+        ++bucket;
+    }
+
+    auto &histogram = metrics->latencies[static_cast<std::size_t>(_latency)];
+    increment(histogram.count, 1);
+    increment(histogram.sumNs, ns);
+    increment(histogram.buckets[bucket], 1);
+}
+
+LogMetrics::Snapshot LogMetrics::snapshot() {
+    std::lock_guard lock(g_metricsMutex);
+
+    auto snapshot = g_finishedMetrics;
+    for (const auto *metrics : g_threadMetrics) {
+        merge(*metrics, snapshot);
+    }
+
+    return snapshot;
+}
+
+void LogMetrics::reset() {
+    std::lock_guard lock(g_metricsMutex);
+
+    g_finishedMetrics = Snapshot();
+    for (auto *metrics : g_threadMetrics) {
+        for (auto &value : metrics->records) {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (auto &value : metrics->counters) {
+            value.store(0, std::memory_order_relaxed);
+        }
+        for (auto &histogram : metrics->latencies) {
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.sumNs.store(0, std::memory_order_relaxed);
+            for (auto &value : histogram.buckets) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "LogLevel.h"
+
+/*!
+ * @brief The metrics are compiled in. If it is 0, the library does not update them and snapshot() returns zeros.
+ */
+#ifndef STDCORE_METRICS
+#define STDCORE_METRICS 1
+#endif
+
+/*!
+ * @brief LogMetrics counts what the logger costs. Every thread updates its own counters without atomic read-modify-write
+ * operations, snapshot() merges the counters of the running threads with the counters of the finished ones.
+ */
+class LogMetrics {
+public:
+    /*!
+     * @brief The metrics are compiled in. The instrumented code checks it with if constexpr.
+     */
+    static constexpr bool Enabled = STDCORE_METRICS != 0;
+
+    /*!
+     * @brief The counters.
+     */
+    enum class Counter : std::size_t {
+        //! The bytes of the text and binary records passed to the writers.
+        Bytes,
+        //! The records which did not fit into the record buffer.
+        Truncated,
+        //! The records dropped by the overflow policy of AsyncLogWriter.
+        Dropped,
+        //! The records suppressed by the rate limited statements.
+        Suppressed,
+        //! The constructed UserException objects.
+        Exceptions,
+        //! The constructed UserException objects with a nested exception.
+        NestedExceptions
+    };
+
+    static constexpr std::size_t CounterCount = static_cast<std::size_t>(Counter::NestedExceptions) + 1;
+
+    /*!
+     * @brief The latency histograms.
+     */
+    enum class Latency : std::size_t {
+        //! From the start of the record to its end, including the time stamp.
+        Format,
+        //! LogSink::write() of a record, in the logging thread or in the AsyncLogWriter thread.
+        SinkWrite
+    };
+
+    static constexpr std::size_t LatencyCount = static_cast<std::size_t>(Latency::SinkWrite) + 1;
+
+    static constexpr std::size_t LevelCount = static_cast<std::size_t>(LogLevel::Information) + 1;
+
+    /*!
+     * @brief The latency histogram with the power of two buckets: the bucket i counts the latencies
+     * in [2^(i-1), 2^i) nanoseconds, the last bucket counts the longer ones too.
+     */
+    struct Histogram {
+        static constexpr std::size_t BucketCount = 32;
+
+        std::uint64_t count = 0;
+        std::uint64_t sumNs = 0;
+        std::array<std::uint64_t, BucketCount> buckets{};
+
+        /*!
+         * @brief Returns the upper bound of the bucket which contains the quantile, in nanoseconds.
+         * @param _quantile - e.g. 0.99.
+         */
+        [[nodiscard]]
+        std::uint64_t quantileNs(double _quantile) const noexcept;
+
+        /*!
+         * @brief Returns the average latency in nanoseconds.
+         */
+        [[nodiscard]]
+        double averageNs() const noexcept {
+            return count == 0 ? 0.0 : static_cast<double>(sumNs) / static_cast<double>(count);
+        }
+    };
+
+    /*!
+     * @brief The merged metrics.
+     */
+    struct Snapshot {
+        //! The records per level, indexed by LogLevel.
+        std::array<std::uint64_t, LevelCount> records{};
+        std::array<std::uint64_t, CounterCount> counters{};
+        std::array<Histogram, LatencyCount> latencies{};
+
+        [[nodiscard]]
+        std::uint64_t recordCount(LogLevel _level) const noexcept { return records[static_cast<std::size_t>(_level)]; }
+
+        [[nodiscard]]
+        std::uint64_t counter(Counter _counter) const noexcept { return counters[static_cast<std::size_t>(_counter)]; }
+
+        [[nodiscard]]
+        const Histogram &latency(Latency _latency) const noexcept { return latencies[static_cast<std::size_t>(_latency)]; }
+    };
+
+    /*!
+     * @brief Adds the value to the counter of the thread.
+     */
+    static void add(Counter _counter, std::uint64_t _value = 1) noexcept;
+
+    /*!
+     * @brief Counts the written record.
+     * @param _level - the level of the record.
+     * @param _bytes - the size of the record.
+     * @param _truncated - the record did not fit into the record buffer.
+     */
+    static void addRecord(LogLevel _level, std::size_t _bytes, bool _truncated) noexcept;
+
+    /*!
+     * @brief Adds the latency to the histogram of the thread.
+     */
+    static void addLatency(Latency _latency, std::chrono::nanoseconds _duration) noexcept;
+
+    /*!
+     * @brief Returns the steady clock time used to measure the latencies.
+     */
+    static std::chrono::steady_clock::time_point now() noexcept {
+        return std::chrono::steady_clock::now();
+    }
+
+    /*!
+     * @brief Returns the merged metrics of all threads.
+     */
+    [[nodiscard]]
+    static Snapshot snapshot();
+
+    /*!
+     * @brief Resets the metrics. An update made by a running thread concurrently with the reset may survive it.
+     */
+    static void reset();
+};
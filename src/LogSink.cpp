@@ -0,0 +1,84 @@
+#include "LogSink.h"
+
+BufferedLogSink::BufferedLogSink(FlushPolicy _policy) : m_policy(_policy) {
+    m_pending.reserve(m_policy.maxBufferedBytes);
+}
+
+void BufferedLogSink::write(std::string_view _record, LogLevel _level) {
+    std::lock_guard lock(m_mutex);
+
+    if (_level <= m_policy.flushLevel || m_pending.size() + _record.size() + 1 > m_policy.maxBufferedBytes) {
+        writeLocked(&_record);
+        return;
+    }
+
+    if (m_policy.maxDelay.count() != 0) {
+        const auto now = std::chrono::steady_clock::now();
+        if (m_pending.empty()) {
+            m_pendingSince = now;
+        } else if (now - m_pendingSince >= m_policy.maxDelay) {
+            writeLocked(&_record);
+            return;
+        }
+    }
+
+    m_pending.append(_record).push_back('\n');
+}
+
+void BufferedLogSink::flush() {
+    std::lock_guard lock(m_mutex);
+
+    if (!m_pending.empty()) {
+        writeLocked(nullptr);
+    }
+
+    flushOutput();
+}
+
+void BufferedLogSink::flushIfDue() {
+    std::lock_guard lock(m_mutex);
+
+    if (!m_pending.empty() && m_policy.maxDelay.count() != 0 &&
+        std::chrono::steady_clock::now() - m_pendingSince >= m_policy.maxDelay) {
+        writeLocked(nullptr);
+    }
+}
+
+const FlushPolicy &BufferedLogSink::flushPolicy() const noexcept {
+    return m_policy;
+}
+
+std::size_t BufferedLogSink::outputCalls() const noexcept {
+    return m_outputCalls.load(std::memory_order_relaxed);
+}
+
+void BufferedLogSink::writeLocked(const std::string_view *_record) {
+    // the record is not copied into the buffer, the output writes it right after the kept records.
+    const std::string_view parts[] = {m_pending, _record != nullptr ? *_record : std::string_view(), "\n"};
+    const std::size_t first = m_pending.empty() ? 1 : 0;
+    const std::size_t last = _record != nullptr ? 3 : 1;
+
+    if (first < last) {
+        writeOutput(parts + first, last - first);
+        m_outputCalls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_pending.clear();
+}
+
+StreamLogSink::StreamLogSink(std::ostream &_os, FlushPolicy _policy) : BufferedLogSink(_policy), m_os(_os) {
+}
+
+StreamLogSink::~StreamLogSink() {
+    flush();
+}
+
+void StreamLogSink::writeOutput(const std::string_view *_parts, std::size_t _count) {
+    for (std::size_t i = 0; i < _count; ++i) {
+        m_os.write(_parts[i].data(), static_cast<std::streamsize>(_parts[i].size()));
+    }
+}
+
+void StreamLogSink::flushOutput() {
+    m_os.flush();
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "LogLevel.h"
+
+/*!
+ * @brief LogSink is the destination of the finished log records. The implementations are thread-safe.
+ */
+class LogSink {
+public:
+    /*!
+     * @brief Destroy the LogSink object.
+     */
+    virtual ~LogSink() = default;
+
+    /*!
+     * @brief Writes the record followed by a line feed. The sink may keep the record until flush().
+     * @param _record - record content.
+     * @param _level - record level.
+     */
+    virtual void write(std::string_view _record, LogLevel _level) = 0;
+
+    /*!
+     * @brief Writes all kept records to the output.
+     */
+    virtual void flush() = 0;
+
+    /*!
+     * @brief Writes the kept records if the flush policy says they have waited too long.
+     * Called periodically by the idle AsyncLogWriter and, for the sink set by LogHelper::setSink(), by the LogHelper flushing thread.
+     */
+    virtual void flushIfDue() {}
+};
+
+/*!
+ * @brief FlushPolicy tells a BufferedLogSink when the kept records are written to the output.
+ * The records are written when any of the conditions is met.
+ */
+struct FlushPolicy {
+    /*!
+     * @brief The records are written when they would exceed this size. 0 writes every record at once.
+     */
+    std::size_t maxBufferedBytes = 64 * 1024;
+    /*!
+     * @brief The records are written when the oldest one has been kept this long. 0 turns the check off.
+     * The check runs on write() and flushIfDue().
+     */
+    std::chrono::milliseconds maxDelay{100};
+    /*!
+     * @brief The records of this level and the more severe levels are written at once, together with the kept ones.
+     */
+    LogLevel flushLevel = LogLevel::Error;
+};
+
+/*!
+ * @brief BufferedLogSink coalesces the records into one buffer and writes them by one output call according to FlushPolicy.
+ * The derived classes write the output. Their destructors must call flush(), the base destructor cannot.
+ */
+class BufferedLogSink : public LogSink {
+public:
+    /*!
+     * @brief Construct a new BufferedLogSink object.
+     * @param _policy - flush policy.
+     */
+    explicit BufferedLogSink(FlushPolicy _policy);
+
+    void write(std::string_view _record, LogLevel _level) final;
+
+    void flush() final;
+
+    void flushIfDue() final;
+
+    /*!
+     * @brief Returns the flush policy.
+     */
+    [[nodiscard]]
+    const FlushPolicy &flushPolicy() const noexcept;
+
+    /*!
+     * @brief Returns the number of output calls.
+     */
+    [[nodiscard]]
+    std::size_t outputCalls() const noexcept;
+
+protected:
+    /*!
+     * @brief Writes the parts to the output one after another. Called under the sink lock.
+     * @param _parts - the parts.
+     * @param _count - number of the parts.
+     */
+    virtual void writeOutput(const std::string_view *_parts, std::size_t _count) = 0;
+
+    /*!
+     * @brief Flushes the output buffers below the sink, if any. Called under the sink lock by flush().
+     */
+    virtual void flushOutput() {}
+
+private:
+    /*!
+     * @brief Writes the kept records followed by the record and a line feed. The caller holds m_mutex.
+     * @param _record - the record or nullptr.
+     */
+    void writeLocked(const std::string_view *_record);
+
+    /*!
+     * @brief The flush policy.
+     */
+    const FlushPolicy m_policy;
+    /*!
+     * @brief Guards the members below.
+     */
+    std::mutex m_mutex;
+    /*!
+     * @brief The kept records.
+     */
+    std::string m_pending;
+    /*!
+     * @brief The time the oldest kept record was written.
+     */
+    std::chrono::steady_clock::time_point m_pendingSince;
+    /*!
+     * @brief Number of output calls.
+     */
+    std::atomic<std::size_t> m_outputCalls{0};
+};
+
+/*!
+ * @brief StreamLogSink writes the records to std::ostream.
+ */
+class StreamLogSink final : public BufferedLogSink {
+public:
+    /*!
+     * @brief Construct a new StreamLogSink object.
+     * @param _os - output stream, it must outlive the sink and is used only under the sink lock.
+     * @param _policy - flush policy.
+     */
+    explicit StreamLogSink(std::ostream &_os, FlushPolicy _policy = FlushPolicy{});
+
+    /*!
+     * @brief Destroy the StreamLogSink object, the kept records are written.
+     */
+    ~StreamLogSink() override;
+
+protected:
+    void writeOutput(const std::string_view *_parts, std::size_t _count) override;
+
+    void flushOutput() override;
+
+private:
+    /*!
+     * @brief Output stream.
+     */
+    std::ostream &m_os;
+};
@@ -0,0 +1,353 @@
+#include "MmapLogSink.h"
+
+#include "FdLogSink.h"
+#include "UserException.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+//! The minimum segment size.
+constexpr std::size_t MinSegmentSize = 4096;
+
+//! The delay before a failed preparation is retried.
+constexpr std::chrono::seconds RetryDelay{1};
+
+//! The delay between the checks of the writers before the closed segments are freed.
+constexpr std::chrono::milliseconds ReclaimDelay{10};
+
+/*!
+ * @brief Counts the writer in its epoch slot for the scope.
+ */
+class WriterMark {
+public:
+    explicit WriterMark(std::atomic<std::size_t> &_writers) noexcept : m_writers(_writers) {
+        // seq_cst: the segment is loaded after the mark is visible to reclaimSegments().
+        m_writers.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    ~WriterMark() {
+        m_writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    WriterMark(const WriterMark &) = delete;
+    WriterMark &operator=(const WriterMark &) = delete;
+
+private:
+    std::atomic<std::size_t> &m_writers;
+};
+
+MmapLogSink::Options validOptions(MmapLogSink::Options _options) noexcept {
+    _options.segmentSize = std::max(_options.segmentSize, MinSegmentSize);
+    return _options;
+}
+}  // namespace
+
+MmapLogSink::MmapLogSink(std::string _path) : MmapLogSink(std::move(_path), Options{}) {
+}
+
+MmapLogSink::MmapLogSink(std::string _path, Options _options)
+    : m_path(std::move(_path)), m_nextPath(m_path + ".next"), m_options(validOptions(_options)) {
+    auto segment = openSegment(m_path, false);
+    if (segment == nullptr) {
+        throw UserException("Cannot map the log file", m_path, __PRETTY_FUNCTION__);
+    }
+
+    segment->opened = std::chrono::steady_clock::now();
+    m_current.store(segment.get(), std::memory_order_release);
+    m_segments.push_back(std::move(segment));
+    m_segmentCount.store(1, std::memory_order_relaxed);
+
+    m_thread = std::thread(&MmapLogSink::prepareSegments, this);
+}
+
+MmapLogSink::~MmapLogSink() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+
+    if (auto *segment = m_current.load(std::memory_order_acquire); segment != nullptr) {
+        closeSegment(*segment, std::min(segment->reserved.load(std::memory_order_relaxed), segment->size));
+    }
+
+    if (m_next != nullptr) {
+        closeSegment(*m_next, 0);
+        ::unlink(m_nextPath.c_str());
+    }
+}
+
+void MmapLogSink::write(std::string_view _record, [[maybe_unused]] LogLevel _level) {
+    const auto length = std::min(_record.size(), m_options.segmentSize - 1);
+    const auto size = length + 1;
+    const WriterMark mark(m_writers[m_epoch.load(std::memory_order_seq_cst) & 1u]);
+
+    for (;;) {
+        auto *segment = m_current.load(std::memory_order_seq_cst);
+        if (segment == nullptr) {
+            return;
+        }
+
+        const auto offset = segment->reserved.fetch_add(size, std::memory_order_relaxed);
+        if (offset + size <= segment->size) {
+            std::memcpy(segment->data + offset, _record.data(), length);
+            segment->data[offset + length] = '\n';
+            segment->committed.fetch_add(size, std::memory_order_release);
+            return;
+        }
+
+        if (offset <= segment->size) {
+            // the first writer which does not fit rotates the segment, its records end at the offset.
+            rotate(segment, offset);
+        } else {
+            while (m_current.load(std::memory_order_acquire) == segment) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+void MmapLogSink::flush() {
+    std::lock_guard lock(m_mutex);
+
+    if (auto *segment = m_current.load(std::memory_order_acquire); segment != nullptr) {
+        ::msync(segment->data, std::min(segment->reserved.load(std::memory_order_relaxed), segment->size), MS_SYNC);
+    }
+}
+
+const std::string &MmapLogSink::path() const noexcept {
+    return m_path;
+}
+
+std::size_t MmapLogSink::rotations() const noexcept {
+    return m_rotations.load(std::memory_order_relaxed);
+}
+
+std::size_t MmapLogSink::segments() const noexcept {
+    return m_segmentCount.load(std::memory_order_relaxed);
+}
+
+std::unique_ptr<MmapLogSink::Segment> MmapLogSink::openSegment(const std::string &_path, bool _truncate) const {
+    const int fd = ::open(_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (_truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat status {};
+    const auto existing = ::fstat(fd, &status) == 0 ? static_cast<std::size_t>(status.st_size) : 0;
+    const auto size = std::max(existing, m_options.segmentSize);
+    if (existing < size && ::posix_fallocate(fd, 0, static_cast<off_t>(size)) != 0 &&
+        ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    auto segment = std::make_unique<Segment>();
+    segment->fd = fd;
+    segment->data = static_cast<char *>(data);
+    segment->size = size;
+
+    // the records of a crashed process are followed by the preallocated zeros.
+    auto used = existing;
+    while (used > 0 && segment->data[used - 1] == '\0') {
+        --used;
+    }
+
+    if (m_options.prefault) {
+        // the first write of a page costs a fault and, for the file system, the block allocation;
+        // they are taken here instead of by the writers.
+        const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        for (auto offset = (used + pageSize - 1) / pageSize * pageSize; offset < size; offset += pageSize) {
+            static_cast<volatile char *>(data)[offset] = '\0';
+        }
+    }
+    segment->reserved.store(used, std::memory_order_relaxed);
+    segment->committed.store(used, std::memory_order_relaxed);
+
+    return segment;
+}
+
+void MmapLogSink::closeSegment(Segment &_segment, std::size_t _used) noexcept {
+    while (_segment.committed.load(std::memory_order_acquire) < _used) {
+        std::this_thread::yield();
+    }
+
+    ::msync(_segment.data, _used, MS_ASYNC);
+    ::munmap(_segment.data, _segment.size);
+    ::ftruncate(_segment.fd, static_cast<off_t>(_used));
+    ::close(_segment.fd);
+
+    _segment.data = nullptr;
+    _segment.fd = -1;
+}
+
+void MmapLogSink::forceRotation(Segment *_segment) {
+    const auto offset = _segment->reserved.fetch_add(_segment->size + 1, std::memory_order_relaxed);
+    if (offset <= _segment->size) {
+        rotate(_segment, offset);
+    }
+}
+
+void MmapLogSink::rotate(Segment *_full, std::size_t _used) {
+    std::unique_lock lock(m_mutex);
+
+    m_changed.wait(lock, [this] { return m_next != nullptr || m_prepareFailed || m_stop; });
+    Segment *next = std::exchange(m_next, nullptr);
+    if (next == nullptr) {
+        try {
+            if (auto segment = openSegment(m_nextPath, true); segment != nullptr) {
+                next = segment.get();
+                m_segments.push_back(std::move(segment));
+                m_segmentCount.fetch_add(1, std::memory_order_relaxed);
+                m_prepareFailed = false;
+            }
+        } catch (const std::exception &) {
+        }
+    }
+    m_changed.notify_all();
+
+    std::string rotatedPath;
+    if (_full != nullptr) {
+        if (m_options.maxFiles == 0) {
+            ::unlink(m_path.c_str());
+        } else {
+            rotatedPath = RotatingFileLogSink::rotateFiles(m_path, m_options.maxFiles);
+        }
+    }
+
+    if (next != nullptr) {
+        std::rename(m_nextPath.c_str(), m_path.c_str());
+        next->opened = std::chrono::steady_clock::now();
+    }
+    // seq_cst: a writer marked after reclaimSegments() has checked its slot loads this or a later segment.
+    m_current.store(next, std::memory_order_seq_cst);
+
+    if (_full != nullptr) {
+        closeSegment(*_full, _used);
+        m_rotations.fetch_add(1, std::memory_order_relaxed);
+
+        const auto full = std::find_if(m_segments.begin(), m_segments.end(),
+                                       [_full](const auto &_segment) { return _segment.get() == _full; });
+        if (full != m_segments.end()) {
+            try {
+                m_retired.push_back(std::move(*full));
+                m_segments.erase(full);
+                m_changed.notify_all();
+            } catch (const std::exception &) {
+                // the header is kept with the live ones until the sink is destroyed.
+            }
+        }
+
+        if (!rotatedPath.empty()) {
+            onRotated(rotatedPath);
+        }
+    }
+}
+
+void MmapLogSink::prepareSegments() {
+    std::unique_lock lock(m_mutex);
+
+    while (!m_stop) {
+        if (m_next == nullptr && !m_prepareFailed) {
+            lock.unlock();
+            std::unique_ptr<Segment> segment;
+            try {
+                segment = openSegment(m_nextPath, true);
+            } catch (const std::exception &) {
+            }
+            lock.lock();
+
+            if (segment != nullptr) {
+                try {
+                    m_segments.push_back(std::move(segment));
+                    m_next = m_segments.back().get();
+                    m_segmentCount.fetch_add(1, std::memory_order_relaxed);
+                } catch (const std::exception &) {
+                }
+            }
+            m_prepareFailed = m_next == nullptr;
+            m_changed.notify_all();
+            continue;
+        }
+
+        if (m_prepareFailed) {
+            m_changed.wait_for(lock, RetryDelay);
+            m_prepareFailed = false;
+            continue;
+        }
+
+        auto *current = m_current.load(std::memory_order_acquire);
+        if (current == nullptr) {
+            // no segment could be mapped by the last rotation, the prepared one takes its place.
+            lock.unlock();
+            rotate(nullptr, 0);
+            lock.lock();
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        auto wakeUp = reclaimSegments() ? now + ReclaimDelay : std::chrono::steady_clock::time_point::max();
+
+        if (m_options.maxSegmentAge.count() != 0) {
+            if (now < current->opened + m_options.maxSegmentAge) {
+                wakeUp = std::min(wakeUp, current->opened + m_options.maxSegmentAge);
+            } else if (current->reserved.load(std::memory_order_relaxed) == 0) {
+                current->opened = now;
+                continue;
+            } else {
+                lock.unlock();
+                forceRotation(current);
+                lock.lock();
+                continue;
+            }
+        }
+
+        if (wakeUp == std::chrono::steady_clock::time_point::max()) {
+            m_changed.wait(lock);
+        } else {
+            m_changed.wait_until(lock, wakeUp);
+        }
+    }
+}
+
+bool MmapLogSink::reclaimSegments() {
+    if (m_reclaiming.empty()) {
+        if (m_retired.empty()) {
+            return false;
+        }
+
+        m_reclaiming.swap(m_retired);
+        m_emptySlots = 0;
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // the slot of the epoch before the last flip, the new writers enter the other one.
+    const auto slot = (m_epoch.load(std::memory_order_relaxed) - 1) & 1u;
+    if (m_writers[slot].load(std::memory_order_seq_cst) != 0) {
+        return true;
+    }
+
+    if (++m_emptySlots < 2) {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    m_segmentCount.fetch_sub(m_reclaiming.size(), std::memory_order_relaxed);
+    m_reclaiming.clear();
+    return !m_retired.empty();
+}
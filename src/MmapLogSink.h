@@ -0,0 +1,228 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogSink.h"
+
+/*!
+ * @brief MmapLogSink writes the records into a memory-mapped file segment. A writer reserves its bytes by one atomic
+ * fetch_add and copies the record into the mapping, without a lock or a system call. A full or old segment is rotated
+ * like by RotatingFileLogSink: it is truncated to the used length and renamed to "path.1", the older ones are shifted
+ * to "path.2" ... "path.<maxFiles>", the oldest one is removed. A background thread preallocates and maps the next
+ * segment ("path.next") in advance. The copied records belong to the page cache, so they survive a crash
+ * of the process; flush() writes them to the disk. A file left by a crashed process is continued after its last record.
+ */
+class MmapLogSink : public LogSink {
+public:
+    /*!
+     * @brief The options of the sink.
+     */
+    struct Options {
+        //! The size of a segment, at least 4096. A longer record is truncated to it.
+        std::size_t segmentSize = 64 * 1024 * 1024;
+        //! Number of the rotated segments kept, 0 removes a full segment.
+        std::size_t maxFiles = 4;
+        //! A non-empty segment older than this is rotated. 0 turns the check off.
+        std::chrono::milliseconds maxSegmentAge{0};
+        //! The pages of a new segment are touched in advance, so the writers take no page faults.
+        bool prefault = true;
+    };
+
+    /*!
+     * @brief Construct a new MmapLogSink object with the default options.
+     * @param _path - file path.
+     * @throw UserException - if the file cannot be opened or mapped.
+     */
+    explicit MmapLogSink(std::string _path);
+
+    /*!
+     * @brief Construct a new MmapLogSink object, the file is created if it does not exist.
+     * @param _path - file path.
+     * @param _options - the options.
+     * @throw UserException - if the file cannot be opened or mapped.
+     */
+    MmapLogSink(std::string _path, Options _options);
+
+    /*!
+     * @brief Destroy the MmapLogSink object, the segment is truncated to the used length.
+     * The writers must have finished.
+     */
+    ~MmapLogSink() override;
+
+    MmapLogSink(const MmapLogSink &) = delete;
+    MmapLogSink &operator=(const MmapLogSink &) = delete;
+
+    /*!
+     * @brief Copies the record followed by a line feed into the segment. The record is dropped if no segment
+     * can be mapped, the logging must not fail the caller.
+     */
+    void write(std::string_view _record, LogLevel _level) override;
+
+    /*!
+     * @brief Writes the copied records of the segment to the disk by msync(2).
+     */
+    void flush() override;
+
+    /*!
+     * @brief Returns the file path.
+     */
+    [[nodiscard]]
+    const std::string &path() const noexcept;
+
+    /*!
+     * @brief Returns the number of the rotations.
+     */
+    [[nodiscard]]
+    std::size_t rotations() const noexcept;
+
+    /*!
+     * @brief Returns the number of the segment headers held, the closed ones included until no writer can reach them.
+     */
+    [[nodiscard]]
+    std::size_t segments() const noexcept;
+
+protected:
+    /*!
+     * @brief Called under the sink lock after the full segment has been truncated and renamed.
+     * @param _rotatedPath - the new path of the full segment.
+     */
+    virtual void onRotated([[maybe_unused]] const std::string &_rotatedPath) {}
+
+private:
+    /*!
+     * @brief A mapped file segment.
+     */
+    struct Segment {
+        //! File descriptor.
+        int fd = -1;
+        //! The mapping.
+        char *data = nullptr;
+        //! The mapping size.
+        std::size_t size = 0;
+        //! The time the segment became current.
+        std::chrono::steady_clock::time_point opened;
+        //! The reserved bytes, it exceeds size once the segment is full.
+        alignas(64) std::atomic<std::size_t> reserved{0};
+        //! The bytes copied by the writers.
+        alignas(64) std::atomic<std::size_t> committed{0};
+    };
+
+    /*!
+     * @brief Opens, preallocates and maps the segment file, the existing records are kept.
+     * @return The segment or nullptr.
+     */
+    std::unique_ptr<Segment> openSegment(const std::string &_path, bool _truncate) const;
+
+    /*!
+     * @brief Waits for the writers of the full segment, unmaps it and truncates the file to the used length.
+     */
+    static void closeSegment(Segment &_segment, std::size_t _used) noexcept;
+
+    /*!
+     * @brief Marks the segment full, unless a writer has done it, and rotates it.
+     */
+    void forceRotation(Segment *_segment);
+
+    /*!
+     * @brief Renames the files, makes the prepared segment current and closes the full one.
+     * @param _full - the full segment or nullptr if there is none.
+     * @param _used - the used length of the full segment.
+     */
+    void rotate(Segment *_full, std::size_t _used);
+
+    /*!
+     * @brief The background thread: prepares the next segment, rotates the old ones and frees the closed ones.
+     */
+    void prepareSegments();
+
+    /*!
+     * @brief Frees the closed segments once no writer can reach them, called by the background thread under the lock.
+     * The writers count themselves in the slot of the epoch they entered in. A closed segment is unreachable
+     * once both slots have been seen empty after it was replaced; the epoch is flipped before each check,
+     * so the new writers do not keep the checked slot busy. The check does not wait, a rotating writer may
+     * wait for this thread.
+     * @return true if closed segments are still held.
+     */
+    bool reclaimSegments();
+
+    /*!
+     * @brief File path.
+     */
+    const std::string m_path;
+    /*!
+     * @brief The path of the prepared segment.
+     */
+    const std::string m_nextPath;
+    /*!
+     * @brief The options.
+     */
+    const Options m_options;
+    /*!
+     * @brief The segment the records are copied to or nullptr if it cannot be mapped.
+     */
+    std::atomic<Segment *> m_current{nullptr};
+    /*!
+     * @brief Number of the rotations.
+     */
+    std::atomic<std::size_t> m_rotations{0};
+    /*!
+     * @brief Number of the segment headers held.
+     */
+    std::atomic<std::size_t> m_segmentCount{0};
+    /*!
+     * @brief The epoch of the writers, see reclaimSegments().
+     */
+    std::atomic<unsigned> m_epoch{0};
+    /*!
+     * @brief Number of the writers inside write() by the parity of the epoch they entered in.
+     */
+    std::atomic<std::size_t> m_writers[2]{};
+    /*!
+     * @brief Guards the members below, the rotation and flush().
+     */
+    std::mutex m_mutex;
+    /*!
+     * @brief Notified when the next segment is prepared or taken, or the sink stops.
+     */
+    std::condition_variable m_changed;
+    /*!
+     * @brief The current and the prepared segments.
+     */
+    std::vector<std::unique_ptr<Segment>> m_segments;
+    /*!
+     * @brief The closed segments, a late writer may still read their counters.
+     */
+    std::vector<std::unique_ptr<Segment>> m_retired;
+    /*!
+     * @brief The closed segments waiting for the writers to leave both epoch slots.
+     */
+    std::vector<std::unique_ptr<Segment>> m_reclaiming;
+    /*!
+     * @brief Number of the epoch slots seen empty since m_reclaiming was filled.
+     */
+    unsigned m_emptySlots = 0;
+    /*!
+     * @brief The prepared segment or nullptr.
+     */
+    Segment *m_next = nullptr;
+    /*!
+     * @brief The last preparation failed, it is retried after a while.
+     */
+    bool m_prepareFailed = false;
+    /*!
+     * @brief The background thread must finish.
+     */
+    bool m_stop = false;
+    /*!
+     * @brief The background thread.
+     */
+    std::thread m_thread;
+};
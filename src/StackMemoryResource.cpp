@@ -0,0 +1,123 @@
+#include "StackMemoryResource.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+/*!
+ * @brief The size of the first chunk.
+ */
+constexpr std::size_t FirstChunkSize = 4096;
+
+/*!
+ * @brief The resource of the thread has been destroyed, the later thread_local destructors get nullptr.
+ */
+thread_local bool t_threadResourceDestroyed = false;
+
+/*!
+ * @brief The resource of the thread with the buffer allocated once.
+ */
+struct ThreadResourceHolder {
+    ThreadResourceHolder()
+            : buffer(std::make_unique<unsigned char[]>(MonotonicMemoryResource::ThreadBufferSize)),
+              resource(buffer.get(), MonotonicMemoryResource::ThreadBufferSize, std::pmr::new_delete_resource()) {}
+
+    ~ThreadResourceHolder() {
+        t_threadResourceDestroyed = true;
+    }
+
+    std::unique_ptr<unsigned char[]> buffer;
+    MonotonicMemoryResource resource;
+};
+}  // namespace
+
+MonotonicMemoryResource::MonotonicMemoryResource(void *_buffer, std::size_t _size, std::pmr::memory_resource *_upstream) noexcept
+        : m_buffer(static_cast<unsigned char *>(_buffer)),
+          m_bufferSize(_size),
+          m_upstream(_upstream),
+          m_first(m_buffer),
+          m_current(m_buffer),
+          m_last(m_buffer + _size) {
+}
+
+MonotonicMemoryResource::~MonotonicMemoryResource() {
+    release();
+}
+
+MonotonicMemoryResource::Marker MonotonicMemoryResource::mark() const noexcept {
+    return {m_chunk, static_cast<std::size_t>(m_current - m_first)};
+}
+
+void MonotonicMemoryResource::rewind(const Marker &_marker) noexcept {
+    while (m_chunk != _marker.chunk && m_chunk != nullptr) {
+        Chunk *previous = m_chunk->previous;
+        m_upstreamSize -= m_chunk->size;
+        m_upstream->deallocate(m_chunk, m_chunk->size, alignof(std::max_align_t));
+        m_chunk = previous;
+    }
+
+    setCurrent(m_chunk);
+    m_current = m_first + _marker.used;
+}
+
+void MonotonicMemoryResource::release() noexcept {
+    rewind(Marker{});
+}
+
+MonotonicMemoryResource *MonotonicMemoryResource::threadResource() noexcept {
+    if (t_threadResourceDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadResourceHolder holder;
+    return &holder.resource;
+}
+
+void *MonotonicMemoryResource::do_allocate(std::size_t _bytes, std::size_t _alignment) {
+    void *pointer = m_current;
+    auto space = static_cast<std::size_t>(m_last - m_current);
+    if (std::align(_alignment, _bytes, pointer, space) != nullptr) {
+        m_current = static_cast<unsigned char *>(pointer) + _bytes;
+        return pointer;
+    }
+
+    return allocateChunk(_bytes, _alignment);
+}
+
+void MonotonicMemoryResource::do_deallocate([[maybe_unused]] void *_pointer, [[maybe_unused]] std::size_t _bytes,
+                                            [[maybe_unused]] std::size_t _alignment) noexcept {
+}
+
+bool MonotonicMemoryResource::do_is_equal(const std::pmr::memory_resource &_other) const noexcept {
+    return this == &_other;
+}
+
+void *MonotonicMemoryResource::allocateChunk(std::size_t _bytes, std::size_t _alignment) {
+    // the chunk sizes grow with the chain, so a rewound resource starts from the small chunks again.
+    const auto nextSize = m_chunk != nullptr ? m_chunk->size * 2 : std::max(FirstChunkSize, m_bufferSize);
+    const auto size = std::max(nextSize, sizeof(Chunk) + _bytes + _alignment);
+    auto *chunk = static_cast<Chunk *>(m_upstream->allocate(size, alignof(std::max_align_t)));
+    chunk->previous = m_chunk;
+    chunk->size = size;
+    m_upstreamSize += size;
+    setCurrent(chunk);
+
+    void *pointer = m_current;
+    auto space = static_cast<std::size_t>(m_last - m_current);
+    std::align(_alignment, _bytes, pointer, space);
+    m_current = static_cast<unsigned char *>(pointer) + _bytes;
+
+    return pointer;
+}
+
+void MonotonicMemoryResource::setCurrent(Chunk *_chunk) noexcept {
+    m_chunk = _chunk;
+    if (_chunk == nullptr) {
+        m_first = m_buffer;
+        m_last = m_buffer + m_bufferSize;
+    } else {
+        m_first = reinterpret_cast<unsigned char *>(_chunk + 1);
+        m_last = reinterpret_cast<unsigned char *>(_chunk) + _chunk->size;
+    }
+    m_current = m_first;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+/*!
+ * @brief MonotonicMemoryResource bump-allocates from a fixed buffer and, when it is exhausted, from the chunks
+ * taken from the upstream resource; every next chunk of the chain is twice as large. deallocate() does nothing,
+ * the memory is released all at once by release() or down to a marker by rewind(), which costs O(1)
+ * if no chunk has been taken. Not thread-safe.
+ */
+class MonotonicMemoryResource : public std::pmr::memory_resource {
+public:
+    /*!
+     * @brief The position of the resource, the allocations made after mark() are released by rewind().
+     */
+    struct Marker {
+        //! The current chunk or nullptr if it is the buffer.
+        void *chunk = nullptr;
+        //! The used bytes of the current chunk or buffer.
+        std::size_t used = 0;
+    };
+
+    /*!
+     * @brief Construct a new MonotonicMemoryResource object.
+     * @param _buffer - the initial buffer, it must outlive the resource.
+     * @param _size - the buffer size.
+     * @param _upstream - the resource of the chunks.
+     */
+    MonotonicMemoryResource(void *_buffer, std::size_t _size,
+                            std::pmr::memory_resource *_upstream = std::pmr::get_default_resource()) noexcept;
+
+    /*!
+     * @brief Destroy the MonotonicMemoryResource object, the chunks are returned to the upstream resource.
+     */
+    ~MonotonicMemoryResource() override;
+
+    MonotonicMemoryResource(const MonotonicMemoryResource &) = delete;
+    MonotonicMemoryResource &operator=(const MonotonicMemoryResource &) = delete;
+
+    /*!
+     * @brief Returns the current position.
+     */
+    [[nodiscard]]
+    Marker mark() const noexcept;
+
+    /*!
+     * @brief Releases the allocations made after the marker was taken, the chunks taken after it are returned
+     * to the upstream resource. The markers are rewound in the reverse order of mark().
+     */
+    void rewind(const Marker &_marker) noexcept;
+
+    /*!
+     * @brief Releases all allocations.
+     */
+    void release() noexcept;
+
+    /*!
+     * @brief Returns the number of the bytes taken from the upstream resource and not returned yet.
+     */
+    [[nodiscard]]
+    std::size_t upstreamSize() const noexcept { return m_upstreamSize; }
+
+    /*!
+     * @brief Returns the upstream resource.
+     */
+    [[nodiscard]]
+    std::pmr::memory_resource *upstream() const noexcept { return m_upstream; }
+
+    /*!
+     * @brief The size of the buffer of the thread resource.
+     */
+    static constexpr std::size_t ThreadBufferSize = 16 * 1024;
+
+    /*!
+     * @brief Returns the resource of the thread or nullptr if it has been destroyed. Its buffer of ThreadBufferSize bytes
+     * is allocated once per thread, the upstream resource is std::pmr::new_delete_resource().
+     * Use it through MemoryResourceScope, so the nested users release their allocations in order.
+     */
+    [[nodiscard]]
+    static MonotonicMemoryResource *threadResource() noexcept;
+
+protected:
+    void *do_allocate(std::size_t _bytes, std::size_t _alignment) override;
+
+    void do_deallocate(void *_pointer, std::size_t _bytes, std::size_t _alignment) noexcept override;
+
+    bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override;
+
+private:
+    /*!
+     * @brief The header of a chunk, the allocations follow it.
+     */
+    struct Chunk {
+        Chunk *previous;
+        std::size_t size;
+    };
+
+    /*!
+     * @brief Takes a chunk which fits the allocation and allocates from it.
+     */
+    void *allocateChunk(std::size_t _bytes, std::size_t _alignment);
+
+    /*!
+     * @brief Makes the chunk or, if it is nullptr, the buffer current.
+     */
+    void setCurrent(Chunk *_chunk) noexcept;
+
+    /*!
+     * @brief The initial buffer.
+     */
+    unsigned char *m_buffer;
+    /*!
+     * @brief The size of the initial buffer.
+     */
+    std::size_t m_bufferSize;
+    /*!
+     * @brief The resource of the chunks.
+     */
+    std::pmr::memory_resource *m_upstream;
+    /*!
+     * @brief The last taken chunk or nullptr if the buffer is current.
+     */
+    Chunk *m_chunk = nullptr;
+    /*!
+     * @brief The first byte of the current chunk or buffer.
+     */
+    unsigned char *m_first;
+    /*!
+     * @brief The first free byte.
+     */
+    unsigned char *m_current;
+    /*!
+     * @brief The end of the current chunk or buffer.
+     */
+    unsigned char *m_last;
+    /*!
+     * @brief The size of the taken chunks.
+     */
+    std::size_t m_upstreamSize = 0;
+};
+
+/*!
+ * @brief StackMemoryResource is MonotonicMemoryResource with the inline buffer, e.g. a local variable of a request handler.
+ * @tparam N - the buffer size.
+ */
+template<std::size_t N>
+class StackMemoryResource : public MonotonicMemoryResource {
+public:
+    /*!
+     * @brief Construct a new StackMemoryResource object. The buffer is not initialized.
+     * @param _upstream - the resource of the chunks taken when the buffer is exhausted.
+     */
+    explicit StackMemoryResource(std::pmr::memory_resource *_upstream = std::pmr::get_default_resource()) noexcept
+            : MonotonicMemoryResource(m_storage, N, _upstream) {}
+
+private:
+    /*!
+     * @brief The buffer.
+     */
+    alignas(std::max_align_t) unsigned char m_storage[N];
+};
+
+/*!
+ * @brief MemoryResourceScope releases the allocations made from the resource during its lifetime.
+ * The scopes of a resource are nested, the memory allocated in a scope must not be used after it ends.
+ */
+class MemoryResourceScope {
+public:
+    /*!
+     * @brief Construct a new scope of the thread resource. If it has been destroyed, resource() is the default resource.
+     */
+    MemoryResourceScope() noexcept : MemoryResourceScope(MonotonicMemoryResource::threadResource()) {}
+
+    /*!
+     * @brief Construct a new scope of the resource.
+     * @param _resource - the resource or nullptr, then resource() is the default resource.
+     */
+    explicit MemoryResourceScope(MonotonicMemoryResource *_resource) noexcept
+            : m_resource(_resource), m_marker(_resource != nullptr ? _resource->mark() : MonotonicMemoryResource::Marker{}) {}
+
+    /*!
+     * @brief Releases the allocations made during the scope.
+     */
+    ~MemoryResourceScope() {
+        if (m_resource != nullptr) {
+            m_resource->rewind(m_marker);
+        }
+    }
+
+    MemoryResourceScope(const MemoryResourceScope &) = delete;
+    MemoryResourceScope &operator=(const MemoryResourceScope &) = delete;
+
+    /*!
+     * @brief Returns the resource of the scope.
+     */
+    [[nodiscard]]
+    std::pmr::memory_resource *resource() const noexcept {
+        return m_resource != nullptr ? m_resource : std::pmr::get_default_resource();
+    }
+
+private:
+    MonotonicMemoryResource *m_resource;
+    MonotonicMemoryResource::Marker m_marker;
+};
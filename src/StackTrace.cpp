@@ -0,0 +1,144 @@
+#include "StackTrace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#if STDCORE_STACK_TRACE
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+namespace {
+/*!
+ * @brief The capture is enabled.
+ */
+std::atomic<bool> g_captureEnabled{false};
+
+/*!
+ * @brief Guards g_symbols.
+ */
+std::mutex g_symbolsMutex;
+
+/*!
+ * @brief The symbols of the addresses. The nodes are never removed, so the views of the strings stay valid.
+ */
+std::unordered_map<const void *, std::string> g_symbols;
+
+#if STDCORE_STACK_TRACE
+/*!
+ * @brief The first backtrace() call loads libgcc and allocates, it is made when the library is loaded.
+ */
+const bool g_warmUp = [] {
+    void *frame = nullptr;
+    return ::backtrace(&frame, 1) > 0;
+}();
+
+/*!
+ * @brief Returns the symbol of the address, see StackTrace::symbol().
+ */
+std::string resolveSymbol(const void *_address) {
+    char offset[2 + 2 * sizeof(std::uintptr_t) + 1];
+    const auto hex = [&offset](std::uintptr_t _value) {
+        offset[0] = '0';
+        offset[1] = 'x';
+        const auto *last = std::to_chars(offset + 2, offset + sizeof(offset), _value, 16).ptr;
+        return std::string_view(offset, static_cast<std::size_t>(last - offset));
+    };
+
+    Dl_info info{};
+    if (::dladdr(_address, &info) == 0) {
+        return std::string(hex(reinterpret_cast<std::uintptr_t>(_address)));
+    }
+
+    std::string symbol;
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(info.dli_fbase);
+    if (info.dli_sname != nullptr) {
+        int status = 0;
+        const std::unique_ptr<char, decltype(&std::free)> demangled(
+                abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), &std::free);
+        symbol = status == 0 ? demangled.get() : info.dli_sname;
+        base = reinterpret_cast<std::uintptr_t>(info.dli_saddr);
+    } else {
+        symbol = info.dli_fname != nullptr ? info.dli_fname : "??";
+    }
+
+    symbol.append("+").append(hex(reinterpret_cast<std::uintptr_t>(_address) - base));
+
+    return symbol;
+}
+#endif
+}  // namespace
+
+StackTrace StackTrace::capture([[maybe_unused]] std::size_t _skip) noexcept {
+    StackTrace stackTrace;
+
+#if STDCORE_STACK_TRACE
+    if (!g_captureEnabled.load(std::memory_order_relaxed)) {
+        return stackTrace;
+    }
+
+    // this frame is skipped too.
+    void *frames[MaxFrames + 8];
+    const auto size = static_cast<std::size_t>(::backtrace(frames, static_cast<int>(MaxFrames + 8)));
+    const auto skip = std::min(_skip + 1, size);
+    stackTrace.m_size = std::min(size - skip, MaxFrames);
+    std::memcpy(stackTrace.m_frames, frames + skip, stackTrace.m_size * sizeof(void *));
+#endif
+
+    return stackTrace;
+}
+
+void StackTrace::setCaptureEnabled(bool _enabled) noexcept {
+    g_captureEnabled.store(_enabled, std::memory_order_relaxed);
+}
+
+bool StackTrace::isCaptureEnabled() noexcept {
+    return g_captureEnabled.load(std::memory_order_relaxed);
+}
+
+std::string_view StackTrace::symbol([[maybe_unused]] const void *_address) {
+#if STDCORE_STACK_TRACE
+    const std::lock_guard lock(g_symbolsMutex);
+
+    auto it = g_symbols.find(_address);
+    if (it == g_symbols.end()) {
+        it = g_symbols.emplace(_address, resolveSymbol(_address)).first;
+    }
+
+    return it->second;
+#else
+    return {};
+#endif
+}
+
+StackTrace::StackTrace(const StackTrace &_stackTrace) noexcept : m_size(_stackTrace.m_size) {
+    std::memcpy(m_frames, _stackTrace.m_frames, m_size * sizeof(void *));
+}
+
+StackTrace &StackTrace::operator=(const StackTrace &_stackTrace) noexcept {
+    m_size = _stackTrace.m_size;
+    std::memcpy(m_frames, _stackTrace.m_frames, m_size * sizeof(void *));
+
+    return *this;
+}
+
+std::size_t StackTrace::size() const noexcept {
+    return m_size;
+}
+
+bool StackTrace::isEmpty() const noexcept {
+    return m_size == 0;
+}
+
+const void *StackTrace::frame(std::size_t _index) const noexcept {
+    return _index < m_size ? m_frames[_index] : nullptr;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+#ifndef STDCORE_STACK_TRACE
+//! 0 compiles the stack trace capture out, StackTrace::capture() returns an empty trace.
+#define STDCORE_STACK_TRACE 1
+#endif
+
+/*!
+ * @brief StackTrace keeps the raw return addresses of the frames in an inline array, capture() does not allocate.
+ * The frames are symbolized only when they are written, the symbols are cached for the process lifetime.
+ */
+class StackTrace {
+public:
+    /*!
+     * @brief The maximum number of the kept frames.
+     */
+    static constexpr std::size_t MaxFrames = 32;
+
+    /*!
+     * @brief Construct a new empty StackTrace object.
+     */
+    StackTrace() noexcept = default;
+
+    /*!
+     * @brief Captures the frames of the calling thread if the capture is enabled.
+     * @param _skip - number of the frames skipped, 0 is the caller of capture().
+     * @return The stack trace or an empty one if the capture is disabled.
+     */
+    static StackTrace capture(std::size_t _skip = 0) noexcept;
+
+    /*!
+     * @brief Enables the capture. It is disabled by default.
+     */
+    static void setCaptureEnabled(bool _enabled) noexcept;
+
+    /*!
+     * @brief Returns true if capture() captures the frames.
+     */
+    [[nodiscard]]
+    static bool isCaptureEnabled() noexcept;
+
+    /*!
+     * @brief Returns the symbol of the address: the demangled function name and the offset,
+     * or the module and the offset if the function is not exported.
+     * The view stays valid for the process lifetime.
+     */
+    [[nodiscard]]
+    static std::string_view symbol(const void *_address);
+
+    StackTrace(const StackTrace &_stackTrace) noexcept;
+    StackTrace &operator=(const StackTrace &_stackTrace) noexcept;
+
+    /*!
+     * @brief Returns the number of the frames.
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept;
+
+    /*!
+     * @brief Returns true if there are no frames.
+     */
+    [[nodiscard]]
+    bool isEmpty() const noexcept;
+
+    /*!
+     * @brief Returns the return address of the frame.
+     */
+    [[nodiscard]]
+    const void *frame(std::size_t _index) const noexcept;
+
+    /*!
+     * @brief Writes the frames as "#index symbol" lines.
+     * @param _buffer - the destination with append(const char *, size_t), e.g. CharFastStackBuffer or std::string.
+     */
+    template<class Buffer_t>
+    void writeTo(Buffer_t &_buffer) const;
+
+private:
+    /*!
+     * @brief The return addresses.
+     */
+    void *m_frames[MaxFrames];
+    /*!
+     * @brief Number of the frames.
+     */
+    std::size_t m_size = 0;
+};
+
+template<class Buffer_t>
+void StackTrace::writeTo(Buffer_t &_buffer) const {
+    for (std::size_t i = 0; i < m_size; ++i) {
+        char index[24] = {'#'};
+        auto *last = std::to_chars(index + 1, index + sizeof(index) - 1, i).ptr;
+        *last++ = ' ';
+        _buffer.append(index, static_cast<std::size_t>(last - index));
+
+        const auto name = symbol(m_frames[i]);
+        _buffer.append(name.data(), name.size());
+        _buffer.append("\n", 1);
+    }
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "CharFastStackBuffer.h"
+#include "EscapeFormat.h"
+#include "LogLevel.h"
+
+#include <cmath>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+/*!
+ * @brief The format of the text records.
+ */
+enum class RecordFormat {
+    //! "timestamp message key=value".
+    Text,
+    //! {"ts":"timestamp","level":"Error","key":value,"msg":"message"}
+    Json,
+    //! ts=timestamp level=Error key=value msg="message"
+    Logfmt
+};
+
+/*!
+ * @brief KeyValue is a structured field of a log record, see kv(). It refers to the value,
+ * so it must be logged in the statement which creates it.
+ */
+template<class V>
+struct KeyValue {
+    std::string_view key;
+    const V &value;
+};
+
+/*!
+ * @brief Returns the structured field of a log record, e.g. STDCORE_LOG_ERROR << "timeout" << kv("order_id", id);
+ */
+template<class V>
+constexpr KeyValue<V> kv(std::string_view _key, const V &_value) noexcept {
+    return {_key, _value};
+}
+
+/*!
+ * @brief StructuredLogFormat encodes the JSON and logfmt records into CharFastStackBuffer.
+ * The record is the header with the timestamp and the level, the fields and the message, which comes last,
+ * so the fields are encoded straight into the record while the message is collected separately.
+ * A field which does not fit is dropped as a whole, the message is clamped, so the record stays well-formed.
+ */
+struct StructuredLogFormat {
+    /*!
+     * @brief The record size kept free for the message field and the closing chars.
+     */
+    static constexpr std::size_t ClosingReserve = 16;
+
+    /*!
+     * @brief Writes the record header.
+     * @param _buffer - record buffer, must be empty.
+     * @param _format - Json or Logfmt.
+     * @param _timestamp - formatted timestamp.
+     * @param _level - logging level.
+     */
+    template<std::size_t N, class P>
+    static void beginRecord(CharFastStackBuffer<char, N, P> &_buffer, RecordFormat _format, std::string_view _timestamp, LogLevel _level) {
+        if (_format == RecordFormat::Json) {
+            _buffer << std::string_view("{\"ts\":");
+            appendQuoted(_buffer, _timestamp, N);
+            _buffer << std::string_view(",\"level\":\"") << logLevelName(_level) << '"';
+        } else {
+            _buffer << std::string_view("ts=");
+            appendLogfmtValue(_buffer, _timestamp, N);
+            _buffer << std::string_view(" level=") << logLevelName(_level);
+        }
+    }
+
+    /*!
+     * @brief Writes the field. The value is a number, bool, char or a string view. A logfmt key is quoted
+     * like a value if it is empty or contains a space, '=', '"', '\' or a control char, so it cannot forge a field.
+     * @return false if the field does not fit and has been dropped.
+     */
+    template<std::size_t N, class P, class V>
+    static bool writeField(CharFastStackBuffer<char, N, P> &_buffer, RecordFormat _format, std::string_view _key, const V &_value) {
+        constexpr auto limit = N > ClosingReserve ? N - ClosingReserve : 0;
+        const auto start = static_cast<std::size_t>(_buffer.size());
+        const auto truncated = _buffer.truncated();
+
+        bool fits = true;
+        if (_format == RecordFormat::Json) {
+            _buffer << ',';
+            fits = appendQuoted(_buffer, _key, limit);
+            _buffer << ':';
+        } else {
+            _buffer << ' ';
+            fits = appendLogfmtValue(_buffer, _key, limit);
+            _buffer << '=';
+        }
+
+        if constexpr (std::is_same_v<V, bool>) {
+            _buffer << _value;
+        } else if constexpr (std::is_same_v<V, char>) {
+            fits = fits && writeString(_buffer, _format, std::string_view(&_value, 1), limit);
+        } else if constexpr (std::is_floating_point_v<V>) {
+            if (_format == RecordFormat::Json && !std::isfinite(_value)) {
+                // JSON has no literals for NaN and infinity.
+                _buffer << '"' << _value << '"';
+            } else {
+                _buffer << _value;
+            }
+        } else if constexpr (std::is_arithmetic_v<V>) {
+            _buffer << _value;
+        } else if constexpr (std::is_pointer_v<V>) {
+            if (_value == nullptr) {
+                _buffer << std::string_view("null");
+            } else {
+                fits = fits && writeString(_buffer, _format, std::string_view(_value), limit);
+            }
+        } else {
+            fits = fits && writeString(_buffer, _format, std::string_view(_value), limit);
+        }
+
+        if (!fits || _buffer.truncated() != truncated || static_cast<std::size_t>(_buffer.size()) > limit) {
+            _buffer.resizeUninitialized(start);
+            return false;
+        }
+
+        return true;
+    }
+
+    /*!
+     * @brief Writes the message field and closes the record. The message is clamped to the free part of the buffer.
+     */
+    template<std::size_t N, class P>
+    static void endRecord(CharFastStackBuffer<char, N, P> &_buffer, RecordFormat _format, std::string_view _message) {
+        if (_format == RecordFormat::Json) {
+            _buffer << std::string_view(",\"msg\":");
+            appendQuoted(_buffer, _message, N - 1);
+            _buffer << '}';
+        } else if (!_message.empty()) {
+            _buffer << std::string_view(" msg=");
+            appendLogfmtValue(_buffer, _message, N);
+        }
+    }
+
+    /*!
+     * @brief Appends the string in quotes with the JSON escapes. The string is clamped, so that the buffer size
+     * including the closing quote does not exceed the limit. An escape or a UTF-8 sequence is never split.
+     * @return false if the string has been clamped.
+     */
+    template<std::size_t N, class P>
+    static bool appendQuoted(CharFastStackBuffer<char, N, P> &_buffer, std::string_view _str, std::size_t _limit) {
+        _buffer << '"';
+        const auto fits = appendEscaped(_buffer, _str, _limit > 0 ? _limit - 1 : 0);
+        _buffer << '"';
+
+        return fits;
+    }
+
+    /*!
+     * @brief Appends the logfmt value, it is quoted if it is empty or contains a space, '=', '"', '\' or a control char.
+     * @return false if the value has been clamped.
+     */
+    template<std::size_t N, class P>
+    static bool appendLogfmtValue(CharFastStackBuffer<char, N, P> &_buffer, std::string_view _str, std::size_t _limit) {
+        if (_str.empty() || EscapeScanner::find(_str, EscapeMode::Logfmt, false) != _str.size()) {
+            return appendQuoted(_buffer, _str, _limit);
+        }
+
+        return appendEscaped(_buffer, _str, _limit);
+    }
+
+private:
+    /*!
+     * @brief Writes the string value of the field.
+     */
+    template<std::size_t N, class P>
+    static bool writeString(CharFastStackBuffer<char, N, P> &_buffer, RecordFormat _format, std::string_view _str, std::size_t _limit) {
+        return _format == RecordFormat::Json ? appendQuoted(_buffer, _str, _limit) : appendLogfmtValue(_buffer, _str, _limit);
+    }
+
+    /*!
+     * @brief Appends the string with the JSON escapes, the runs of the plain chars are found by EscapeScanner
+     * and appended as a whole.
+     * @return false if the string has been clamped to the limit.
+     */
+    template<std::size_t N, class P>
+    static bool appendEscaped(CharFastStackBuffer<char, N, P> &_buffer, std::string_view _str, std::size_t _limit) {
+        const auto appendRun = [&_buffer, _limit](std::string_view _run) {
+            const auto size = static_cast<std::size_t>(_buffer.size());
+            const auto free = _limit > size ? _limit - size : 0;
+            if (_run.size() <= free) {
+                _buffer.append(_run.data(), _run.size());
+                return true;
+            }
+
+            auto count = free;
+            // the UTF-8 continuation bytes are 10xxxxxx.
+            while (count > 0 && (static_cast<unsigned char>(_run[count]) & 0xC0) == 0x80) {
+                --count;
+            }
+            _buffer.append(_run.data(), count);
+
+            return false;
+        };
+
+        std::size_t runStart = 0;
+        while (true) {
+            const auto i = runStart + EscapeScanner::find(_str.substr(runStart), EscapeMode::Json, false);
+            if (i == _str.size()) {
+                break;
+            }
+
+            const auto c = static_cast<unsigned char>(_str[i]);
+            if (!appendRun(_str.substr(runStart, i - runStart))) {
+                return false;
+            }
+            runStart = i + 1;
+
+            char escape[6];
+            const auto escapeSize = escape_detail::jsonEscape(c, escape);
+            if (static_cast<std::size_t>(_buffer.size()) + escapeSize > _limit) {
+                return false;
+            }
+            _buffer.append(escape, escapeSize);
+        }
+
+        return appendRun(_str.substr(runStart));
+    }
+};
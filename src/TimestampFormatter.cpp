@@ -0,0 +1,206 @@
+#include "TimestampFormatter.h"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define STDCORE_HAS_TSC 1
+#endif
+
+namespace {
+constexpr std::int64_t NanosecondsPerSecond = 1'000'000'000;
+
+/*!
+ * @brief The cached text of one second.
+ */
+struct SecondCache {
+    std::int64_t second = std::numeric_limits<std::int64_t>::min();
+    TimestampFormatter::Format format = TimestampFormatter::Format::Ctime;
+    //! The text up to seconds.
+    char prefix[TimestampFormatter::MaxSize];
+    std::size_t prefixSize = 0;
+    //! The text after the sub-second digits.
+    char suffix[8];
+    std::size_t suffixSize = 0;
+};
+
+std::int64_t readClock(clockid_t _clock) noexcept {
+    timespec ts{};
+    clock_gettime(_clock, &ts);
+
+    return static_cast<std::int64_t>(ts.tv_sec) * NanosecondsPerSecond + ts.tv_nsec;
+}
+
+#ifdef STDCORE_HAS_TSC
+/*!
+ * @brief Returns true if the time stamp counter runs at a constant rate in all power states (CPUID 0x80000007 EDX bit 8).
+ */
+bool invariantTsc() noexcept {
+    unsigned eax = 0;
+    unsigned ebx = 0;
+    unsigned ecx = 0;
+    unsigned edx = 0;
+
+    return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) != 0 && (edx & (1u << 8)) != 0;
+}
+
+/*!
+ * @brief The rate of the time stamp counter, 0 if it is not invariant.
+ */
+struct TscCalibration {
+    double nanosecondsPerTick = 0.0;
+    //! The number of ticks after which a thread re-anchors the counter to CLOCK_REALTIME.
+    std::uint64_t anchorTicks = 0;
+
+    TscCalibration() noexcept {
+        if (!invariantTsc()) {
+            return;
+        }
+
+        const auto startNanoseconds = readClock(CLOCK_REALTIME);
+        const auto startTicks = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const auto endNanoseconds = readClock(CLOCK_REALTIME);
+        const auto endTicks = __rdtsc();
+
+        if (endTicks > startTicks && endNanoseconds > startNanoseconds) {
+            nanosecondsPerTick = static_cast<double>(endNanoseconds - startNanoseconds) / static_cast<double>(endTicks - startTicks);
+            anchorTicks = static_cast<std::uint64_t>(static_cast<double>(NanosecondsPerSecond) / nanosecondsPerTick);
+        }
+    }
+};
+
+/*!
+ * @brief The time stamp counter and CLOCK_REALTIME read together by the thread.
+ * The thread re-anchors every second, so the error of the measured rate does not accumulate
+ * and the adjustments of CLOCK_REALTIME, e.g. by NTP, are followed.
+ */
+struct TscAnchor {
+    std::uint64_t ticks = 0;
+    std::int64_t nanoseconds = 0;
+};
+
+/*!
+ * @brief Returns the calibration, the first call calibrates and blocks the concurrent calls until it is done.
+ */
+const TscCalibration &tscCalibration() noexcept {
+    static const TscCalibration calibration;
+    return calibration;
+}
+#endif
+
+void rebuildCache(SecondCache &_cache, std::int64_t _second, TimestampFormatter::Format _format) noexcept {
+    const auto time = static_cast<std::time_t>(_second);
+    std::tm tm{};
+
+    if (_format == TimestampFormatter::Format::Iso8601) {
+        gmtime_r(&time, &tm);
+        _cache.prefixSize = std::strftime(_cache.prefix, sizeof(_cache.prefix), "%Y-%m-%dT%H:%M:%S", &tm);
+        _cache.suffixSize = 1;
+        _cache.suffix[0] = 'Z';
+    } else {
+        localtime_r(&time, &tm);
+        _cache.prefixSize = std::strftime(_cache.prefix, sizeof(_cache.prefix), "%a %b %e %H:%M:%S", &tm);
+        _cache.suffixSize = std::strftime(_cache.suffix, sizeof(_cache.suffix), " %Y", &tm);
+    }
+
+    _cache.second = _second;
+    _cache.format = _format;
+}
+}  // namespace
+
+std::int64_t TimestampFormatter::now() const noexcept {
+    switch (m_clockSource) {
+        case ClockSource::RealtimeCoarse:
+#ifdef CLOCK_REALTIME_COARSE
+            return readClock(CLOCK_REALTIME_COARSE);
+#else
+            break;
+#endif
+        case ClockSource::Tsc: {
+#ifdef STDCORE_HAS_TSC
+            const auto &calibration = tscCalibration();
+            if (calibration.nanosecondsPerTick > 0.0) {
+                thread_local TscAnchor anchor;
+                // the unsigned difference also re-anchors if the counter of another core is behind.
+                const auto ticks = __rdtsc() - anchor.ticks;
+                if (ticks >= calibration.anchorTicks) {
+                    anchor.nanoseconds = readClock(CLOCK_REALTIME);
+                    anchor.ticks = __rdtsc();
+                    return anchor.nanoseconds;
+                }
+
+                return anchor.nanoseconds + static_cast<std::int64_t>(static_cast<double>(ticks) * calibration.nanosecondsPerTick);
+            }
+#endif
+            break;
+        }
+        case ClockSource::System:
+            break;
+    }
+
+    return readClock(CLOCK_REALTIME);
+}
+
+void TimestampFormatter::calibrate() noexcept {
+#ifdef STDCORE_HAS_TSC
+    static_cast<void>(tscCalibration());
+#endif
+}
+
+std::size_t TimestampFormatter::format(char *_out) const noexcept {
+    return format(now(), _out);
+}
+
+std::size_t TimestampFormatter::format(std::int64_t _nanoseconds, char *_out) const noexcept {
+    thread_local SecondCache cache;
+
+    auto second = _nanoseconds / NanosecondsPerSecond;
+    auto fraction = _nanoseconds % NanosecondsPerSecond;
+    if (fraction < 0) {
+        --second;
+        fraction += NanosecondsPerSecond;
+    }
+
+    if (cache.second != second || cache.format != m_format) {
+        rebuildCache(cache, second, m_format);
+    }
+
+    std::memcpy(_out, cache.prefix, cache.prefixSize);
+    auto size = cache.prefixSize;
+
+    int digits = 0;
+    switch (m_precision) {
+        case Precision::Seconds:
+            break;
+        case Precision::Milliseconds:
+            digits = 3;
+            fraction /= 1'000'000;
+            break;
+        case Precision::Microseconds:
+            digits = 6;
+            fraction /= 1'000;
+            break;
+        case Precision::Nanoseconds:
+            digits = 9;
+            break;
+    }
+
+    if (digits != 0) {
+        _out[size++] = '.';
+        for (int i = digits - 1; i >= 0; --i) {
+            _out[size + i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        size += digits;
+    }
+
+    std::memcpy(_out + size, cache.suffix, cache.suffixSize);
+
+    return size + cache.suffixSize;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * @brief TimestampFormatter writes timestamps without allocation.
+ * The formatted text up to seconds is cached per thread, so only the sub-second digits are rewritten
+ * while the second does not change.
+ */
+class alignas(4) TimestampFormatter {
+public:
+    /*!
+     * @brief The output format.
+     */
+    enum class Format : std::uint8_t {
+        //! Local time in the std::ctime layout, e.g. "Sun Oct 18 04:07:36.123 2026".
+        Ctime,
+        //! UTC time in the ISO-8601 layout, e.g. "2026-10-18T04:07:36.123Z".
+        Iso8601
+    };
+
+    /*!
+     * @brief The number of sub-second digits.
+     */
+    enum class Precision : std::uint8_t {
+        Seconds,
+        Milliseconds,
+        Microseconds,
+        Nanoseconds
+    };
+
+    /*!
+     * @brief The clock which is read by now().
+     */
+    enum class ClockSource : std::uint8_t {
+        //! CLOCK_REALTIME.
+        System,
+        //! CLOCK_REALTIME_COARSE, it has the resolution of the scheduler tick. Falls back to System if unavailable.
+        RealtimeCoarse,
+        //! The invariant time stamp counter, its rate is calibrated once per process and every thread re-anchors it
+        //! to CLOCK_REALTIME every second. Falls back to System if unavailable or not invariant.
+        Tsc
+    };
+
+    /*!
+     * @brief The maximum number of chars written by format().
+     */
+    static constexpr std::size_t MaxSize = 48;
+
+    /*!
+     * @brief Construct a new TimestampFormatter object which writes seconds in the std::ctime layout.
+     */
+    constexpr TimestampFormatter() noexcept = default;
+
+    /*!
+     * @brief Construct a new TimestampFormatter object.
+     * @param _format - output format.
+     * @param _precision - number of sub-second digits.
+     * @param _clockSource - clock source.
+     */
+    constexpr explicit TimestampFormatter(Format _format,
+                                          Precision _precision = Precision::Seconds,
+                                          ClockSource _clockSource = ClockSource::System) noexcept
+        : m_format(_format), m_precision(_precision), m_clockSource(_clockSource) {}
+
+    /*!
+     * @brief Returns the current time in nanoseconds since the epoch read from the clock source.
+     */
+    [[nodiscard]]
+    std::int64_t now() const noexcept;
+
+    /*!
+     * @brief Writes the current time.
+     * @param _out - output, at least MaxSize chars.
+     * @return Number of written chars.
+     */
+    std::size_t format(char *_out) const noexcept;
+
+    /*!
+     * @brief Writes the time.
+     * @param _nanoseconds - nanoseconds since the epoch.
+     * @param _out - output, at least MaxSize chars.
+     * @return Number of written chars.
+     */
+    std::size_t format(std::int64_t _nanoseconds, char *_out) const noexcept;
+
+    /*!
+     * @brief Calibrates the time stamp counter of ClockSource::Tsc once per process, the first call sleeps about 10 ms.
+     * LogHelper::setTimestampFormatter() calls it, otherwise the first now() of a Tsc formatter calibrates.
+     */
+    static void calibrate() noexcept;
+
+    /*!
+     * @brief Returns the output format.
+     */
+    [[nodiscard]]
+    constexpr Format outputFormat() const noexcept { return m_format; }
+
+    /*!
+     * @brief Returns the number of sub-second digits.
+     */
+    [[nodiscard]]
+    constexpr Precision precision() const noexcept { return m_precision; }
+
+    /*!
+     * @brief Returns the clock source.
+     */
+    [[nodiscard]]
+    constexpr ClockSource clockSource() const noexcept { return m_clockSource; }
+
+private:
+    /*!
+     * @brief The output format.
+     */
+    Format m_format = Format::Ctime;
+    /*!
+     * @brief The number of sub-second digits.
+     */
+    Precision m_precision = Precision::Seconds;
+    /*!
+     * @brief The clock source.
+     */
+    ClockSource m_clockSource = ClockSource::System;
+};
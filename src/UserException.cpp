@@ -1,22 +1,91 @@
 #include "UserException.h"
 
+#include "FlightRecorder.h"
+#include "LogMetrics.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace {
+/*!
+ * @brief Counts the constructed exception in LogMetrics and lets the flight recorder dump the records preceding it.
+ */
+void exceptionConstructed(bool _nested) noexcept {
+    if constexpr (LogMetrics::Enabled) {
+        LogMetrics::add(LogMetrics::Counter::Exceptions);
+        if (_nested) {
+            LogMetrics::add(LogMetrics::Counter::NestedExceptions);
+        }
+    }
+
+    FlightRecorder::onException();
+}
+}  // namespace
+
 UserException::UserException(const std::string_view &_usrMsg,
                              const std::string_view &_dbMsg,
                              const std::string_view &_funcInfo) noexcept : std::exception(),
-                                                                           m_usrMsg(_usrMsg),
-                                                                           m_dbMsg(_dbMsg),
-                                                                           m_funcInfo(_funcInfo),
-                                                                           m_nestedException(nullptr) {
+                                                                           m_stackTrace(StackTrace::capture(1)) {
+    copyMessages(_usrMsg, _dbMsg, _funcInfo);
+    exceptionConstructed(false);
+}
+
+UserException::UserException(StaticTag,
+                             std::string_view _usrMsg,
+                             std::string_view _dbMsg,
+                             std::string_view _funcInfo,
+                             std::exception_ptr _nested) noexcept : std::exception(),
+                                                                    m_usrMsg(_usrMsg),
+                                                                    m_dbMsg(_dbMsg),
+                                                                    m_funcInfo(_funcInfo),
+                                                                    m_nestedException(std::move(_nested)),
+                                                                    m_stackTrace(StackTrace::capture(1)) {
+    exceptionConstructed(m_nestedException != nullptr);
+}
+
+UserException::UserException(const std::string_view &_usrMsg,
+                             const std::string_view &_dbMsg,
+                             const std::string_view &_funcInfo,
+                             std::exception_ptr _nested) noexcept : std::exception(),
+                                                                    m_nestedException(std::move(_nested)),
+                                                                    m_stackTrace(StackTrace::capture(1)) {
+    copyMessages(_usrMsg, _dbMsg, _funcInfo);
+    exceptionConstructed(m_nestedException != nullptr);
+}
+
+UserException::UserException(std::pmr::memory_resource *_resource,
+                             std::string_view _usrMsg,
+                             std::string_view _dbMsg,
+                             std::string_view _funcInfo,
+                             std::exception_ptr _nested) noexcept : std::exception(),
+                                                                    m_nestedException(std::move(_nested)),
+                                                                    m_stackTrace(StackTrace::capture(1)) {
+    copyMessages(_usrMsg, _dbMsg, _funcInfo, _resource);
+    exceptionConstructed(m_nestedException != nullptr);
 }
 
-UserException::~UserException() noexcept {
-    m_what.clear();
-    m_usrMsg.clear();
-    m_dbMsg.clear();
-    m_funcInfo.clear();
+UserException::~UserException() noexcept = default;
 
-    delete m_nestedException;
-    m_nestedException = nullptr;
+UserException::UserException(const UserException &_exception) noexcept : std::exception(_exception) {
+    assign(_exception);
+}
+
+UserException &UserException::operator=(const UserException &_exception) noexcept {
+    if (this != &_exception) {
+        m_what.clear();
+        assign(_exception);
+    }
+
+    return *this;
+}
+
+UserException::UserException(UserException &&_exception) noexcept : std::exception(_exception) {
+    assign(_exception);
+}
+
+UserException &UserException::operator=(UserException &&_exception) noexcept {
+    return *this = static_cast<const UserException &>(_exception);
 }
 
 const char *UserException::what() const noexcept {
@@ -38,21 +107,121 @@ std::string_view UserException::funcInfo() const noexcept {
     return m_funcInfo;
 }
 
-std::exception *UserException::nestedException() const noexcept {
+const std::exception *UserException::nestedException() const noexcept {
+    // the constructors do not resolve it, the rethrow costs a throw and an unwinding.
+    if (!m_nestedResolved.load(std::memory_order_acquire)) {
+        m_nested.store(resolve(m_nestedException), std::memory_order_relaxed);
+        m_nestedResolved.store(true, std::memory_order_release);
+    }
+
+    return m_nested.load(std::memory_order_relaxed);
+}
+
+const std::exception_ptr &UserException::nestedExceptionPtr() const noexcept {
     return m_nestedException;
 }
 
-std::string UserException::toString() const {
-    std::string str;
+const StackTrace &UserException::stackTrace() const noexcept {
+    return m_stackTrace;
+}
+
+void UserException::copyMessages(std::string_view _usrMsg, std::string_view _dbMsg, std::string_view _funcInfo,
+                                 std::pmr::memory_resource *_resource) noexcept {
+    const auto total = _usrMsg.size() + _dbMsg.size() + _funcInfo.size();
+
+    char *storage = m_inlineStorage;
+    std::size_t capacity = InlineCapacity;
+    if (total > InlineCapacity) {
+        try {
+            if (_resource != nullptr) {
+                auto *chars = static_cast<char *>(_resource->allocate(total, 1));
+                // the control block is allocated from the heap, so a rewound resource does not hold the reference count;
+                // if the allocation throws, shared_ptr calls the deleter.
+                m_heapStorage = std::shared_ptr<char[]>(chars,
+                                                        [_resource, total](char *_chars) { _resource->deallocate(_chars, total, 1); });
+                m_resourceStorage = true;
+            } else {
+                m_heapStorage.reset(new char[total]);
+            }
+            storage = m_heapStorage.get();
+            capacity = total;
+        } catch (...) {
+            // a user resource may throw anything, the messages are truncated instead.
+            m_heapStorage.reset();
+        }
+    }
+
+    std::size_t size = 0;
+    const auto copy = [storage, capacity, &size](std::string_view _message) {
+        const auto count = std::min(_message.size(), capacity - size);
+        std::memcpy(storage + size, _message.data(), count);
+        size += count;
+
+        return std::string_view(storage + size - count, count);
+    };
+
+    m_usrMsg = copy(_usrMsg);
+    m_dbMsg = copy(_dbMsg);
+    m_funcInfo = copy(_funcInfo);
+
+    if (storage == m_inlineStorage) {
+        m_inlineSize = size;
+    }
+}
+
+void UserException::assign(const UserException &_exception) noexcept {
+    m_nestedException = _exception.m_nestedException;
+    const bool resolved = _exception.m_nestedResolved.load(std::memory_order_acquire);
+    m_nested.store(resolved ? _exception.m_nested.load(std::memory_order_relaxed) : nullptr, std::memory_order_relaxed);
+    m_nestedResolved.store(resolved, std::memory_order_release);
+    m_stackTrace = _exception.m_stackTrace;
+
+    // the resource may be rewound before the copy is destroyed, e.g. by MemoryResourceScope, so the copy takes the heap.
+    if (_exception.m_resourceStorage) {
+        m_heapStorage.reset();
+        m_resourceStorage = false;
+        copyMessages(_exception.m_usrMsg, _exception.m_dbMsg, _exception.m_funcInfo);
+        return;
+    }
+
+    m_heapStorage = _exception.m_heapStorage;
+    m_resourceStorage = false;
+    m_inlineSize = _exception.m_inlineSize;
+    std::memcpy(m_inlineStorage, _exception.m_inlineStorage, m_inlineSize);
+
+    const auto *first = _exception.m_inlineStorage;
+    const auto rebase = [this, first](std::string_view _message) {
+        if (_message.data() >= first && _message.data() < first + InlineCapacity) {
+            return std::string_view(m_inlineStorage + (_message.data() - first), _message.size());
+        }
+
+        return _message;
+    };
 
-    str.append("The exception in function ").append(m_funcInfo).append("\n");
-    str.append("User message: ").append(m_usrMsg).append("\n");
-    str.append("Debug message: ").append(m_dbMsg).append("\n");
+    m_usrMsg = rebase(_exception.m_usrMsg);
+    m_dbMsg = rebase(_exception.m_dbMsg);
+    m_funcInfo = rebase(_exception.m_funcInfo);
+}
+
+const std::exception *UserException::resolve(const std::exception_ptr &_exception) noexcept {
+    if (!_exception) {
+        return nullptr;
+    }
 
-    if (m_nestedException != nullptr) {
-       str.append(m_nestedException->what()).append("\n");
+    // std::rethrow_exception() throws the held object itself, so the pointer stays valid while the exception_ptr holds it.
+    try {
+        std::rethrow_exception(_exception);
+    } catch (const std::exception &_nested) {
+        return &_nested;
+    } catch (...) {
     }
-    str.append("\n");
+
+    return nullptr;
+}
+
+std::string UserException::toString() const {
+    std::string str;
+    writeTo(str, WriteOptions{false, std::numeric_limits<std::size_t>::max()});
 
     return str;
-}
\ No newline at end of file
+}
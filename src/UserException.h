@@ -1,21 +1,74 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <exception>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <type_traits>
+
+#include "StackTrace.h"
 
 /**
  * @brief UserException is the user exception. It contains the name of function that threw exception, the user message, the debug message and
  * it can store a nested exception.
- * 
+ * The messages passed with the Static tag are kept as views. Other messages are copied into the inline buffer,
+ * the heap is used only if they do not fit. The nested exception is held by std::exception_ptr,
+ * so copying the exception during unwinding copies no strings and allocates nothing.
+ * writeTo() streams the exception and the nested chain into a buffer without the intermediate strings.
+ * If StackTrace capture is enabled, the constructors keep the raw frames, they are symbolized when the exception is written.
+ *
  */
 class UserException : public std::exception {
 public:
     /**
-    * @brief Construct a new UserException object.
-    * 
+     * @brief The tag of the constructor which keeps the messages as views.
+     *
+     */
+    struct StaticTag {};
+
+    /**
+     * @brief The messages have the static storage duration, e.g. string literals and __PRETTY_FUNCTION__.
+     *
+     */
+    static constexpr StaticTag Static{};
+
+    /**
+     * @brief The size of the inline buffer for the copied messages.
+     *
+     */
+    static constexpr std::size_t InlineCapacity = 256;
+
+    /**
+     * @brief The options of writeTo().
+     *
+     */
+    struct WriteOptions {
+        /**
+         * @brief Write "user message (debug message) in function; caused by: ..." on one line.
+         *
+         */
+        bool singleLine = false;
+        /**
+         * @brief The number of the exceptions of the nested chain written, the rest is replaced with "...".
+         *
+         */
+        std::size_t maxDepth = 8;
+        /**
+         * @brief Write the stack traces in the multi-line format.
+         *
+         */
+        bool withStackTrace = true;
+    };
+
+    /**
+    * @brief Construct a new UserException object. The messages are copied.
+    *
     * @param _usrMsg - user message.
-    * @param _dbMsg - debug message. 
+    * @param _dbMsg - debug message.
     * @param _funcInfo - function name.
     */
     explicit UserException(const std::string_view &_usrMsg,
@@ -23,12 +76,58 @@ public:
                            const std::string_view &_funcInfo) noexcept;
 
     /**
-    * @brief Construct a new UserException object.
-    * 
+    * @brief Construct a new UserException object. The messages are kept as views, nothing is copied.
+    *
+    * @param _usrMsg - user message with the static storage duration.
+    * @param _dbMsg - debug message with the static storage duration.
+    * @param _funcInfo - function name with the static storage duration.
+    * @param _nested - nested exception, e.g. std::current_exception().
+    */
+    UserException(StaticTag,
+                  std::string_view _usrMsg,
+                  std::string_view _dbMsg,
+                  std::string_view _funcInfo,
+                  std::exception_ptr _nested = nullptr) noexcept;
+
+    /**
+    * @brief Construct a new UserException object. The messages are copied.
+    *
     * @param _usrMsg - user message.
-    * @param _dbMsg - debug message. 
+    * @param _dbMsg - debug message.
     * @param _funcInfo - function name.
-    * @param _exception - nested exception.
+    * @param _nested - nested exception, e.g. std::current_exception().
+    */
+    explicit UserException(const std::string_view &_usrMsg,
+                           const std::string_view &_dbMsg,
+                           const std::string_view &_funcInfo,
+                           std::exception_ptr _nested) noexcept;
+
+    /**
+    * @brief Construct a new UserException object. The messages are copied, the ones which do not fit into the inline buffer
+    * are allocated from the resource instead of the heap. The resource must outlive this object, so an exception of
+    * a MemoryResourceScope resource must not be thrown as a temporary out of the scope, which rewinds the resource
+    * during the unwinding. A copy of the exception, e.g. `throw exception;` of a named one, copies the messages
+    * to the heap and may leave the scope.
+    *
+    * @param _resource - memory resource.
+    * @param _usrMsg - user message.
+    * @param _dbMsg - debug message.
+    * @param _funcInfo - function name.
+    * @param _nested - nested exception, e.g. std::current_exception().
+    */
+    UserException(std::pmr::memory_resource *_resource,
+                  std::string_view _usrMsg,
+                  std::string_view _dbMsg,
+                  std::string_view _funcInfo,
+                  std::exception_ptr _nested = nullptr) noexcept;
+
+    /**
+    * @brief Construct a new UserException object. The messages are copied.
+    *
+    * @param _usrMsg - user message.
+    * @param _dbMsg - debug message.
+    * @param _funcInfo - function name.
+    * @param _exception - nested exception, it is copied into std::exception_ptr.
     */
     template<class T,
             typename = typename std::enable_if_t<std::is_base_of_v<std::exception, std::decay_t<T>>>>
@@ -39,95 +138,188 @@ public:
 
     /**
      * @brief Destroy the UserException object
-     * 
+     *
      */
-    virtual ~UserException() noexcept;
+    ~UserException() noexcept override;
 
     /**
      * @brief Returns information about the exception.
-     * 
+     *
      */
     [[nodiscard]] const char *what() const noexcept override;
 
     /**
      * @brief Construct a new UserException object
-     * 
+     *
      */
-    UserException(const UserException &_exception) = default;
+    UserException(const UserException &_exception) noexcept;
 
     /**
      * @brief Copy operator.
-     * 
+     *
      */
-    UserException &operator=(const UserException &_exception) = default;
+    UserException &operator=(const UserException &_exception) noexcept;
 
     /**
      * @brief Move construct a new UserException object.
-     * 
+     *
      */
-    UserException(UserException &&_exception) noexcept = default;
+    UserException(UserException &&_exception) noexcept;
 
     /**
      * @brief Move operator.
-     * 
+     *
      */
-    UserException &operator=(UserException &&_exception) noexcept = default;
+    UserException &operator=(UserException &&_exception) noexcept;
 
     /**
      * @brief Return the user message.
-     * 
+     *
      */
     std::string_view usrMsg() const noexcept;
 
     /**
      * @brief Return the debug message.
-     * 
+     *
      */
     std::string_view dbMsg() const noexcept;
 
     /**
      * @brief Return the function name.
-     * 
+     *
      */
     std::string_view funcInfo() const noexcept;
 
     /**
-     * @brief Return the nested exception.
-     * 
+     * @brief Return the nested exception or nullptr if there is none or it is not derived from std::exception.
+     * The first call resolves it by rethrowing the exception pointer.
+     *
+     */
+    const std::exception *nestedException() const noexcept;
+
+    /**
+     * @brief Return the nested exception pointer, e.g. for std::rethrow_exception().
+     *
+     */
+    const std::exception_ptr &nestedExceptionPtr() const noexcept;
+
+    /**
+     * @brief Return the stack trace captured by the constructor, it is empty if the capture is disabled.
+     *
+     */
+    const StackTrace &stackTrace() const noexcept;
+
+    /**
+     * @brief Writes the exception and the nested chain in the format of what(), limited to WriteOptions::maxDepth levels.
+     *
+     * @param _buffer - the destination with append(const char *, size_t), e.g. CharFastStackBuffer or std::string.
      */
-    std::exception *nestedException() const noexcept;
+    template<class Buffer_t>
+    void writeTo(Buffer_t &_buffer) const;
+
+    /**
+     * @brief Writes the exception and the nested chain.
+     *
+     * @param _buffer - the destination with append(const char *, size_t), e.g. CharFastStackBuffer or std::string.
+     * @param _options - the format.
+     */
+    template<class Buffer_t>
+    void writeTo(Buffer_t &_buffer, const WriteOptions &_options) const;
 
 private:
+    /**
+     * @brief Writes the exception and the nested chain, _depth exceptions of the chain are already written.
+     *
+     */
+    template<class Buffer_t>
+    void writeTo(Buffer_t &_buffer, const WriteOptions &_options, std::size_t _depth) const;
+
+    /**
+     * @brief Returns the held exception if it is derived from std::exception, otherwise nullptr.
+     *
+     */
+    static const std::exception *resolve(const std::exception_ptr &_exception) noexcept;
+
+    /**
+     * @brief Copies the messages into the inline buffer or, if they do not fit, into the buffer allocated from the resource,
+     * the heap if it is nullptr. If the buffer cannot be allocated, the messages are truncated to the inline buffer.
+     *
+     */
+    void copyMessages(std::string_view _usrMsg, std::string_view _dbMsg, std::string_view _funcInfo,
+                      std::pmr::memory_resource *_resource = nullptr) noexcept;
+
+    /**
+     * @brief Takes the messages of the other exception. The views into its inline buffer are moved to this buffer.
+     *
+     */
+    void assign(const UserException &_exception) noexcept;
+
     /**
     * @brief Information about the exception.
-    * 
+    *
     */
     mutable std::string m_what;
 
     /**
      * @brief The user message.
-     * 
+     *
      */
-    std::string m_usrMsg;
+    std::string_view m_usrMsg;
     /**
      * @brief The debug message.
-     * 
+     *
      */
-    std::string m_dbMsg;
+    std::string_view m_dbMsg;
     /**
      * @brief The function name.
-     * 
+     *
      */
-    std::string m_funcInfo;
+    std::string_view m_funcInfo;
     /**
      * @brief The nested exception.
-     * 
+     *
+     */
+    std::exception_ptr m_nestedException;
+    /**
+     * @brief The object held by m_nestedException, resolved by the first nestedException() call.
+     *
      */
-    std::exception *m_nestedException;
+    mutable std::atomic<const std::exception *> m_nested{nullptr};
+    /**
+     * @brief m_nested has been resolved.
+     *
+     */
+    mutable std::atomic<bool> m_nestedResolved{false};
+    /**
+     * @brief The stack trace of the constructor caller.
+     *
+     */
+    StackTrace m_stackTrace;
+    /**
+     * @brief The copied messages which do not fit into the inline buffer, shared by the copies of the exception.
+     * The buffer is allocated from the memory resource if the constructor is given one, the control block from the heap.
+     *
+     */
+    std::shared_ptr<char[]> m_heapStorage;
+    /**
+     * @brief m_heapStorage is allocated from a memory resource, the copies of the exception do not share it.
+     *
+     */
+    bool m_resourceStorage = false;
+    /**
+     * @brief The number of used chars of the inline buffer.
+     *
+     */
+    std::size_t m_inlineSize = 0;
+    /**
+     * @brief The copied messages.
+     *
+     */
+    char m_inlineStorage[InlineCapacity];
 
     /**
      * @brief Returns information about the exception, taking into account the nested level.
-     * 
+     *
      */
     std::string toString() const;
 };
@@ -136,9 +328,61 @@ template<class T, typename>
 UserException::UserException(const std::string_view &_usrMsg,
                              const std::string_view &_dbMsg,
                              const std::string_view &_funcInfo,
-                             T &&_exception) noexcept : std::exception(),
-                                                        m_usrMsg(_usrMsg),
-                                                        m_dbMsg(_dbMsg),
-                                                        m_funcInfo(_funcInfo) {
-    m_nestedException = new std::decay_t<T>(std::forward<T>(_exception));
+                             T &&_exception) noexcept : UserException(_usrMsg, _dbMsg, _funcInfo,
+                                                                      std::make_exception_ptr(std::forward<T>(_exception))) {
+}
+
+template<class Buffer_t>
+void UserException::writeTo(Buffer_t &_buffer) const {
+    writeTo(_buffer, WriteOptions{}, 0);
+}
+
+template<class Buffer_t>
+void UserException::writeTo(Buffer_t &_buffer, const WriteOptions &_options) const {
+    writeTo(_buffer, _options, 0);
+}
+
+template<class Buffer_t>
+void UserException::writeTo(Buffer_t &_buffer, const WriteOptions &_options, std::size_t _depth) const {
+    const auto write = [&_buffer](std::string_view _str) {
+        _buffer.append(_str.data(), _str.size());
+    };
+    const auto writeNested = [&]() {
+        if (_depth + 1 >= _options.maxDepth) {
+            write("...");
+        } else if (const auto *nested = dynamic_cast<const UserException *>(nestedException()); nested != nullptr) {
+            nested->writeTo(_buffer, _options, _depth + 1);
+        } else {
+            write(nestedException()->what());
+        }
+    };
+
+    if (_options.singleLine) {
+        write(m_usrMsg);
+        write(" (");
+        write(m_dbMsg);
+        write(") in ");
+        write(m_funcInfo);
+        if (nestedException() != nullptr) {
+            write("; caused by: ");
+            writeNested();
+        }
+    } else {
+        write("The exception in function ");
+        write(m_funcInfo);
+        write("\nUser message: ");
+        write(m_usrMsg);
+        write("\nDebug message: ");
+        write(m_dbMsg);
+        write("\n");
+        if (_options.withStackTrace && !m_stackTrace.isEmpty()) {
+            write("Stack trace:\n");
+            m_stackTrace.writeTo(_buffer);
+        }
+        if (nestedException() != nullptr) {
+            writeNested();
+            write("\n");
+        }
+        write("\n");
+    }
 }
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+
+#include "AsyncLogWriter.h"
+
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/*!
+ * @brief The stream buffer which blocks the writer thread on the first write until it is released.
+ */
+class BlockingStreamBuf : public std::stringbuf {
+public:
+    std::promise<void> entered;
+    std::promise<void> released;
+
+protected:
+    std::streamsize xsputn(const char *_s, std::streamsize _count) override {
+        if (!m_blocked) {
+            m_blocked = true;
+            entered.set_value();
+            released.get_future().wait();
+        }
+
+        return std::stringbuf::xsputn(_s, _count);
+    }
+
+private:
+    bool m_blocked = false;
+};
+}  // namespace
+
+TEST(AsyncLogWriterTest, flush_writes_all_records_test) {
+    std::ostringstream os;
+    AsyncLogWriter writer(os, 16);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&writer] {
+            for (int i = 0; i < 100; ++i) {
+                ASSERT_NE(writer.push("record"), AsyncLogWriter::PushResult::Stopped);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    writer.flush();
+
+    std::string expected;
+    for (int i = 0; i < 400; ++i) {
+        expected.append("record\n");
+    }
+    ASSERT_EQ(os.str(), expected);
+    ASSERT_EQ(writer.dropped(), 0u);
+}
+
+TEST(AsyncLogWriterTest, stop_drains_queue_test) {
+    std::ostringstream os;
+    AsyncLogWriter writer(os);
+
+    ASSERT_EQ(writer.push("first"), AsyncLogWriter::PushResult::Queued);
+    ASSERT_EQ(writer.push("second"), AsyncLogWriter::PushResult::Queued);
+    writer.stop();
+
+    ASSERT_EQ(os.str(), "first\nsecond\n");
+    ASSERT_EQ(writer.push("third"), AsyncLogWriter::PushResult::Stopped);
+}
+
+TEST(AsyncLogWriterTest, block_policy_waits_for_slot_test) {
+    BlockingStreamBuf streamBuf;
+    std::ostream os(&streamBuf);
+    AsyncLogWriter writer(os, 2, AsyncLogWriter::OverflowPolicy::Block);
+
+    ASSERT_EQ(writer.push("0"), AsyncLogWriter::PushResult::Queued);
+    streamBuf.entered.get_future().wait();
+    ASSERT_EQ(writer.push("1"), AsyncLogWriter::PushResult::Queued);
+    ASSERT_EQ(writer.push("2"), AsyncLogWriter::PushResult::Queued);
+
+    auto blocked = std::async(std::launch::async, [&writer] { return writer.push("3"); });
+    ASSERT_EQ(blocked.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+    streamBuf.released.set_value();
+    ASSERT_EQ(blocked.get(), AsyncLogWriter::PushResult::Queued);
+    writer.flush();
+
+    ASSERT_EQ(streamBuf.str(), "0\n1\n2\n3\n");
+    ASSERT_EQ(writer.dropped(), 0u);
+}
+
+TEST(AsyncLogWriterTest, drop_newest_policy_test) {
+    BlockingStreamBuf streamBuf;
+    std::ostream os(&streamBuf);
+    AsyncLogWriter writer(os, 2, AsyncLogWriter::OverflowPolicy::DropNewest);
+
+    ASSERT_EQ(writer.push("a"), AsyncLogWriter::PushResult::Queued);
+    streamBuf.entered.get_future().wait();
+
+    ASSERT_EQ(writer.push("b"), AsyncLogWriter::PushResult::Queued);
+    ASSERT_EQ(writer.push("c"), AsyncLogWriter::PushResult::Queued);
+    ASSERT_EQ(writer.push("d"), AsyncLogWriter::PushResult::Dropped);
+
+    streamBuf.released.set_value();
+    writer.flush();
+
+    ASSERT_EQ(streamBuf.str(), "a\nb\nc\n");
+    ASSERT_EQ(writer.dropped(), 1u);
+}
+
+TEST(AsyncLogWriterTest, drop_oldest_policy_test) {
+    BlockingStreamBuf streamBuf;
+    std::ostream os(&streamBuf);
+    AsyncLogWriter writer(os, 2, AsyncLogWriter::OverflowPolicy::DropOldest);
+
+    ASSERT_EQ(writer.push("a"), AsyncLogWriter::PushResult::Queued);
+    streamBuf.entered.get_future().wait();
+
+    ASSERT_EQ(writer.push("b"), AsyncLogWriter::PushResult::Queued);
+    ASSERT_EQ(writer.push("c"), AsyncLogWriter::PushResult::Queued);
+    ASSERT_EQ(writer.push("d"), AsyncLogWriter::PushResult::Dropped);
+
+    streamBuf.released.set_value();
+    writer.flush();
+
+    ASSERT_EQ(streamBuf.str(), "a\nc\nd\n");
+    ASSERT_EQ(writer.dropped(), 1u);
+}
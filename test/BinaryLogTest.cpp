@@ -0,0 +1,254 @@
+#include "gtest/gtest.h"
+
+#include "BinaryLogDecoder.h"
+#include "BinaryLogWriter.h"
+#include "LogHelper.h"
+#include "RecordingSink.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+//! 2023-11-14T22:13:20.123456789Z
+constexpr std::int64_t TestTime = 1'700'000'000'123'456'789;
+
+const BinaryLogDecoder::Options IsoOptions{
+        TimestampFormatter(TimestampFormatter::Format::Iso8601, TimestampFormatter::Precision::Milliseconds)};
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream &operator<<(std::ostream &_os, const Point &_point) {
+    return _os << '(' << _point.x << ", " << _point.y << ')';
+}
+/*!
+ * @brief The string buffer whose writes block while it is closed, so the test controls when the writer drains.
+ */
+class GatedStringBuf : public std::stringbuf {
+public:
+    void close() {
+        std::lock_guard lock(m_mutex);
+        m_closed = true;
+    }
+
+    void open() {
+        std::lock_guard lock(m_mutex);
+        m_closed = false;
+        m_changed.notify_all();
+    }
+
+    //! Waits until a write is blocked.
+    void waitUntilBlocked() {
+        std::unique_lock lock(m_mutex);
+        m_changed.wait(lock, [this] { return m_blocked; });
+    }
+
+protected:
+    std::streamsize xsputn(const char *_data, std::streamsize _size) override {
+        {
+            std::unique_lock lock(m_mutex);
+            m_blocked = m_closed;
+            m_changed.notify_all();
+            m_changed.wait(lock, [this] { return !m_closed; });
+        }
+
+        return std::stringbuf::xsputn(_data, _size);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_closed = false;
+    bool m_blocked = false;
+};
+
+std::string binaryRecord(std::int64_t _timestamp, int _value) {
+    CharFastStackBuffer<char, 1024> record;
+    BinaryLogFormat::beginRecord(record, 3, 0, _timestamp);
+    BinaryLogFormat::encode(record, _value);
+    BinaryLogFormat::endRecord(record);
+
+    return std::string(record.view());
+}
+}  // namespace
+
+TEST(BinaryLogTest, encode_decode_test) {
+    static const LogSite site("file.cpp", 42);
+
+    CharFastStackBuffer<char, 1024> record;
+    BinaryLogFormat::beginRecord(record, 1, BinaryLogWriter::siteId(site), TestTime);
+    BinaryLogFormat::encode(record, "int ");
+    BinaryLogFormat::encode(record, -42);
+    BinaryLogFormat::encode(record, std::string(" double "));
+    BinaryLogFormat::encode(record, 1.5);
+    BinaryLogFormat::encode(record, ' ');
+    BinaryLogFormat::encode(record, true);
+    BinaryLogFormat::encode(record, ' ');
+    BinaryLogFormat::encode(record, hexFormat(255u));
+    BinaryLogFormat::encode(record, ' ');
+    BinaryLogFormat::encode(record, fixedFormat(3.14159, 2));
+    BinaryLogFormat::encode(record, ' ');
+    BinaryLogFormat::encode(record, exceptionFormat(UserException(UserException::Static, "usr", "db", "f"), {true, 8}));
+    BinaryLogFormat::endRecord(record);
+
+    std::stringstream binary;
+    {
+        BinaryLogWriter writer(binary);
+        ASSERT_TRUE(writer.push(record.view()));
+    }
+
+    std::ostringstream text;
+    BinaryLogDecoder decoder(BinaryLogDecoder::Options{IsoOptions.timestampFormatter, true});
+    decoder.decodeStream(binary, text);
+
+    ASSERT_EQ(text.str(), "2023-11-14T22:13:20.123Z [Error] file.cpp:42 int -42 double 1.5 true ff 3.14 usr (db) in f\n");
+}
+
+TEST(BinaryLogTest, truncated_record_test) {
+    CharFastStackBuffer<char, 64, TruncateOnOverflow> record;
+    BinaryLogFormat::beginRecord(record, 1, 0, TestTime);
+    BinaryLogFormat::encode(record, 42);
+    BinaryLogFormat::encode(record, std::string(100, 'a'));
+    BinaryLogFormat::encode(record, 1.5);
+    BinaryLogFormat::endRecord(record);
+
+    ASSERT_TRUE(record.isFull());
+    ASSERT_GT(record.truncated(), 0u);
+
+    std::ostringstream text;
+    BinaryLogDecoder decoder(IsoOptions);
+    ASSERT_EQ(decoder.decode(record.view(), text), record.view().size());
+    ASSERT_EQ(text.str(), "2023-11-14T22:13:20.123Z 42" + std::string(64 - 18 - 9 - 5, 'a') + "\n");
+}
+
+TEST(BinaryLogTest, corrupted_stream_test) {
+    std::stringstream binary("not a binary log");
+    std::ostringstream text;
+
+    BinaryLogDecoder decoder;
+    ASSERT_THROW(decoder.decodeStream(binary, text), UserException);
+}
+
+TEST(BinaryLogTest, multithreaded_writer_test) {
+    std::stringstream binary;
+    {
+        BinaryLogWriter writer(binary);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&writer, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    CharFastStackBuffer<char, 1024> record;
+                    BinaryLogFormat::beginRecord(record, 3, 0, TestTime);
+                    BinaryLogFormat::encode(record, t * 1000 + i);
+                    BinaryLogFormat::endRecord(record);
+                    ASSERT_TRUE(writer.push(record.view()));
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::ostringstream text;
+    BinaryLogDecoder decoder(IsoOptions);
+    decoder.decodeStream(binary, text);
+
+    const auto output = text.str();
+    ASSERT_EQ(std::count(output.begin(), output.end(), '\n'), 4000);
+    ASSERT_NE(output.find("2023-11-14T22:13:20.123Z 3999\n"), std::string::npos);
+}
+
+TEST(BinaryLogTest, threads_merged_by_time_test) {
+    GatedStringBuf buffer;
+    std::iostream binary(&buffer);
+    {
+        BinaryLogWriter writer(binary);
+
+        // the drain of the first record blocks, so the records of the threads are taken by the next drain.
+        buffer.close();
+        ASSERT_TRUE(writer.push(binaryRecord(TestTime, 0)));
+        buffer.waitUntilBlocked();
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t <= 2; ++t) {
+            threads.emplace_back([&writer, t] {
+                for (int i = t; i <= 6; i += 2) {
+                    ASSERT_TRUE(writer.push(binaryRecord(TestTime + i, i)));
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        buffer.open();
+    }
+
+    std::ostringstream text;
+    BinaryLogDecoder decoder(IsoOptions);
+    decoder.decodeStream(binary, text);
+
+    std::string expected;
+    for (int i = 0; i <= 6; ++i) {
+        expected += "2023-11-14T22:13:20.123Z " + std::to_string(i) + '\n';
+    }
+    ASSERT_EQ(text.str(), expected);
+}
+
+TEST(BinaryLogTest, full_staging_buffer_waits_test) {
+    std::stringstream binary;
+    std::size_t pushed = 0;
+    {
+        BinaryLogWriter writer(binary);
+        const auto record = binaryRecord(TestTime, 1);
+        // several times the staging buffer, the producer waits for the drains.
+        for (; pushed < 4 * BinaryLogWriter::StagingCapacity / record.size(); ++pushed) {
+            ASSERT_TRUE(writer.push(record));
+        }
+    }
+
+    std::ostringstream text;
+    BinaryLogDecoder decoder(IsoOptions);
+    decoder.decodeStream(binary, text);
+
+    const auto output = text.str();
+    ASSERT_EQ(static_cast<std::size_t>(std::count(output.begin(), output.end(), '\n')), pushed);
+}
+
+TEST(BinaryLogTest, log_helper_deferred_text_test) {
+    std::ostringstream text;
+    LogHelper::enableBinary(text, BinaryLogWriter::Output::Text);
+
+    STDCORE_LOG_ERROR << "point " << Point{1, 2} << " value " << 42;
+    LogHelper::disableBinary();
+
+    ASSERT_NE(text.str().find(" point (1, 2) value 42\n"), std::string::npos);
+}
+
+TEST(BinaryLogTest, record_after_disable_goes_to_sink_test) {
+    auto sink = std::make_shared<RecordingSink>();
+    LogHelper::setSink(sink);
+    std::ostringstream binary;
+    LogHelper::enableBinary(binary);
+    {
+        // the record is encoded in the binary mode and written after it has been disabled.
+        LogHelper helper(LogHelper::LogLevel::Warning);
+        helper << "late " << 7;
+        LogHelper::disableBinary();
+    }
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(sink->records.size(), 1u);
+    ASSERT_NE(sink->records[0].find(" late 7"), std::string::npos);
+    ASSERT_NE(sink->records[0].back(), '\n');
+    ASSERT_EQ(sink->levels[0], LogLevel::Warning);
+}
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include "FastStackStreamBuffer.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+TEST(CharFastStackBufferTest, append_char_sequences_test) {
+    CharFastStackBuffer<char, 64> buffer;
+
+    buffer << "literal" << std::string(" string") << std::string_view(" view");
+    const char *cString = " pointer";
+    buffer << cString << std::vector<char>{' ', 'v'} << std::list<char>{' ', 'l'};
+
+    ASSERT_EQ(buffer.view(), "literal string view pointer v l");
+}
+
+TEST(CharFastStackBufferTest, append_overflow_test) {
+    CharFastStackBuffer<char, 8> buffer;
+
+    buffer << "1234";
+    ASSERT_THROW(buffer << "56789", UserException);
+    ASSERT_EQ(buffer.view(), "1234");
+
+    buffer << "5678";
+    ASSERT_TRUE(buffer.isFull());
+}
+
+TEST(CharFastStackBufferTest, stream_buffer_put_area_test) {
+    CharFastStackBuffer<char, 32> buffer;
+    FastStackStreamBuffer<char, 32> streamBuffer(buffer);
+    std::ostream os(&streamBuffer);
+
+    os << 42 << ' ' << 1.5 << std::flush;
+    ASSERT_EQ(buffer.view(), "42 1.5");
+
+    buffer << " direct";
+    streamBuffer.pubsync();
+    os << " stream" << std::flush;
+    ASSERT_EQ(buffer.view(), "42 1.5 direct stream");
+
+    os << std::string(32, 'x');
+    ASSERT_TRUE(os.bad());
+
+    streamBuffer.pubsync();
+    ASSERT_TRUE(buffer.isFull());
+}
+
+TEST(CharFastStackBufferTest, format_numbers_test) {
+    CharFastStackBuffer<char, 128> buffer;
+
+    buffer << 42 << ' ' << -7L << ' ' << 42u << ' ' << 1.5 << ' ' << 0.25f << ' ' << true << ' ' << false;
+    ASSERT_EQ(buffer.view(), "42 -7 42 1.5 0.25 true false");
+
+    buffer.resizeUninitialized(0);
+    buffer << hexFormat(255) << ' ' << fixedFormat(3.14159, 2) << ' ' << static_cast<const void *>(nullptr);
+    ASSERT_EQ(buffer.view(), "ff 3.14 0x0");
+
+    buffer.resizeUninitialized(0);
+    int value = 0;
+    buffer << &value;
+    ASSERT_EQ(buffer.view().substr(0, 2), "0x");
+}
+
+TEST(CharFastStackBufferTest, format_numbers_nearly_full_test) {
+    CharFastStackBuffer<char, 8> buffer;
+
+    buffer << "12345" << 678;
+    ASSERT_EQ(buffer.view(), "12345678");
+
+    buffer.resizeUninitialized(6);
+    ASSERT_THROW(buffer << 1234, UserException);
+    ASSERT_EQ(buffer.view(), "123456");
+}
+
+TEST(CharFastStackBufferTest, truncation_marker_test) {
+    CharFastStackBuffer<char, 40, TruncateWithMarkerOnOverflow> buffer;
+    FastStackStreamBuffer<char, 40, TruncateWithMarkerOnOverflow> streamBuffer(buffer);
+    std::ostream os(&streamBuffer);
+
+    buffer << std::string(30, 'x');
+    streamBuffer.pubsync();
+    os << std::string(20, 'y') << std::flush;
+    ASSERT_TRUE(os.good());
+    ASSERT_TRUE(buffer.isFull());
+    ASSERT_EQ(buffer.truncated(), 10);
+
+    buffer << 12345;
+    ASSERT_EQ(buffer.truncated(), 15);
+
+    buffer.writeTruncationMarker();
+    ASSERT_EQ(buffer.view(), std::string(17, 'x') + "\xE2\x80\xA6[truncated 38 bytes]");
+
+    CharFastStackBuffer<char, 40, TruncateWithMarkerOnOverflow> shortBuffer;
+    shortBuffer << "short";
+    shortBuffer.writeTruncationMarker();
+    ASSERT_EQ(shortBuffer.view(), "short");
+}
+
+TEST(CharFastStackBufferTest, grow_on_overflow_test) {
+    CharFastStackBuffer<char, 16, GrowOnOverflow> buffer;
+    FastStackStreamBuffer<char, 16, GrowOnOverflow> streamBuffer(buffer);
+    std::ostream os(&streamBuffer);
+
+    buffer << std::string(10, 'x') << 123456789;
+    ASSERT_FALSE(buffer.isInline());
+    ASSERT_EQ(buffer.view(), std::string(10, 'x') + "123456789");
+
+    streamBuffer.pubsync();
+    os << std::string(40, 'y') << 'z' << std::flush;
+    ASSERT_TRUE(os.good());
+    ASSERT_EQ(buffer.view(), std::string(10, 'x') + "123456789" + std::string(40, 'y') + "z");
+    ASSERT_EQ(buffer.truncated(), 0);
+
+    CharFastStackBuffer<char, 16, GrowOnOverflow> copy = buffer;
+    auto moved = std::move(copy);
+    ASSERT_EQ(moved.view(), buffer.view());
+    ASSERT_TRUE(copy.isEmpty());
+    ASSERT_TRUE(copy.isInline());
+}
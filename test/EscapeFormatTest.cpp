@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+
+#include "EscapeFormat.h"
+
+#include <random>
+#include <string>
+
+namespace {
+using Buffer = CharFastStackBuffer<char, 1024>;
+
+constexpr EscapeMode Modes[] = {EscapeMode::Json, EscapeMode::Logfmt, EscapeMode::StripControl, EscapeMode::Utf8};
+
+template<class... Args_t>
+std::string escaped(Args_t &&..._args) {
+    Buffer buffer;
+    buffer << escapeFormat(std::forward<Args_t>(_args)...);
+    return std::string(buffer.view());
+}
+}  // namespace
+
+TEST(EscapeFormatTest, json_test) {
+    ASSERT_EQ(escaped("plain", EscapeMode::Json), "plain");
+    ASSERT_EQ(escaped("a\"b\\c\nd\te\x01", EscapeMode::Json), "a\\\"b\\\\c\\nd\\te\\u0001");
+    ASSERT_EQ(escaped(std::string(40, 'x') + "\n", EscapeMode::Json), std::string(40, 'x') + "\\n");
+}
+
+TEST(EscapeFormatTest, logfmt_test) {
+    ASSERT_EQ(escaped("plain", EscapeMode::Logfmt), "plain");
+    ASSERT_EQ(escaped("", EscapeMode::Logfmt), "\"\"");
+    ASSERT_EQ(escaped("a b=c", EscapeMode::Logfmt), "\"a b=c\"");
+    ASSERT_EQ(escaped("line\n", EscapeMode::Logfmt), "\"line\\n\"");
+}
+
+TEST(EscapeFormatTest, strip_control_test) {
+    ASSERT_EQ(escaped("a\nb\r\nc\td\x01\x7F" "e", EscapeMode::StripControl), "a b  c de");
+}
+
+TEST(EscapeFormatTest, utf8_test) {
+    // "é", "€", "😀" are valid; a lone continuation byte, an overlong '/', a surrogate and a truncated sequence are not.
+    ASSERT_EQ(escaped("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", EscapeMode::Utf8), "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+    ASSERT_EQ(escaped("a\x80" "b", EscapeMode::Utf8), "a\xEF\xBF\xBD" "b");
+    ASSERT_EQ(escaped("\xC0\xAF", EscapeMode::Utf8), "\xEF\xBF\xBD\xEF\xBF\xBD");
+    ASSERT_EQ(escaped("\xED\xA0\x80", EscapeMode::Utf8), "\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD");
+    ASSERT_EQ(escaped("\xE2\x82", EscapeMode::Utf8), "\xEF\xBF\xBD\xEF\xBF\xBD");
+    ASSERT_EQ(escaped("\"\xFF\"", EscapeMode::Json, true), "\\\"\xEF\xBF\xBD\\\"");
+    ASSERT_EQ(escaped("\xFF", EscapeMode::Json), "\xFF");
+}
+
+TEST(EscapeFormatTest, vector_matches_scalar_test) {
+    std::mt19937 random(42);
+    // mostly plain chars with the special ones and the high bytes here and there.
+    const std::string alphabet = std::string(48, 'a') + " =\"\\\n\x01\x1F\x20\x7F\x80\xC3\xFF";
+    std::uniform_int_distribution<std::size_t> charDistribution(0, alphabet.size() - 1);
+    std::uniform_int_distribution<std::size_t> sizeDistribution(0, 100);
+
+    for (int i = 0; i < 2000; ++i) {
+        std::string str(sizeDistribution(random), ' ');
+        for (auto &c : str) {
+            c = alphabet[charDistribution(random)];
+        }
+
+        for (const auto mode : Modes) {
+            for (const bool validate : {false, true}) {
+                const auto expected = EscapeScanner::find(EscapeScanner::Isa::Scalar, str, mode, validate);
+                for (const auto isa : {EscapeScanner::Isa::Sse2, EscapeScanner::Isa::Avx2}) {
+                    if (EscapeScanner::isSupported(isa)) {
+                        ASSERT_EQ(EscapeScanner::find(isa, str, mode, validate), expected) << str;
+                    }
+                }
+                ASSERT_EQ(EscapeScanner::find(str, mode, validate), expected) << str;
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+
+#include "FastRingBuffer.h"
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::size_t ItemsPerProducer = 100000;
+
+template<class Queue_t>
+void checkSingleThreaded(Queue_t &_queue) {
+    ASSERT_TRUE(_queue.isEmpty());
+    ASSERT_FALSE(_queue.tryPop().has_value());
+
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(_queue.tryPush(i));
+    }
+
+    ASSERT_FALSE(_queue.tryPush(8));
+    ASSERT_EQ(_queue.size(), 8u);
+    ASSERT_EQ(_queue.tryPop(), 0);
+    ASSERT_EQ(_queue.tryPop(), 1);
+
+    const int values[] = {8, 9, 10};
+    ASSERT_EQ(_queue.pushBatch(values, 3), 2u);
+
+    int out[16] = {};
+    ASSERT_EQ(_queue.popBatch(out, 16), 8u);
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_EQ(out[i], i + 2);
+    }
+
+    ASSERT_TRUE(_queue.isEmpty());
+}
+}  // namespace
+
+TEST(FastRingBufferTest, spsc_single_thread_test) {
+    FastSpscRingBuffer<int, 8> queue;
+    checkSingleThreaded(queue);
+}
+
+TEST(FastRingBufferTest, mpmc_single_thread_test) {
+    FastMpmcRingBuffer<int, 8> queue;
+    checkSingleThreaded(queue);
+}
+
+TEST(FastRingBufferTest, items_are_destroyed_test) {
+    auto counter = std::make_shared<int>(0);
+    {
+        FastSpscRingBuffer<std::shared_ptr<int>, 4> spsc;
+        FastMpmcRingBuffer<std::shared_ptr<int>, 4> mpmc;
+        ASSERT_TRUE(spsc.tryPush(counter));
+        ASSERT_TRUE(spsc.tryEmplace(counter));
+        ASSERT_TRUE(mpmc.tryPush(counter));
+        ASSERT_EQ(counter.use_count(), 4);
+
+        ASSERT_EQ(*spsc.tryPop(), counter);
+        ASSERT_EQ(counter.use_count(), 3);
+    }
+
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(FastRingBufferTest, spsc_two_threads_keep_order_test) {
+    auto queue = std::make_unique<FastSpscRingBuffer<std::size_t, 256>>();
+
+    std::thread producer([&queue] {
+        std::size_t values[16];
+        for (std::size_t next = 0; next < ItemsPerProducer;) {
+            const auto count = std::min<std::size_t>(16, ItemsPerProducer - next);
+            std::iota(values, values + count, next);
+            if (const auto pushed = queue->pushBatch(values, count); pushed != 0) {
+                next += pushed;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::size_t expected = 0;
+    std::size_t values[32];
+    while (expected < ItemsPerProducer) {
+        const auto count = queue->popBatch(values, 32);
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(values[i], expected++);
+        }
+    }
+
+    producer.join();
+    ASSERT_TRUE(queue->isEmpty());
+}
+
+TEST(FastRingBufferTest, mpmc_many_threads_test) {
+    constexpr std::size_t Producers = 4;
+    constexpr std::size_t Consumers = 4;
+
+    auto queue = std::make_unique<FastMpmcRingBuffer<std::size_t, 1024>>();
+    std::atomic<std::size_t> consumed{0};
+    std::atomic<std::size_t> sum{0};
+
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < Producers; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (std::size_t i = 0; i < ItemsPerProducer;) {
+                // odd producers push in batches, even ones one by one.
+                if (p % 2 == 1) {
+                    std::size_t values[8];
+                    const auto count = std::min<std::size_t>(8, ItemsPerProducer - i);
+                    std::iota(values, values + count, p * ItemsPerProducer + i);
+                    if (const auto pushed = queue->pushBatch(values, count); pushed != 0) {
+                        i += pushed;
+                        continue;
+                    }
+                } else if (queue->tryPush(p * ItemsPerProducer + i)) {
+                    ++i;
+                    continue;
+                }
+
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    for (std::size_t c = 0; c < Consumers; ++c) {
+        threads.emplace_back([&queue, &consumed, &sum, c] {
+            std::size_t values[8];
+            while (consumed.load() < Producers * ItemsPerProducer) {
+                std::size_t count = 0;
+                if (c % 2 == 1) {
+                    count = queue->popBatch(values, 8);
+                } else if (auto value = queue->tryPop(); value.has_value()) {
+                    values[0] = *value;
+                    count = 1;
+                }
+
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    sum.fetch_add(values[i]);
+                }
+                consumed.fetch_add(count);
+            }
+        });
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto total = Producers * ItemsPerProducer;
+    ASSERT_EQ(consumed.load(), total);
+    ASSERT_EQ(sum.load(), total * (total - 1) / 2);
+    ASSERT_TRUE(queue->isEmpty());
+}
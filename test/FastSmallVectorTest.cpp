@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+
+#include "FastSmallVector.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+/*!
+ * @brief Counts the live instances, it is not trivially relocatable.
+ */
+struct Tracked {
+    explicit Tracked(int _value) : value(std::make_unique<int>(_value)) { ++s_alive; }
+    Tracked(const Tracked &_other) : value(std::make_unique<int>(*_other.value)) { ++s_alive; }
+    Tracked(Tracked &&_other) noexcept : value(std::move(_other.value)) { ++s_alive; }
+    Tracked &operator=(Tracked &&_other) noexcept = default;
+    ~Tracked() { --s_alive; }
+
+    std::unique_ptr<int> value;
+
+    inline static int s_alive = 0;
+};
+
+template<std::size_t N>
+std::vector<int> values(const FastSmallVector<Tracked, N> &_vector) {
+    std::vector<int> result;
+    for (const auto &item : _vector) {
+        result.push_back(*item.value);
+    }
+    return result;
+}
+}  // namespace
+
+TEST(FastSmallVectorTest, spill_to_heap_test) {
+    FastSmallVector<int, 4> vector{0, 1, 2};
+    ASSERT_TRUE(vector.isInline());
+    ASSERT_EQ(vector.capacity(), 4);
+
+    vector.push(3);
+    ASSERT_TRUE(vector.isInline());
+    ASSERT_TRUE(vector.isFull());
+
+    vector.push(4);
+    ASSERT_FALSE(vector.isInline());
+    ASSERT_EQ(vector.capacity(), 8);
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.end()), (std::vector<int>{0, 1, 2, 3, 4}));
+
+    // the argument refers to an item of the full vector which is moved to the new block.
+    vector.resizeUninitialized(8);
+    vector.push(vector[0]);
+    ASSERT_EQ(vector.size(), 9);
+    ASSERT_EQ(vector[8], 0);
+
+    vector.clear();
+    ASSERT_FALSE(vector.isInline());
+    vector.append(std::list<int>{7, 8});
+    vector.shrinkToFit();
+    ASSERT_TRUE(vector.isInline());
+    ASSERT_EQ(vector.pop(), 8);
+    ASSERT_EQ(vector.top(), 7);
+
+    ASSERT_EQ(vector.at(0), 7);
+    ASSERT_THROW([[maybe_unused]] auto value = vector.at(1), UserException);
+}
+
+TEST(FastSmallVectorTest, insert_and_erase_test) {
+    FastSmallVector<int, 4> vector{1, 4};
+    vector.insert(vector.begin(), 0);
+    const int middle[] = {2, 3};
+    ASSERT_EQ(*vector.insert(vector.begin() + 2, middle, 2), 2);
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.end()), (std::vector<int>{0, 1, 2, 3, 4}));
+
+    ASSERT_EQ(*vector.erase(vector.begin() + 1), 2);
+    const auto *last = vector.erase(vector.begin() + 2, vector.end());
+    ASSERT_EQ(last, vector.end());
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.end()), (std::vector<int>{0, 2}));
+
+    vector.resize(3);
+    ASSERT_EQ(vector[2], 0);
+    vector.resize(6, 9);
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.end()), (std::vector<int>{0, 2, 0, 9, 9, 9}));
+}
+
+TEST(FastSmallVectorTest, items_appended_and_inserted_test) {
+    // the full vector grows, the values are its own items.
+    FastSmallVector<int, 2> vector{1, 2, 3, 4};
+    vector.resize(vector.capacity(), 5);
+    vector.append(vector.data(), vector.size());
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.end()), (std::vector<int>{1, 2, 3, 4, 1, 2, 3, 4}));
+
+    vector.resize(vector.capacity(), 5);
+    vector.insert(vector.begin(), vector.data() + 1, 2);
+    ASSERT_EQ(vector.size(), 10);
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.begin() + 4), (std::vector<int>{2, 3, 1, 2}));
+
+    // the values are shifted by the insertion.
+    vector.reserve(32);
+    vector.insert(vector.begin(), vector.data(), 3);
+    ASSERT_EQ(std::vector<int>(vector.begin(), vector.begin() + 6), (std::vector<int>{2, 3, 1, 2, 3, 1}));
+
+    FastSmallVector<Tracked, 2> tracked;
+    tracked.emplace(1);
+    tracked.emplace(2);
+    tracked.append(tracked.data(), tracked.size());
+    tracked.insert(tracked.begin() + 1, tracked.data() + 2, 2);
+    ASSERT_EQ(values(tracked), (std::vector<int>{1, 1, 2, 2, 1, 2}));
+}
+
+TEST(FastSmallVectorTest, lifetime_test) {
+    {
+        FastSmallVector<Tracked, 2> vector;
+        vector.emplace(1);
+        vector.emplace(3);
+        ASSERT_EQ(*vector.emplaceAt(vector.begin() + 1, 2)->value, 2);
+        ASSERT_EQ(Tracked::s_alive, 3);
+        ASSERT_EQ(values(vector), (std::vector<int>{1, 2, 3}));
+
+        vector.insert(vector.begin(), vector[2]);
+        ASSERT_EQ(values(vector), (std::vector<int>{3, 1, 2, 3}));
+
+        vector.erase(vector.begin(), vector.begin() + 2);
+        ASSERT_EQ(Tracked::s_alive, 2);
+
+        auto copy = vector;
+        ASSERT_TRUE(copy.isInline());
+        ASSERT_EQ(Tracked::s_alive, 4);
+
+        const Tracked items[] = {Tracked(4), Tracked(5)};
+        copy.insert(copy.begin() + 1, items, 2);
+        ASSERT_EQ(values(copy), (std::vector<int>{2, 4, 5, 3}));
+        ASSERT_EQ(Tracked::s_alive, 8);
+    }
+
+    ASSERT_EQ(Tracked::s_alive, 0);
+}
+
+TEST(FastSmallVectorTest, move_steals_heap_block_test) {
+    FastSmallVector<std::string, 2> vector{"a", "b", "c"};
+    const auto *items = vector.data();
+
+    auto moved = std::move(vector);
+    ASSERT_EQ(moved.data(), items);
+    ASSERT_TRUE(vector.isEmpty());
+    ASSERT_TRUE(vector.isInline());
+
+    FastSmallVector<std::string, 2> assigned{"x"};
+    assigned = std::move(moved);
+    ASSERT_EQ(assigned.data(), items);
+    ASSERT_EQ(assigned.top(), "c");
+
+    // the inline items are moved into the heap block of the target.
+    FastSmallVector<std::string, 2> small{"y"};
+    assigned = std::move(small);
+    ASSERT_FALSE(assigned.isInline());
+    ASSERT_EQ(assigned.size(), 1);
+    ASSERT_EQ(assigned[0], "y");
+    ASSERT_TRUE(small.isEmpty());
+}
@@ -2,6 +2,26 @@
 
 #include "FastStackBuffer.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+/*!
+ * @brief Counts the live instances, it has no default constructor.
+ */
+struct Counted {
+    explicit Counted(int _value) : value(std::make_unique<int>(_value)) { ++s_alive; }
+    Counted(const Counted &_other) : value(std::make_unique<int>(*_other.value)) { ++s_alive; }
+    Counted(Counted &&_other) noexcept : value(std::move(_other.value)) { ++s_alive; }
+    ~Counted() { --s_alive; }
+
+    std::unique_ptr<int> value;
+
+    inline static int s_alive = 0;
+};
+}  // namespace
+
 class Fixture: public ::testing::Test {
 protected:
     FastStackBuffer<int, 100> stackBuffer {};
@@ -40,3 +60,104 @@ TEST_F(Fixture, stack_buffer_is_full_test) {
 
     ASSERT_TRUE(stackBuffer.isFull());
 }
+
+TEST_F(Fixture, stack_buffer_append_test) {
+    const int values[] = {0, 1, 2};
+    stackBuffer.append(values, 3);
+    stackBuffer.append(std::vector<int>{3, 4});
+
+    ASSERT_EQ(stackBuffer.size(), 5);
+    ASSERT_EQ(stackBuffer.pop(), 4);
+    ASSERT_EQ(stackBuffer.data()[2], 2);
+
+    ASSERT_THROW(stackBuffer.append(std::vector<int>(97)), UserException);
+    ASSERT_EQ(stackBuffer.size(), 4);
+
+    stackBuffer.resizeUninitialized(100);
+    ASSERT_TRUE(stackBuffer.isFull());
+    ASSERT_THROW(stackBuffer.resizeUninitialized(101), UserException);
+}
+
+TEST_F(Fixture, stack_buffer_try_methods_test) {
+    ASSERT_FALSE(stackBuffer.tryPop().has_value());
+    ASSERT_EQ(stackBuffer.tryTop(), nullptr);
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(stackBuffer.tryPush(i));
+    }
+
+    ASSERT_FALSE(stackBuffer.tryPush(100));
+    ASSERT_EQ(*stackBuffer.tryTop(), 99);
+    ASSERT_EQ(stackBuffer.tryPop(), 99);
+    ASSERT_EQ(stackBuffer.size(), 99);
+}
+
+TEST(FastStackBufferTest, truncate_on_overflow_test) {
+    FastStackBuffer<int, 4, TruncateOnOverflow> stackBuffer;
+
+    const int values[] = {0, 1, 2};
+    stackBuffer.append(values, 3);
+    stackBuffer.append(values, 3);
+    stackBuffer.push(3);
+
+    ASSERT_TRUE(stackBuffer.isFull());
+    ASSERT_EQ(stackBuffer.truncated(), 3);
+    ASSERT_EQ(stackBuffer.data()[3], 0);
+
+    stackBuffer.resizeUninitialized(10);
+    ASSERT_EQ(stackBuffer.size(), 4);
+    ASSERT_EQ(stackBuffer.truncated(), 9);
+}
+
+TEST(FastStackBufferTest, emplace_and_lifetime_test) {
+    {
+        FastStackBuffer<Counted, 1000> stackBuffer;
+        ASSERT_EQ(Counted::s_alive, 0);
+
+        ASSERT_EQ(*stackBuffer.emplace(1)->value, 1);
+        stackBuffer.push(Counted(2));
+        ASSERT_NE(stackBuffer.tryEmplace(3), nullptr);
+        ASSERT_EQ(Counted::s_alive, 3);
+
+        ASSERT_EQ(*stackBuffer.pop().value, 3);
+        ASSERT_EQ(Counted::s_alive, 2);
+
+        auto copy = stackBuffer;
+        ASSERT_EQ(Counted::s_alive, 4);
+        ASSERT_EQ(*copy.top().value, 2);
+
+        auto moved = std::move(copy);
+        ASSERT_TRUE(copy.isEmpty());
+        ASSERT_EQ(Counted::s_alive, 4);
+        ASSERT_EQ(*moved.data()[0].value, 1);
+
+        stackBuffer.clear();
+        ASSERT_EQ(Counted::s_alive, 2);
+
+        stackBuffer = moved;
+        ASSERT_EQ(Counted::s_alive, 4);
+    }
+
+    ASSERT_EQ(Counted::s_alive, 0);
+}
+
+TEST(FastStackBufferTest, trivial_copy_and_move_test) {
+    FastStackBuffer<int, 8> stackBuffer;
+    stackBuffer.append(std::vector<int>{1, 2, 3});
+
+    auto copy = stackBuffer;
+    copy.push(4);
+    ASSERT_EQ(stackBuffer.size(), 3);
+    ASSERT_EQ(copy.size(), 4);
+
+    FastStackBuffer<int, 8> moved;
+    moved = std::move(copy);
+    ASSERT_TRUE(copy.isEmpty());
+    ASSERT_EQ(moved.pop(), 4);
+    ASSERT_EQ(moved.pop(), 3);
+
+    FastStackBuffer<std::string, 4> strings;
+    strings.append(std::vector<std::string>{"a", "b"});
+    auto stringsCopy = strings;
+    ASSERT_EQ(stringsCopy.top(), "b");
+}
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+
+#include "FlightRecorder.h"
+#include "LogHelper.h"
+#include "RecordingSink.h"
+#include "UserException.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+#include <unistd.h>
+
+namespace {
+/*!
+ * @brief Writes the records to the recording sink and disables the recorder after the test.
+ */
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        LogHelper::setLogLevel(LogHelper::LogLevel::Information);
+        LogHelper::setSink(m_sink);
+    }
+
+    void TearDown() override {
+        LogHelper::disableFlightRecorder();
+        LogHelper::setSink(nullptr);
+    }
+
+    std::shared_ptr<RecordingSink> m_sink = std::make_shared<RecordingSink>();
+};
+
+bool endsWith(const std::string &_record, std::string_view _suffix) {
+    return _record.size() >= _suffix.size() && _record.compare(_record.size() - _suffix.size(), _suffix.size(), _suffix) == 0;
+}
+}  // namespace
+
+TEST_F(FlightRecorderTest, severe_record_dumps_thread_test) {
+    LogHelper::enableFlightRecorder();
+
+    STDCORE_LOG_INFORMATION << "first";
+    STDCORE_LOG_INFORMATION << "second";
+    ASSERT_TRUE(m_sink->records.empty());
+    ASSERT_EQ(FlightRecorder::threadRecordCount(), 2u);
+
+    STDCORE_LOG_WARNING << "warning";
+    ASSERT_EQ(m_sink->records.size(), 1u);
+    ASSERT_TRUE(endsWith(m_sink->records[0], "warning"));
+
+    STDCORE_LOG_ERROR << "error";
+    ASSERT_EQ(FlightRecorder::threadRecordCount(), 0u);
+    ASSERT_EQ(m_sink->records.size(), 4u);
+    ASSERT_TRUE(endsWith(m_sink->records[1], "first"));
+    ASSERT_EQ(m_sink->levels[1], LogLevel::Information);
+    ASSERT_TRUE(endsWith(m_sink->records[2], "second"));
+    ASSERT_TRUE(endsWith(m_sink->records[3], "error"));
+    ASSERT_EQ(m_sink->levels[3], LogLevel::Error);
+}
+
+TEST_F(FlightRecorderTest, oldest_records_overwritten_test) {
+    FlightRecorder::Options options;
+    options.threadCapacity = 1024;
+    LogHelper::enableFlightRecorder(options);
+
+    for (int i = 0; i < 100; ++i) {
+        STDCORE_LOG_INFORMATION << "record " << i;
+    }
+    const auto count = FlightRecorder::threadRecordCount();
+    ASSERT_GT(count, 0u);
+    ASSERT_LT(count, 100u);
+
+    FlightRecorder::dump();
+    ASSERT_EQ(m_sink->records.size(), count);
+    ASSERT_TRUE(endsWith(m_sink->records.back(), "record 99"));
+    ASSERT_TRUE(endsWith(m_sink->records.front(), "record " + std::to_string(100 - count)));
+}
+
+TEST_F(FlightRecorderTest, exception_dumps_thread_test) {
+    FlightRecorder::Options options;
+    options.dumpOnException = true;
+    LogHelper::enableFlightRecorder(options);
+
+    STDCORE_LOG_INFORMATION << "before exception";
+    ASSERT_TRUE(m_sink->records.empty());
+
+    UserException exception(UserException::Static, "user", "debug", "f");
+    ASSERT_EQ(m_sink->records.size(), 1u);
+    ASSERT_TRUE(endsWith(m_sink->records[0], "before exception"));
+}
+
+TEST_F(FlightRecorderTest, signal_safe_dump_test) {
+    LogHelper::enableFlightRecorder();
+
+    STDCORE_LOG_INFORMATION << "kept for the crash";
+
+    std::FILE *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    FlightRecorder::dumpSignalSafe(fileno(file));
+
+    std::rewind(file);
+    std::string dump;
+    char chunk[256];
+    while (const auto size = std::fread(chunk, 1, sizeof(chunk), file)) {
+        dump.append(chunk, size);
+    }
+    std::fclose(file);
+
+    ASSERT_EQ(dump.rfind("--- flight recorder ---\n", 0), 0u);
+    ASSERT_NE(dump.find("kept for the crash\n"), std::string::npos);
+    // the signal-safe dump does not empty the buffer.
+    ASSERT_EQ(FlightRecorder::threadRecordCount(), 1u);
+}
+
+TEST_F(FlightRecorderTest, replaced_signal_handler_chained_test) {
+    const auto crash = [] {
+        struct sigaction previous{};
+        previous.sa_handler = [](int) { ::_exit(42); };
+        sigemptyset(&previous.sa_mask);
+        ::sigaction(SIGABRT, &previous, nullptr);
+
+        LogHelper::enableFlightRecorder();
+        STDCORE_LOG_INFORMATION << "before the crash";
+        // installed twice, the handler replaced the first time still runs.
+        FlightRecorder::installSignalHandlers(STDERR_FILENO);
+        FlightRecorder::installSignalHandlers(STDERR_FILENO);
+        ::raise(SIGABRT);
+    };
+
+    ASSERT_EXIT(crash(), ::testing::ExitedWithCode(42), "before the crash");
+}
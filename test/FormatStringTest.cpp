@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+
+#include "FormatString.h"
+#include "LogHelper.h"
+#include "RecordingSink.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+using Buffer = CharFastStackBuffer<char, 256>;
+
+}  // namespace
+
+TEST(FormatStringTest, parse_test) {
+    auto format = STDCORE_FMT("id={} {{x}} ms={:.2f}");
+    using Format = decltype(format);
+
+    static_assert(Format::ArgumentCount == 2);
+    static_assert(Format::LiteralSize == std::string_view("id= {x} ms=").size());
+    static_assert(Format::Parsed.segments[3].spec.precision == 2);
+    static_assert(Format::Parsed.segments[3].spec.type == 'f');
+    static_assert(parseFormat<8>("{").error == FormatError::UnmatchedBrace);
+    static_assert(parseFormat<8>("}").error == FormatError::UnmatchedBrace);
+    static_assert(parseFormat<8>("{:q}").error == FormatError::InvalidSpec);
+    static_assert(parseFormat<8>("{:.}").error == FormatError::InvalidSpec);
+}
+
+TEST(FormatStringTest, format_to_test) {
+    Buffer buffer;
+    formatTo(buffer, STDCORE_FMT("{} took {:.2f} ms, {}{{}}"), std::string("request"), 2.345, true);
+
+    ASSERT_EQ(buffer.view(), "request took 2.35 ms, true{}");
+}
+
+TEST(FormatStringTest, spec_test) {
+    Buffer buffer;
+    formatTo(buffer, STDCORE_FMT("[{:>6}|{:<6}|{:*^7}|{:06}|{:x}|{:X}|{:.3}|{:e}]"),
+             42, std::string_view("ab"), "mid", -17, 255, 255u, "abcdef", 1500.0);
+
+    ASSERT_EQ(buffer.view(), "[    42|ab    |**mid**|-00017|ff|FF|abc|1.500000e+03]");
+}
+
+TEST(FormatStringTest, wide_value_is_not_padded_test) {
+    Buffer buffer;
+    formatTo(buffer, STDCORE_FMT("{:3}|{:2}"), 123456, "long");
+
+    ASSERT_EQ(buffer.view(), "123456|long");
+}
+
+TEST(FormatStringTest, truncated_test) {
+    CharFastStackBuffer<char, 8, TruncateOnOverflow> buffer;
+    formatTo(buffer, STDCORE_FMT("{:>10}"), 1);
+
+    ASSERT_EQ(buffer.size(), 8);
+}
+
+TEST(FormatStringTest, log_helper_test) {
+    auto sink = std::make_shared<RecordingSink>();
+    LogHelper::setSink(sink);
+    STDCORE_LOG_ERROR << "result " << formatArgs(STDCORE_FMT("{:>5}|{:.1f}"), 7, 0.25);
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(sink->records.size(), 1u);
+    ASSERT_NE(sink->records[0].find("result     7|0.2"), std::string::npos);
+}
@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+
+#include "FdLogSink.h"
+#include "LogCompression.h"
+#include "LogCompressor.h"
+#include "MmapLogSink.h"
+#include "UserException.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+std::string readFile(const std::string &_path) {
+    std::ifstream file(_path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+
+    return content.str();
+}
+
+std::string tempPath(const std::string &_name) {
+    return testing::TempDir() + _name + '.' + std::to_string(::getpid());
+}
+
+/*!
+ * @brief Returns log-like text: repeated record layouts with varying numbers.
+ */
+std::string logText(std::size_t _records) {
+    std::string text;
+    for (std::size_t i = 0; i < _records; ++i) {
+        text += "2024-01-01 12:00:" + std::to_string(10 + i % 50) + " Information request " + std::to_string(i * 7919 % 100000) +
+                " took " + std::to_string(i % 13) + " ms, status " + (i % 17 == 0 ? "500" : "200") + '\n';
+    }
+
+    return text;
+}
+
+std::string compressBlock(const std::string &_input) {
+    std::string output(LogCompression::compressBound(_input.size()), '\0');
+    output.resize(LogCompression::compressBlock(_input.data(), _input.size(), output.data(), output.size()));
+
+    return output;
+}
+
+std::string decompressBlock(const std::string &_input) {
+    std::string output(LogCompression::BlockSize, '\0');
+    std::size_t size = 0;
+    if (!LogCompression::decompressBlock(_input.data(), _input.size(), output.data(), output.size(), size)) {
+        throw UserException(UserException::Static, "corrupted", "block", __PRETTY_FUNCTION__);
+    }
+    output.resize(size);
+
+    return output;
+}
+
+std::string decompressFile(const std::string &_path) {
+    std::ifstream file(_path, std::ios::binary);
+    std::ostringstream os;
+    LogCompression::decompressStream(file, os);
+
+    return os.str();
+}
+}  // namespace
+
+TEST(LogCompressionTest, block_round_trip_test) {
+    std::mt19937 random(42);
+    std::string noise(10000, '\0');
+    for (auto &c : noise) {
+        c = static_cast<char>(random());
+    }
+
+    const auto text = logText(500);
+    for (const auto &input : {std::string(), std::string("a"), std::string("0123456789abc"), std::string(5000, 'x'),
+                               text.substr(0, LogCompression::BlockSize), noise}) {
+        const auto compressed = compressBlock(input);
+        ASSERT_GT(compressed.size(), 0u);
+        ASSERT_EQ(decompressBlock(compressed), input);
+    }
+
+    ASSERT_LT(compressBlock(std::string(5000, 'x')).size(), 50u);
+    ASSERT_LT(compressBlock(text.substr(0, LogCompression::BlockSize)).size() * 2, text.substr(0, LogCompression::BlockSize).size());
+}
+
+TEST(LogCompressionTest, corrupted_block_test) {
+    const auto text = logText(100);
+    auto compressed = compressBlock(text);
+
+    std::string output(text.size() - 1, '\0');
+    std::size_t size = 0;
+    ASSERT_FALSE(LogCompression::decompressBlock(compressed.data(), compressed.size(), output.data(), output.size(), size));
+    ASSERT_FALSE(LogCompression::decompressBlock(compressed.data(), compressed.size() / 2, output.data(), output.size(), size));
+
+    // a match before the beginning of the output.
+    const std::string farMatch = {static_cast<char>(0x10), 'a', static_cast<char>(0xff), static_cast<char>(0x00), static_cast<char>(0x00)};
+    ASSERT_THROW(decompressBlock(farMatch), UserException);
+}
+
+TEST(LogCompressionTest, stream_round_trip_test) {
+    const auto text = logText(20000);
+    ASSERT_GT(text.size(), 4 * LogCompression::BlockSize);
+
+    std::istringstream input(text);
+    std::ostringstream compressed;
+    const auto sizes = LogCompression::compressStream(input, compressed);
+    ASSERT_EQ(sizes.input, text.size());
+    ASSERT_EQ(sizes.output, compressed.str().size());
+    ASSERT_LT(sizes.output * 3, sizes.input);
+
+    std::istringstream compressedInput(compressed.str());
+    std::ostringstream output;
+    ASSERT_EQ(LogCompression::decompressStream(compressedInput, output).output, text.size());
+    ASSERT_EQ(output.str(), text);
+
+    std::istringstream truncated(compressed.str().substr(0, compressed.str().size() - 10));
+    ASSERT_THROW(LogCompression::decompressStream(truncated, output), UserException);
+    std::istringstream plain(text);
+    ASSERT_THROW(LogCompression::decompressStream(plain, output), UserException);
+}
+
+TEST(LogCompressionTest, rotated_files_are_compressed_test) {
+    const auto path = tempPath("compressed_sink");
+    {
+        LogCompressor compressor;
+        {
+            CompressingLogSink<RotatingFileLogSink> sink(compressor, path, 10000, 3, FlushPolicy{0});
+            for (int i = 0; i < 35; ++i) {
+                // 10 records fill a file.
+                sink.write(std::to_string(10 + i) + ' ' + std::string(996, 'x'), LogLevel::Information);
+            }
+        }
+        compressor.flush();
+        ASSERT_EQ(compressor.compressedFiles(), 3u);
+        ASSERT_LT(compressor.outputBytes() * 10, compressor.inputBytes());
+    }
+
+    ASSERT_EQ(readFile(path).size(), 5000u);
+    for (int index = 1; index <= 3; ++index) {
+        const auto rotated = path + '.' + std::to_string(index);
+        ASSERT_FALSE(std::ifstream(rotated).is_open());
+
+        const auto text = decompressFile(rotated + LogCompression::FileSuffix);
+        ASSERT_EQ(text.size(), 10000u);
+        // the newest rotated file starts with the record 20.
+        ASSERT_EQ(text.substr(0, 3), std::to_string(40 - index * 10) + ' ');
+        std::remove((rotated + LogCompression::FileSuffix).c_str());
+    }
+    ASSERT_FALSE(std::ifstream(path + ".4.lz").is_open());
+    std::remove(path.c_str());
+}
+
+TEST(LogCompressionTest, mmap_rotated_files_are_compressed_test) {
+    const auto path = tempPath("compressed_mmap_sink");
+    MmapLogSink::Options options;
+    options.segmentSize = 4096;
+    options.maxFiles = 2;
+    {
+        LogCompressor compressor;
+        {
+            CompressingLogSink<MmapLogSink> sink(compressor, path, options);
+            for (int i = 0; i < 100; ++i) {
+                // 40 records fill a segment.
+                sink.write(std::to_string(i % 10) + std::string(98, 'x'), LogLevel::Information);
+            }
+        }
+    }
+
+    ASSERT_EQ(readFile(path).size(), 2000u);
+    ASSERT_EQ(decompressFile(path + ".1.lz").size(), 4000u);
+    ASSERT_EQ(decompressFile(path + ".2.lz").size(), 4000u);
+
+    for (const auto &file : {path, path + ".1.lz", path + ".2.lz"}) {
+        std::remove(file.c_str());
+    }
+}
@@ -0,0 +1,266 @@
+#include "gtest/gtest.h"
+
+#include "LogHelper.h"
+#include "RecordingSink.h"
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+/*!
+ * @brief Restores the logging level after the test.
+ */
+class LogHelperTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        LogHelper::setLogLevel(LogHelper::LogLevel::Information);
+    }
+};
+
+int countedValue(int &_counter) {
+    return ++_counter;
+}
+
+/*!
+ * @brief Returns a new site of the limiter, so a repeated test does not see the state of the previous run.
+ * A site stays registered for the suppression summary, so the sites are never freed.
+ */
+template<class Limiter_t, class... Args_t>
+LimitedLogSite<Limiter_t> &freshSite(Args_t... _args) {
+    static auto *sites = new std::deque<LimitedLogSite<Limiter_t>>();
+    return sites->emplace_back(__FILE__, __LINE__, _args...);
+}
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream &operator<<(std::ostream &_os, const Point &_point) {
+    return _os << '(' << _point.x << ", " << _point.y << ')';
+}
+
+/*!
+ * @brief Leaves the stream in the hexadecimal mode.
+ */
+struct HexPoint {
+    Point point;
+};
+
+std::ostream &operator<<(std::ostream &_os, const HexPoint &_point) {
+    return _os << std::hex << _point.point;
+}
+
+/*!
+ * @brief Logs a record of its own while it is logged.
+ */
+struct Nested {
+    int value;
+};
+
+std::ostream &operator<<(std::ostream &_os, const Nested &_nested) {
+    STDCORE_LOG_ERROR << "nested " << _nested.value;
+    return _os << '{' << _nested.value << '}';
+}
+}  // namespace
+
+TEST_F(LogHelperTest, disabled_level_skips_arguments_test) {
+    LogHelper::setLogLevel(LogHelper::LogLevel::Error);
+
+    int counter = 0;
+    testing::internal::CaptureStderr();
+    STDCORE_LOG_INFORMATION << "value " << countedValue(counter);
+    STDCORE_LOG_WARNING << "value " << countedValue(counter);
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_EQ(counter, 0);
+    ASSERT_TRUE(output.empty());
+}
+
+TEST_F(LogHelperTest, enabled_level_writes_record_test) {
+    LogHelper::setLogLevel(LogHelper::LogLevel::Warning);
+
+    int counter = 0;
+    testing::internal::CaptureStderr();
+    STDCORE_LOG_ERROR << std::string("value ") << countedValue(counter);
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_EQ(counter, 1);
+    ASSERT_NE(output.find("value 1\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, is_enabled_test) {
+    LogHelper::setLogLevel(LogHelper::LogLevel::Critical);
+
+    ASSERT_TRUE(LogHelper::isEnabled(LogHelper::LogLevel::Critical));
+    ASSERT_FALSE(LogHelper::isEnabled(LogHelper::LogLevel::Error));
+    ASSERT_EQ(LogHelper::logLevel(), LogHelper::LogLevel::Critical);
+}
+
+TEST_F(LogHelperTest, stream_and_buffer_output_order_test) {
+    testing::internal::CaptureStderr();
+    STDCORE_LOG_ERROR << std::string("a ") << Point{1, 2} << std::string(" b ") << Point{3, 4};
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find("a (1, 2) b (3, 4)\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, long_record_is_truncated_test) {
+    testing::internal::CaptureStderr();
+    STDCORE_LOG_ERROR << std::string(LogHelper::RecordCapacity + 1000, 'a') << Point{1, 2} << 42;
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find("a\xE2\x80\xA6[truncated "), std::string::npos);
+    ASSERT_LE(output.size(), LogHelper::RecordCapacity + 1);
+}
+
+TEST_F(LogHelperTest, pooled_stream_is_reset_test) {
+    testing::internal::CaptureStderr();
+    STDCORE_LOG_ERROR << HexPoint{{255, 16}};
+    STDCORE_LOG_ERROR << Point{255, 16} << " " << Nested{7};
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find("(ff, 10)\n"), std::string::npos);
+    ASSERT_NE(output.find("nested 7\n"), std::string::npos);
+    ASSERT_NE(output.find("(255, 16) {7}\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, every_n_test) {
+    auto &site = freshSite<LogEveryN>(3);
+    int counter = 0;
+    testing::internal::CaptureStderr();
+    for (int i = 0; i < 7; ++i) {
+        STDCORE_LOG_LIMITED_AT(LogHelper::LogLevel::Error, site) << "every " << i << ' ' << countedValue(counter);
+    }
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_EQ(counter, 3);
+    ASSERT_NE(output.find("every 0 1\n"), std::string::npos);
+    ASSERT_NE(output.find("every 3 2\n"), std::string::npos);
+    ASSERT_NE(output.find("every 6 3\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, first_n_test) {
+    auto &site = freshSite<LogFirstN>(2);
+    testing::internal::CaptureStderr();
+    for (int i = 0; i < 5; ++i) {
+        STDCORE_LOG_LIMITED_AT(LogHelper::LogLevel::Error, site) << "first " << i;
+    }
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find("first 0\n"), std::string::npos);
+    ASSERT_NE(output.find("first 1\n"), std::string::npos);
+    ASSERT_EQ(output.find("first 2\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, disabled_level_does_not_count_test) {
+    auto &site = freshSite<LogFirstN>(1);
+    LogHelper::setLogLevel(LogHelper::LogLevel::Error);
+
+    testing::internal::CaptureStderr();
+    for (int i = 0; i < 3; ++i) {
+        if (i == 2) {
+            LogHelper::setLogLevel(LogHelper::LogLevel::Information);
+        }
+        STDCORE_LOG_LIMITED_AT(LogHelper::LogLevel::Information, site) << "first " << i;
+    }
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find("first 2\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, every_interval_test) {
+    auto &site = freshSite<LogEveryInterval>(std::chrono::hours(1));
+    testing::internal::CaptureStderr();
+    for (int i = 0; i < 3; ++i) {
+        STDCORE_LOG_LIMITED_AT(LogHelper::LogLevel::Error, site) << "interval " << i;
+    }
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find("interval 0\n"), std::string::npos);
+    ASSERT_EQ(output.find("interval 1\n"), std::string::npos);
+}
+
+TEST_F(LogHelperTest, token_bucket_test) {
+    LogTokenBucket bucket(1, 3);
+
+    ASSERT_TRUE(bucket.allow());
+    ASSERT_TRUE(bucket.allow());
+    ASSERT_TRUE(bucket.allow());
+    ASSERT_FALSE(bucket.allow());
+    ASSERT_FALSE(bucket.allow());
+    ASSERT_EQ(bucket.takeSuppressed(), 2u);
+    ASSERT_EQ(bucket.takeSuppressed(), 0u);
+}
+
+TEST_F(LogHelperTest, suppression_summary_test) {
+    auto &site = freshSite<LogEveryN>(4);
+    LogHelper::setSuppressionSummary(true);
+
+    testing::internal::CaptureStderr();
+    for (int i = 0; i < 5; ++i) {
+        STDCORE_LOG_LIMITED_AT(LogHelper::LogLevel::Error, site) << "summary " << i;
+    }
+    const auto output = testing::internal::GetCapturedStderr();
+    LogHelper::setSuppressionSummary(false);
+
+    const auto summary = output.find("suppressed 3 messages\n");
+    ASSERT_NE(summary, std::string::npos);
+    ASSERT_LT(summary, output.find("summary 4\n"));
+    ASSERT_EQ(output.find("suppressed", summary + 1), std::string::npos);
+}
+
+TEST_F(LogHelperTest, periodic_suppression_summary_test) {
+    auto &site = freshSite<LogFirstN>(2);
+    auto sink = std::make_shared<RecordingSink>();
+    LogHelper::setSink(sink);
+    LogHelper::setSuppressionSummary(true, std::chrono::milliseconds(20));
+
+    for (int i = 0; i < 5; ++i) {
+        STDCORE_LOG_LIMITED_AT(LogHelper::LogLevel::Warning, site) << "periodic " << i;
+    }
+
+    // the records of this statement are the only warnings, the summary comes without another allowed record.
+    std::uint64_t suppressed = 0;
+    std::size_t written = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (suppressed < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        suppressed = 0;
+        written = 0;
+        for (const auto &record : sink->recordsOf(LogLevel::Warning)) {
+            if (const auto summary = record.find("suppressed "); summary != std::string::npos) {
+                suppressed += std::stoull(record.substr(summary + 11));
+            } else {
+                ++written;
+            }
+        }
+    }
+    LogHelper::setSuppressionSummary(false);
+    // waits for the background thread to leave the sink.
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(written, 2u);
+    ASSERT_EQ(suppressed, 3u);
+}
+
+TEST_F(LogHelperTest, memory_resource_test) {
+    auto *threadResource = MonotonicMemoryResource::threadResource();
+    ASSERT_NE(threadResource, nullptr);
+    const auto marker = threadResource->mark();
+
+    testing::internal::CaptureStderr();
+    {
+        LogHelper logHelper(LogHelper::LogLevel::Error);
+        std::pmr::string name(40, 'n', logHelper.memoryResource());
+        ASSERT_GT(threadResource->mark().used, marker.used);
+        logHelper << std::string_view(name);
+    }
+    const auto output = testing::internal::GetCapturedStderr();
+
+    ASSERT_NE(output.find(std::string(40, 'n')), std::string::npos);
+    ASSERT_EQ(threadResource->mark().used, marker.used);
+}
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include "LogHelper.h"
+#include "LogMetrics.h"
+#include "RecordingSink.h"
+#include "UserException.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/*!
+ * @brief Resets the metrics and installs the recording sink.
+ */
+class LogMetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!LogMetrics::Enabled) {
+            GTEST_SKIP() << "the metrics are compiled out";
+        }
+
+        LogMetrics::reset();
+        LogHelper::setSink(m_sink);
+    }
+
+    void TearDown() override {
+        LogHelper::setSink(nullptr);
+    }
+
+    std::shared_ptr<RecordingSink> m_sink = std::make_shared<RecordingSink>();
+};
+}  // namespace
+
+TEST_F(LogMetricsTest, records_test) {
+    STDCORE_LOG_ERROR << "first";
+    STDCORE_LOG_ERROR << "second";
+    STDCORE_LOG_WARNING << "third";
+    const auto snapshot = LogMetrics::snapshot();
+
+    ASSERT_EQ(m_sink->records.size(), 3u);
+    ASSERT_EQ(snapshot.recordCount(LogLevel::Error), 2u);
+    ASSERT_EQ(snapshot.recordCount(LogLevel::Warning), 1u);
+    ASSERT_EQ(snapshot.recordCount(LogLevel::Critical), 0u);
+    ASSERT_EQ(snapshot.counter(LogMetrics::Counter::Bytes),
+              m_sink->records[0].size() + m_sink->records[1].size() + m_sink->records[2].size());
+    ASSERT_EQ(snapshot.counter(LogMetrics::Counter::Truncated), 0u);
+    ASSERT_EQ(snapshot.latency(LogMetrics::Latency::Format).count, 3u);
+    ASSERT_EQ(snapshot.latency(LogMetrics::Latency::SinkWrite).count, 3u);
+}
+
+TEST_F(LogMetricsTest, truncated_test) {
+    STDCORE_LOG_ERROR << std::string(LogHelper::RecordCapacity + 1, 'a');
+
+    ASSERT_EQ(LogMetrics::snapshot().counter(LogMetrics::Counter::Truncated), 1u);
+}
+
+TEST_F(LogMetricsTest, suppressed_test) {
+    for (int i = 0; i < 10; ++i) {
+        STDCORE_LOG_EVERY_N(LogHelper::LogLevel::Error, 5) << i;
+    }
+    const auto snapshot = LogMetrics::snapshot();
+
+    ASSERT_EQ(snapshot.recordCount(LogLevel::Error), 2u);
+    ASSERT_EQ(snapshot.counter(LogMetrics::Counter::Suppressed), 8u);
+}
+
+TEST_F(LogMetricsTest, exceptions_test) {
+    try {
+        try {
+            throw UserException("inner", "", "");
+        } catch (const UserException &_exception) {
+            throw UserException("outer", "", "", _exception);
+        }
+    } catch (const UserException &) {
+    }
+    const auto snapshot = LogMetrics::snapshot();
+
+    ASSERT_EQ(snapshot.counter(LogMetrics::Counter::Exceptions), 2u);
+    ASSERT_EQ(snapshot.counter(LogMetrics::Counter::NestedExceptions), 1u);
+}
+
+TEST_F(LogMetricsTest, threads_are_merged_test) {
+    std::thread thread([] {
+        STDCORE_LOG_ERROR << "thread";
+        ASSERT_EQ(LogMetrics::snapshot().recordCount(LogLevel::Error), 1u);
+    });
+    thread.join();
+    STDCORE_LOG_ERROR << "main";
+
+    ASSERT_EQ(LogMetrics::snapshot().recordCount(LogLevel::Error), 2u);
+}
+
+TEST_F(LogMetricsTest, histogram_test) {
+    LogMetrics::Histogram histogram;
+    histogram.count = 4;
+    histogram.sumNs = 2 + 3 + 100 + 1000;
+    histogram.buckets[2] = 2;
+    histogram.buckets[7] = 1;
+    histogram.buckets[10] = 1;
+
+    ASSERT_EQ(histogram.quantileNs(0.0), 4u);
+    ASSERT_EQ(histogram.quantileNs(0.5), 4u);
+    ASSERT_EQ(histogram.quantileNs(0.75), 128u);
+    ASSERT_EQ(histogram.quantileNs(1.0), 1024u);
+    ASSERT_DOUBLE_EQ(histogram.averageNs(), 1105.0 / 4);
+    ASSERT_EQ(LogMetrics::Histogram().quantileNs(0.5), 0u);
+}
@@ -0,0 +1,414 @@
+#include "gtest/gtest.h"
+
+#include "FdLogSink.h"
+#include "LogHelper.h"
+#include "MmapLogSink.h"
+#include "RecordingSink.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+std::string readFile(const std::string &_path) {
+    std::ifstream file(_path);
+    std::ostringstream content;
+    content << file.rdbuf();
+
+    return content.str();
+}
+
+std::string tempPath(const std::string &_name) {
+    return testing::TempDir() + _name + '.' + std::to_string(::getpid());
+}
+
+/*!
+ * @brief Writes the parts directly, more of them than one writev call takes.
+ */
+class PartsSink : public FdLogSink {
+public:
+    explicit PartsSink(int _fd) : FdLogSink(_fd, FlushPolicy{0}, true) {}
+
+    void writeParts(const std::vector<std::string_view> &_parts) {
+        writeOutput(_parts.data(), _parts.size());
+    }
+};
+
+/*!
+ * @brief Replaces itself by the fallback sink in its first write(), as a sink does on an I/O error.
+ */
+class ReplacingSink : public RecordingSink {
+public:
+    explicit ReplacingSink(std::shared_ptr<LogSink> _fallback) : m_fallback(std::move(_fallback)) {}
+
+    void write(std::string_view _record, LogLevel _level) override {
+        RecordingSink::write(_record, _level);
+        LogHelper::setSink(m_fallback);
+    }
+
+private:
+    std::shared_ptr<LogSink> m_fallback;
+};
+}  // namespace
+
+TEST(LogSinkTest, records_are_coalesced_test) {
+    std::ostringstream os;
+    StreamLogSink sink(os, FlushPolicy{1024, std::chrono::milliseconds(0), LogLevel::Critical});
+
+    for (int i = 0; i < 10; ++i) {
+        sink.write("record", LogLevel::Information);
+    }
+    ASSERT_TRUE(os.str().empty());
+    ASSERT_EQ(sink.outputCalls(), 0u);
+
+    sink.write("error", LogLevel::Error);
+    ASSERT_EQ(sink.outputCalls(), 0u);
+
+    sink.write("critical", LogLevel::Critical);
+    ASSERT_EQ(sink.outputCalls(), 1u);
+
+    std::string expected;
+    for (int i = 0; i < 10; ++i) {
+        expected += "record\n";
+    }
+    expected += "error\ncritical\n";
+    ASSERT_EQ(os.str(), expected);
+
+    sink.write(std::string(2000, 'x'), LogLevel::Information);
+    ASSERT_EQ(sink.outputCalls(), 2u);
+
+    sink.write("", LogLevel::Information);
+    sink.flush();
+    ASSERT_EQ(sink.outputCalls(), 3u);
+    ASSERT_EQ(os.str(), expected + std::string(2000, 'x') + "\n\n");
+}
+
+TEST(LogSinkTest, file_sink_writes_on_flush_test) {
+    const auto path = tempPath("file_sink");
+    std::remove(path.c_str());
+    {
+        FileLogSink sink(path);
+        for (int i = 0; i < 1000; ++i) {
+            sink.write("0123456789", LogLevel::Information);
+        }
+        ASSERT_LE(sink.outputCalls(), 1u);
+
+        sink.flush();
+        ASSERT_EQ(readFile(path).size(), 11000u);
+        sink.write("last", LogLevel::Information);
+    }
+
+    ASSERT_EQ(readFile(path).size(), 11005u);
+    std::remove(path.c_str());
+
+    ASSERT_THROW(FileLogSink("/nonexistent/directory/file.log"), UserException);
+}
+
+TEST(LogSinkTest, rotating_file_sink_test) {
+    const auto path = tempPath("rotating_sink");
+    for (const auto &file : {path, path + ".1", path + ".2", path + ".3"}) {
+        std::remove(file.c_str());
+    }
+
+    {
+        RotatingFileLogSink sink(path, 100, 2, FlushPolicy{0});
+        for (int i = 0; i < 35; ++i) {
+            // 10 records fill a file.
+            sink.write(std::to_string(i % 10) + "12345678", LogLevel::Information);
+        }
+    }
+
+    ASSERT_EQ(readFile(path).size(), 50u);
+    ASSERT_EQ(readFile(path + ".1").size(), 100u);
+    ASSERT_EQ(readFile(path + ".2").size(), 100u);
+    ASSERT_FALSE(std::ifstream(path + ".3").is_open());
+
+    for (const auto &file : {path, path + ".1", path + ".2"}) {
+        std::remove(file.c_str());
+    }
+}
+
+TEST(LogSinkTest, log_helper_writes_to_sink_test) {
+    auto sink = std::make_shared<RecordingSink>();
+    LogHelper::setSink(sink);
+
+    STDCORE_LOG_ERROR << "error " << 1;
+    STDCORE_LOG_INFORMATION << "information";
+
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(sink->records.size(), 2u);
+    ASSERT_NE(sink->records[0].find("error 1"), std::string::npos);
+    ASSERT_EQ(sink->levels[0], LogLevel::Error);
+    ASSERT_EQ(sink->levels[1], LogLevel::Information);
+}
+
+TEST(LogSinkTest, rotation_retried_after_failed_open_test) {
+    const auto path = tempPath("retried_rotation");
+    for (const auto &file : {path, path + ".1", path + ".2"}) {
+        std::remove(file.c_str());
+    }
+
+    {
+        RotatingFileLogSink sink(path, 100, 2, FlushPolicy{0});
+        sink.write(std::string(59, 'a'), LogLevel::Information);
+
+        // the lowest free descriptor is over the limit, so the new file cannot be opened.
+        rlimit limit{};
+        ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &limit), 0);
+        const auto probe = ::dup(STDERR_FILENO);
+        ASSERT_GE(probe, 0);
+        ::close(probe);
+        rlimit lowered = limit;
+        lowered.rlim_cur = static_cast<rlim_t>(probe);
+        ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &lowered), 0);
+
+        sink.write(std::string(59, 'b'), LogLevel::Information);
+        sink.write(std::string(59, 'c'), LogLevel::Information);
+        ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &limit), 0);
+
+        // the records stay in the renamed file until the new one is opened.
+        sink.write(std::string(59, 'd'), LogLevel::Information);
+        sink.write(std::string(59, 'e'), LogLevel::Information);
+    }
+
+    const auto rotated = readFile(path + ".1");
+    ASSERT_EQ(rotated.size(), 240u);
+    ASSERT_NE(rotated.find('c'), std::string::npos);
+    ASSERT_EQ(readFile(path), std::string(59, 'e') + '\n');
+
+    for (const auto &file : {path, path + ".1", path + ".2"}) {
+        std::remove(file.c_str());
+    }
+}
+
+TEST(LogSinkTest, parts_written_in_batches_test) {
+    const auto path = tempPath("batched_parts");
+    {
+        PartsSink sink(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+        std::vector<std::string> records;
+        std::vector<std::string_view> parts;
+        for (int i = 0; i < 20; ++i) {
+            records.push_back(std::to_string(i % 10));
+        }
+        parts.assign(records.begin(), records.end());
+        sink.writeParts(parts);
+    }
+
+    ASSERT_EQ(readFile(path), "01234567890123456789");
+    std::remove(path.c_str());
+}
+
+TEST(LogSinkTest, replaced_sink_is_released_test) {
+    auto first = std::make_shared<RecordingSink>();
+    std::weak_ptr<RecordingSink> released = first;
+    LogHelper::setSink(std::move(first));
+    STDCORE_LOG_ERROR << "first";
+
+    LogHelper::enableAsync();
+    auto second = std::make_shared<RecordingSink>();
+    LogHelper::setSink(second);
+    ASSERT_TRUE(released.expired());
+
+    // the asynchronous writer follows the sink.
+    STDCORE_LOG_ERROR << "second";
+    LogHelper::disableAsync();
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(second->records.size(), 1u);
+    ASSERT_NE(second->records[0].find("second"), std::string::npos);
+}
+
+TEST(LogSinkTest, sink_replaced_inside_write_test) {
+    auto fallback = std::make_shared<RecordingSink>();
+    auto first = std::make_shared<ReplacingSink>(fallback);
+    std::weak_ptr<ReplacingSink> released = first;
+    LogHelper::setSink(std::move(first));
+
+    STDCORE_LOG_ERROR << "first";
+    // the replaced sink has been released when the record left it.
+    ASSERT_TRUE(released.expired());
+
+    STDCORE_LOG_ERROR << "second";
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(fallback->records.size(), 1u);
+    ASSERT_NE(fallback->records[0].find("second"), std::string::npos);
+}
+
+TEST(LogSinkTest, async_writer_toggled_while_logging_test) {
+    auto sink = std::make_shared<RecordingSink>();
+    LogHelper::setSink(sink);
+
+    constexpr int Records = 2000;
+    std::atomic<bool> logging{true};
+    std::thread producer([&logging] {
+        for (int i = 0; i < Records; ++i) {
+            STDCORE_LOG_ERROR << "toggled " << i;
+        }
+        logging.store(false);
+    });
+
+    // every disabled writer is freed once the producer cannot hold it anymore.
+    while (logging.load()) {
+        LogHelper::enableAsync(64);
+        LogHelper::disableAsync();
+    }
+    producer.join();
+    LogHelper::setSink(nullptr);
+
+    ASSERT_EQ(sink->records.size(), static_cast<std::size_t>(Records));
+}
+
+TEST(LogSinkTest, kept_records_written_after_delay_test) {
+    const auto path = tempPath("delayed_sink");
+    LogHelper::setSink(std::make_shared<FileLogSink>(path, FlushPolicy{64 * 1024, std::chrono::milliseconds(20)}));
+
+    STDCORE_LOG_INFORMATION << "kept";
+    ASSERT_TRUE(readFile(path).empty());
+
+    // no more records come, the flushing thread writes the kept one.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_NE(readFile(path).find("kept\n"), std::string::npos);
+
+    LogHelper::setSink(nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(LogSinkTest, mmap_sink_rotates_test) {
+    const auto path = tempPath("mmap_sink");
+    MmapLogSink::Options options;
+    options.segmentSize = 4096;
+    options.maxFiles = 2;
+    {
+        MmapLogSink sink(path, options);
+        for (int i = 0; i < 100; ++i) {
+            // 40 records fill a segment.
+            sink.write(std::to_string(i % 10) + std::string(98, 'x'), LogLevel::Information);
+        }
+        ASSERT_EQ(sink.rotations(), 2u);
+    }
+
+    ASSERT_EQ(readFile(path).size(), 2000u);
+    ASSERT_EQ(readFile(path + ".1").size(), 4000u);
+    ASSERT_EQ(readFile(path + ".2").size(), 4000u);
+    ASSERT_EQ(readFile(path).substr(0, 100), '0' + std::string(98, 'x') + '\n');
+    ASSERT_FALSE(std::ifstream(path + ".3").is_open());
+    ASSERT_FALSE(std::ifstream(path + ".next").is_open());
+
+    for (const auto &file : {path, path + ".1", path + ".2"}) {
+        std::remove(file.c_str());
+    }
+
+    ASSERT_THROW(MmapLogSink("/nonexistent/directory/file.log"), UserException);
+}
+
+TEST(LogSinkTest, mmap_sink_frees_closed_segments_test) {
+    const auto path = tempPath("mmap_sink_reclaim");
+    MmapLogSink::Options options;
+    options.segmentSize = 4096;
+    options.maxFiles = 0;
+    {
+        MmapLogSink sink(path, options);
+        for (int i = 0; i < 2000; ++i) {
+            sink.write(std::string(99, 'x'), LogLevel::Information);
+        }
+        ASSERT_EQ(sink.rotations(), 49u);
+
+        // the current and the prepared segments are left.
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (sink.segments() > 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_LE(sink.segments(), 2u);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(LogSinkTest, mmap_sink_concurrent_writers_test) {
+    const auto path = tempPath("mmap_sink_threads");
+    constexpr int Threads = 4;
+    constexpr int Records = 10000;
+    MmapLogSink::Options options;
+    options.segmentSize = 64 * 1024;
+    options.maxFiles = 32;
+    {
+        MmapLogSink sink(path, options);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < Threads; ++t) {
+            threads.emplace_back([&sink, t] {
+                for (int i = 0; i < Records; ++i) {
+                    sink.write("thread " + std::to_string(t) + " record", LogLevel::Information);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::size_t records = 0;
+    for (std::size_t index = 0; index <= options.maxFiles; ++index) {
+        const auto file = index == 0 ? path : path + '.' + std::to_string(index);
+        std::ifstream input(file);
+        for (std::string line; std::getline(input, line);) {
+            ASSERT_EQ(line.size(), 15u);
+            ASSERT_EQ(line.rfind("thread ", 0), 0u);
+            ++records;
+        }
+        std::remove(file.c_str());
+    }
+    ASSERT_EQ(records, static_cast<std::size_t>(Threads * Records));
+}
+
+TEST(LogSinkTest, mmap_sink_continues_crashed_file_test) {
+    const auto path = tempPath("mmap_sink_crashed");
+    {
+        // a crashed process leaves its records followed by the preallocated zeros.
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "old\n" << std::string(8000, '\0');
+    }
+
+    {
+        MmapLogSink sink(path);
+        sink.write("new", LogLevel::Information);
+        sink.flush();
+    }
+
+    ASSERT_EQ(readFile(path), "old\nnew\n");
+    std::remove(path.c_str());
+}
+
+TEST(LogSinkTest, mmap_sink_rotates_old_segment_test) {
+    const auto path = tempPath("mmap_sink_age");
+    MmapLogSink::Options options;
+    options.segmentSize = 4096;
+    options.maxSegmentAge = std::chrono::milliseconds(20);
+    {
+        MmapLogSink sink(path, options);
+        sink.write("old", LogLevel::Information);
+        for (int i = 0; i < 200 && sink.rotations() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_EQ(sink.rotations(), 1u);
+        sink.write("new", LogLevel::Information);
+    }
+
+    ASSERT_EQ(readFile(path + ".1"), "old\n");
+    ASSERT_EQ(readFile(path), "new\n");
+
+    for (const auto &file : {path, path + ".1"}) {
+        std::remove(file.c_str());
+    }
+}
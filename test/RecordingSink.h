@@ -0,0 +1,42 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogSink.h"
+
+/*!
+ * @brief RecordingSink keeps the records with their levels, the tests check them once the writing threads are done.
+ */
+class RecordingSink : public LogSink {
+public:
+    void write(std::string_view _record, LogLevel _level) override {
+        std::lock_guard lock(m_mutex);
+        records.emplace_back(_record);
+        levels.push_back(_level);
+    }
+
+    void flush() override {}
+
+    /*!
+     * @brief Returns the records of the level, it may be called while the threads write.
+     */
+    std::vector<std::string> recordsOf(LogLevel _level) {
+        std::lock_guard lock(m_mutex);
+        std::vector<std::string> result;
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (levels[i] == _level) {
+                result.push_back(records[i]);
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::string> records;
+    std::vector<LogLevel> levels;
+
+private:
+    std::mutex m_mutex;
+};
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+
+#include "StackMemoryResource.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+/*!
+ * @brief Counts the bytes taken from the new/delete resource.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocated = 0;
+    std::size_t allocations = 0;
+
+protected:
+    void *do_allocate(std::size_t _bytes, std::size_t _alignment) override {
+        allocated += _bytes;
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(_bytes, _alignment);
+    }
+
+    void do_deallocate(void *_pointer, std::size_t _bytes, std::size_t _alignment) noexcept override {
+        allocated -= _bytes;
+        std::pmr::new_delete_resource()->deallocate(_pointer, _bytes, _alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override {
+        return this == &_other;
+    }
+};
+}  // namespace
+
+TEST(StackMemoryResourceTest, bump_allocation_test) {
+    StackMemoryResource<256> resource(std::pmr::null_memory_resource());
+
+    auto *first = static_cast<char *>(resource.allocate(3, 1));
+    auto *second = resource.allocate(8, 8);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(second) % 8, 0);
+    ASSERT_EQ(static_cast<char *>(second), first + 8);
+
+    // deallocate() does nothing, the memory is released by release().
+    resource.deallocate(second, 8, 8);
+    ASSERT_EQ(resource.mark().used, 16);
+
+    resource.release();
+    ASSERT_EQ(resource.allocate(3, 1), first);
+    ASSERT_THROW([[maybe_unused]] auto *pointer = resource.allocate(512, 1), std::bad_alloc);
+}
+
+TEST(StackMemoryResourceTest, upstream_chunks_test) {
+    CountingResource upstream;
+    StackMemoryResource<64> resource(&upstream);
+
+    std::pmr::vector<int> values(&resource);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    ASSERT_EQ(values[999], 999);
+    ASSERT_GT(upstream.allocations, 1);
+    ASSERT_EQ(upstream.allocated, resource.upstreamSize());
+
+    resource.release();
+    ASSERT_EQ(upstream.allocated, 0);
+    ASSERT_EQ(resource.upstreamSize(), 0);
+}
+
+TEST(StackMemoryResourceTest, rewind_test) {
+    CountingResource upstream;
+    StackMemoryResource<128> resource(&upstream);
+
+    ASSERT_NE(resource.allocate(100, 1), nullptr);
+    const auto marker = resource.mark();
+    ASSERT_NE(resource.allocate(100, 1), nullptr);
+    ASSERT_NE(resource.allocate(5000, 1), nullptr);
+    ASSERT_EQ(upstream.allocations, 2);
+
+    resource.rewind(marker);
+    ASSERT_EQ(upstream.allocated, 0);
+    ASSERT_EQ(resource.mark().used, 100);
+
+    // a rewound resource starts from the first chunk size again.
+    ASSERT_NE(resource.allocate(100, 1), nullptr);
+    ASSERT_EQ(upstream.allocated, 4096);
+}
+
+TEST(StackMemoryResourceTest, thread_resource_scope_test) {
+    auto *threadResource = MonotonicMemoryResource::threadResource();
+    ASSERT_NE(threadResource, nullptr);
+
+    const auto before = threadResource->mark().used;
+    {
+        MemoryResourceScope scope;
+        ASSERT_EQ(scope.resource(), threadResource);
+        std::pmr::string outer(100, 'o', scope.resource());
+        {
+            MemoryResourceScope nested;
+            std::pmr::string inner(100, 'i', nested.resource());
+            ASSERT_GT(threadResource->mark().used, before + 200);
+        }
+        const std::pmr::string again(100, 'a', scope.resource());
+        ASSERT_EQ(std::string_view(outer), std::string(100, 'o'));
+    }
+    ASSERT_EQ(threadResource->mark().used, before);
+
+    const MemoryResourceScope fallback(nullptr);
+    ASSERT_EQ(fallback.resource(), std::pmr::get_default_resource());
+}
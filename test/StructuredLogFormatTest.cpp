@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+
+#include "LogHelper.h"
+#include "RecordingSink.h"
+#include "StructuredLogFormat.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream &operator<<(std::ostream &_os, const Point &_point) {
+    return _os << '(' << _point.x << ", " << _point.y << ')';
+}
+
+/*!
+ * @brief Logs the record in the format and returns it.
+ */
+template<class F>
+std::string logRecord(RecordFormat _format, F &&_log) {
+    auto sink = std::make_shared<RecordingSink>();
+    LogHelper::setSink(sink);
+    LogHelper::setRecordFormat(_format);
+    _log();
+    LogHelper::setRecordFormat(RecordFormat::Text);
+    LogHelper::setSink(nullptr);
+
+    return sink->records.empty() ? std::string() : sink->records.front();
+}
+}  // namespace
+
+TEST(StructuredLogFormatTest, json_fields_test) {
+    CharFastStackBuffer<char, 256, TruncateOnOverflow> buffer;
+    StructuredLogFormat::beginRecord(buffer, RecordFormat::Json, "2024", LogLevel::Warning);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Json, "id", 42);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Json, "ok", true);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Json, "ratio", 0.5);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Json, "nan", std::nan(""));
+    StructuredLogFormat::writeField(buffer, RecordFormat::Json, "name", std::string_view("a\"b\\c\n\x01"));
+    StructuredLogFormat::writeField(buffer, RecordFormat::Json, "none", static_cast<const char *>(nullptr));
+    StructuredLogFormat::endRecord(buffer, RecordFormat::Json, "done");
+
+    ASSERT_EQ(buffer.view(), R"({"ts":"2024","level":"Warning","id":42,"ok":true,"ratio":0.5,"nan":"nan",)"
+                             R"("name":"a\"b\\c\n\u0001","none":null,"msg":"done"})");
+}
+
+TEST(StructuredLogFormatTest, logfmt_fields_test) {
+    CharFastStackBuffer<char, 256, TruncateOnOverflow> buffer;
+    StructuredLogFormat::beginRecord(buffer, RecordFormat::Logfmt, "2024", LogLevel::Error);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "id", 42);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "plain", std::string_view("value"));
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "spaced", std::string_view("a b=\"c\""));
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "empty", std::string_view());
+    StructuredLogFormat::endRecord(buffer, RecordFormat::Logfmt, "done");
+
+    ASSERT_EQ(buffer.view(), R"(ts=2024 level=Error id=42 plain=value spaced="a b=\"c\"" empty="" msg=done)");
+}
+
+TEST(StructuredLogFormatTest, logfmt_keys_quoted_test) {
+    CharFastStackBuffer<char, 256, TruncateOnOverflow> buffer;
+    StructuredLogFormat::beginRecord(buffer, RecordFormat::Logfmt, "2024", LogLevel::Error);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "user id", 1);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "x level=Debug y", 2);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "", 3);
+    StructuredLogFormat::writeField(buffer, RecordFormat::Logfmt, "line\n", 4);
+    StructuredLogFormat::endRecord(buffer, RecordFormat::Logfmt, "done");
+
+    ASSERT_EQ(buffer.view(), R"(ts=2024 level=Error "user id"=1 "x level=Debug y"=2 ""=3 "line\n"=4 msg=done)");
+}
+
+TEST(StructuredLogFormatTest, record_stays_well_formed_test) {
+    CharFastStackBuffer<char, 64, TruncateOnOverflow> buffer;
+    StructuredLogFormat::beginRecord(buffer, RecordFormat::Json, "t", LogLevel::Error);
+    ASSERT_TRUE(StructuredLogFormat::writeField(buffer, RecordFormat::Json, "a", 1));
+    ASSERT_FALSE(StructuredLogFormat::writeField(buffer, RecordFormat::Json, "long", std::string(100, 'x')));
+    // the 2-byte UTF-8 chars are not split.
+    std::string message;
+    for (int i = 0; i < 40; ++i) {
+        message += "\xC3\xA9";
+    }
+    StructuredLogFormat::endRecord(buffer, RecordFormat::Json, message);
+
+    const std::string_view prefix = R"({"ts":"t","level":"Error","a":1,"msg":")";
+    const auto record = buffer.view();
+    ASSERT_LE(record.size(), 64u);
+    ASSERT_EQ(record.substr(0, prefix.size()), prefix);
+    ASSERT_EQ(record.substr(record.size() - 2), "\"}");
+    ASSERT_EQ((record.size() - prefix.size() - 2) % 2, 0u);
+}
+
+TEST(StructuredLogFormatTest, log_helper_json_test) {
+    const auto record = logRecord(RecordFormat::Json, [] {
+        STDCORE_LOG_ERROR << "order " << "failed" << kv("order_id", 17) << kv("point", Point{1, 2})
+                          << kv("reason", std::string("no \"stock\""));
+    });
+
+    ASSERT_EQ(record.rfind("{\"ts\":\"", 0), 0u);
+    ASSERT_NE(record.find(R"x("level":"Error","order_id":17,"point":"(1, 2)","reason":"no \"stock\"","msg":"order failed"})x"),
+              std::string::npos);
+}
+
+TEST(StructuredLogFormatTest, log_helper_logfmt_and_text_test) {
+    const auto logfmt = logRecord(RecordFormat::Logfmt, [] {
+        STDCORE_LOG_WARNING << "slow" << kv("latency_us", 1500) << kv("point", Point{1, 2});
+    });
+    ASSERT_EQ(logfmt.rfind("ts=", 0), 0u);
+    ASSERT_NE(logfmt.find(R"x( level=Warning latency_us=1500 point="(1, 2)" msg=slow)x"), std::string::npos);
+
+    const auto text = logRecord(RecordFormat::Text, [] {
+        STDCORE_LOG_WARNING << "slow" << kv("latency_us", 1500) << kv("point", Point{1, 2});
+    });
+    ASSERT_NE(text.find(" slow latency_us=1500 point=(1, 2)"), std::string::npos);
+}
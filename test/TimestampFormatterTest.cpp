@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include "TimestampFormatter.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+//! 2023-11-14T22:13:20.123456789Z
+constexpr std::int64_t TestTime = 1'700'000'000'123'456'789;
+
+std::string formatted(const TimestampFormatter &_formatter, std::int64_t _nanoseconds) {
+    char out[TimestampFormatter::MaxSize];
+    return std::string(out, _formatter.format(_nanoseconds, out));
+}
+}  // namespace
+
+TEST(TimestampFormatterTest, iso8601_precision_test) {
+    using Format = TimestampFormatter::Format;
+    using Precision = TimestampFormatter::Precision;
+
+    ASSERT_EQ(formatted(TimestampFormatter(Format::Iso8601, Precision::Seconds), TestTime),
+              "2023-11-14T22:13:20Z");
+    ASSERT_EQ(formatted(TimestampFormatter(Format::Iso8601, Precision::Milliseconds), TestTime),
+              "2023-11-14T22:13:20.123Z");
+    ASSERT_EQ(formatted(TimestampFormatter(Format::Iso8601, Precision::Microseconds), TestTime),
+              "2023-11-14T22:13:20.123456Z");
+    ASSERT_EQ(formatted(TimestampFormatter(Format::Iso8601, Precision::Nanoseconds), TestTime),
+              "2023-11-14T22:13:20.123456789Z");
+}
+
+TEST(TimestampFormatterTest, cached_second_test) {
+    const TimestampFormatter formatter(TimestampFormatter::Format::Iso8601, TimestampFormatter::Precision::Milliseconds);
+
+    ASSERT_EQ(formatted(formatter, TestTime), "2023-11-14T22:13:20.123Z");
+    ASSERT_EQ(formatted(formatter, TestTime + 5'000'000), "2023-11-14T22:13:20.128Z");
+    ASSERT_EQ(formatted(formatter, TestTime + 1'000'000'000), "2023-11-14T22:13:21.123Z");
+    ASSERT_EQ(formatted(TimestampFormatter(), TestTime).size(), std::string("Tue Nov 14 22:13:20 2023").size());
+}
+
+TEST(TimestampFormatterTest, clock_sources_test) {
+    using ClockSource = TimestampFormatter::ClockSource;
+
+    const auto systemNow = TimestampFormatter().now();
+    for (auto clockSource : {ClockSource::System, ClockSource::RealtimeCoarse, ClockSource::Tsc}) {
+        const TimestampFormatter formatter(TimestampFormatter::Format::Iso8601,
+                                           TimestampFormatter::Precision::Seconds,
+                                           clockSource);
+        ASSERT_LT(std::llabs(formatter.now() - systemNow), 1'000'000'000);
+    }
+}
+
+TEST(TimestampFormatterTest, calibrated_once_test) {
+    TimestampFormatter::calibrate();
+
+    // the calibration is done, the next calls do not sleep.
+    const auto start = std::chrono::steady_clock::now();
+    TimestampFormatter::calibrate();
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+}
+
+TEST(TimestampFormatterTest, tsc_follows_system_clock_test) {
+    TimestampFormatter::calibrate();
+    const TimestampFormatter tsc(TimestampFormatter::Format::Iso8601,
+                                 TimestampFormatter::Precision::Nanoseconds,
+                                 TimestampFormatter::ClockSource::Tsc);
+
+    // the first call anchors the counter, the next ones extrapolate from the anchor.
+    static_cast<void>(tsc.now());
+    for (int i = 0; i < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const auto before = TimestampFormatter().now();
+        const auto now = tsc.now();
+        const auto after = TimestampFormatter().now();
+        ASSERT_GT(now, before - 1'000'000);
+        ASSERT_LT(now, after + 1'000'000);
+    }
+}
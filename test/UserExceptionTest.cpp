@@ -0,0 +1,201 @@
+#include "gtest/gtest.h"
+
+#include "CharFastStackBuffer.h"
+#include "StackMemoryResource.h"
+#include "UserException.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+/*!
+ * @brief The resource which throws a non-allocation exception.
+ */
+class ThrowingResource : public std::pmr::memory_resource {
+protected:
+    void *do_allocate(std::size_t, std::size_t) override {
+        throw std::runtime_error("no memory");
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override {
+        return this == &_other;
+    }
+};
+}  // namespace
+
+TEST(UserExceptionTest, static_messages_are_views_test) {
+    static const char usrMsg[] = "user";
+    static const char dbMsg[] = "debug";
+
+    const UserException exception(UserException::Static, usrMsg, dbMsg, __PRETTY_FUNCTION__);
+    ASSERT_EQ(exception.usrMsg().data(), usrMsg);
+    ASSERT_EQ(exception.dbMsg().data(), dbMsg);
+    ASSERT_EQ(exception.funcInfo().data(), __PRETTY_FUNCTION__);
+
+    const UserException copy(exception);
+    ASSERT_EQ(copy.usrMsg().data(), usrMsg);
+    ASSERT_EQ(copy.nestedException(), nullptr);
+}
+
+TEST(UserExceptionTest, copied_messages_follow_the_copy_test) {
+    std::string usrMsg = "user";
+    auto exception = std::make_unique<UserException>(usrMsg, "debug", "function");
+    usrMsg = "changed";
+
+    const UserException copy(*exception);
+    exception.reset();
+    ASSERT_EQ(copy.usrMsg(), "user");
+    ASSERT_EQ(copy.dbMsg(), "debug");
+    ASSERT_EQ(copy.funcInfo(), "function");
+
+    UserException assigned(UserException::Static, "", "", "");
+    assigned = copy;
+    ASSERT_EQ(assigned.usrMsg(), "user");
+    ASSERT_NE(assigned.usrMsg().data(), copy.usrMsg().data());
+    ASSERT_STREQ(assigned.what(), copy.what());
+}
+
+TEST(UserExceptionTest, long_messages_test) {
+    const std::string dbMsg(2 * UserException::InlineCapacity, 'x');
+
+    auto exception = std::make_unique<UserException>("user", dbMsg, "function");
+    const UserException copy(std::move(*exception));
+    exception.reset();
+    ASSERT_EQ(copy.usrMsg(), "user");
+    ASSERT_EQ(copy.dbMsg(), dbMsg);
+    ASSERT_EQ(copy.funcInfo(), "function");
+}
+
+TEST(UserExceptionTest, memory_resource_messages_test) {
+    StackMemoryResource<2048> resource(std::pmr::null_memory_resource());
+    const std::string dbMsg(2 * UserException::InlineCapacity, 'x');
+    {
+        const UserException exception(&resource, "user", dbMsg, "function");
+        const auto marker = resource.mark();
+        ASSERT_GE(marker.used, dbMsg.size());
+
+        // the copy does not keep the memory of the resource.
+        const UserException copy(exception);
+        ASSERT_EQ(copy.dbMsg(), dbMsg);
+        ASSERT_NE(copy.dbMsg().data(), exception.dbMsg().data());
+        ASSERT_EQ(resource.mark().used, marker.used);
+    }
+
+    // the short messages stay in the inline buffer.
+    const auto marker = resource.mark();
+    const UserException exception(&resource, "user", "debug", "function");
+    ASSERT_EQ(resource.mark().used, marker.used);
+    ASSERT_EQ(exception.usrMsg(), "user");
+
+    // any exception of the resource truncates the messages to the inline buffer.
+    ThrowingResource throwing;
+    const UserException truncated(&throwing, "user", dbMsg, "function");
+    ASSERT_EQ(truncated.usrMsg(), "user");
+    ASSERT_EQ(truncated.dbMsg().size(), UserException::InlineCapacity - 4);
+    ASSERT_TRUE(truncated.funcInfo().empty());
+}
+
+TEST(UserExceptionTest, exception_thrown_out_of_resource_scope_test) {
+    const std::string dbMsg(2 * UserException::InlineCapacity, 'x');
+    try {
+        MemoryResourceScope scope;
+        UserException exception(scope.resource(), "user", dbMsg, "function");
+        throw exception;
+    } catch (const UserException &_exception) {
+        // the scope has rewound the resource, its memory is reused.
+        MemoryResourceScope scope;
+        std::memset(scope.resource()->allocate(dbMsg.size(), 1), 'y', dbMsg.size());
+
+        ASSERT_EQ(_exception.usrMsg(), "user");
+        ASSERT_EQ(_exception.dbMsg(), dbMsg);
+        ASSERT_NE(std::string_view(_exception.what()).find(dbMsg), std::string_view::npos);
+    }
+}
+
+TEST(UserExceptionTest, nested_exception_test) {
+    const UserException exception("user", "debug", "function", std::runtime_error("nested"));
+    ASSERT_NE(exception.nestedException(), nullptr);
+    ASSERT_STREQ(exception.nestedException()->what(), "nested");
+    ASSERT_EQ(std::string(exception.what()),
+              "The exception in function function\nUser message: user\nDebug message: debug\nnested\n\n");
+
+    try {
+        try {
+            throw std::logic_error("inner");
+        } catch (...) {
+            throw UserException(UserException::Static, "outer", "rethrow", __PRETTY_FUNCTION__, std::current_exception());
+        }
+    } catch (const UserException &_exception) {
+        ASSERT_STREQ(_exception.nestedException()->what(), "inner");
+        ASSERT_THROW(std::rethrow_exception(_exception.nestedExceptionPtr()), std::logic_error);
+    }
+
+    const UserException notStd("user", "debug", "function", std::make_exception_ptr(1));
+    ASSERT_EQ(notStd.nestedException(), nullptr);
+}
+
+TEST(UserExceptionTest, write_to_matches_what_test) {
+    const UserException inner("inner user", "inner debug", "inner", std::runtime_error("root"));
+    const UserException outer(UserException::Static, "outer user", "outer debug", "outer", std::make_exception_ptr(inner));
+
+    std::string str;
+    outer.writeTo(str);
+    ASSERT_EQ(str, outer.what());
+
+    CharFastStackBuffer<char, 1024> buffer;
+    buffer << static_cast<const std::exception &>(outer);
+    ASSERT_EQ(buffer.view(), outer.what());
+
+    buffer.clear();
+    buffer << exceptionFormat(outer, {true, 8});
+    ASSERT_EQ(buffer.view(), "outer user (outer debug) in outer; caused by: inner user (inner debug) in inner; caused by: root");
+}
+
+TEST(UserExceptionTest, write_to_depth_limit_test) {
+    UserException exception(UserException::Static, "level", "0", "f");
+    for (int i = 0; i < 20; ++i) {
+        exception = UserException(UserException::Static, "level", "n", "f", std::make_exception_ptr(exception));
+    }
+
+    std::string str;
+    exception.writeTo(str, {true, 2});
+    ASSERT_EQ(str, "level (n) in f; caused by: level (n) in f; caused by: ...");
+
+    CharFastStackBuffer<char, 64, TruncateOnOverflow> buffer;
+    buffer << exception;
+    ASSERT_EQ(buffer.size(), 64);
+    ASSERT_GT(buffer.truncated(), 0u);
+}
+
+TEST(UserExceptionTest, stack_trace_test) {
+    ASSERT_FALSE(StackTrace::isCaptureEnabled());
+    ASSERT_TRUE(UserException(UserException::Static, "user", "debug", "f").stackTrace().isEmpty());
+
+    StackTrace::setCaptureEnabled(true);
+    const UserException exception(UserException::Static, "user", "debug", "f");
+    StackTrace::setCaptureEnabled(false);
+
+#if STDCORE_STACK_TRACE
+    ASSERT_FALSE(exception.stackTrace().isEmpty());
+    ASSERT_LE(exception.stackTrace().size(), StackTrace::MaxFrames);
+    ASSERT_FALSE(StackTrace::symbol(exception.stackTrace().frame(0)).empty());
+
+    const UserException copy(exception);
+    ASSERT_EQ(copy.stackTrace().size(), exception.stackTrace().size());
+    ASSERT_EQ(copy.stackTrace().frame(0), exception.stackTrace().frame(0));
+
+    const std::string what = exception.what();
+    ASSERT_NE(what.find("Debug message: debug\nStack trace:\n#0 "), std::string::npos);
+
+    std::string str;
+    exception.writeTo(str, {false, 8, false});
+    ASSERT_EQ(str, "The exception in function f\nUser message: user\nDebug message: debug\n\n");
+#else
+    ASSERT_TRUE(exception.stackTrace().isEmpty());
+#endif
+}
@@ -0,0 +1,60 @@
+#include "BinaryLogDecoder.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+void printUsage(const char *_program) {
+    std::cerr << "Usage: " << _program << " [--iso] [--ms|--us|--ns] [--site] <binary log file>\n"
+              << "Writes the text records of the binary log written by LogHelper::enableBinary() to stdout.\n";
+}
+}  // namespace
+
+int main(int _argc, char *_argv[]) {
+    auto format = TimestampFormatter::Format::Ctime;
+    auto precision = TimestampFormatter::Precision::Seconds;
+    bool withSite = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < _argc; ++i) {
+        if (std::strcmp(_argv[i], "--iso") == 0) {
+            format = TimestampFormatter::Format::Iso8601;
+        } else if (std::strcmp(_argv[i], "--ms") == 0) {
+            precision = TimestampFormatter::Precision::Milliseconds;
+        } else if (std::strcmp(_argv[i], "--us") == 0) {
+            precision = TimestampFormatter::Precision::Microseconds;
+        } else if (std::strcmp(_argv[i], "--ns") == 0) {
+            precision = TimestampFormatter::Precision::Nanoseconds;
+        } else if (std::strcmp(_argv[i], "--site") == 0) {
+            withSite = true;
+        } else if (path == nullptr && _argv[i][0] != '-') {
+            path = _argv[i];
+        } else {
+            printUsage(_argv[0]);
+            return 2;
+        }
+    }
+
+    if (path == nullptr) {
+        printUsage(_argv[0]);
+        return 2;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << path << '\n';
+        return 1;
+    }
+
+    try {
+        BinaryLogDecoder decoder(BinaryLogDecoder::Options{TimestampFormatter(format, precision), withSite});
+        decoder.decodeStream(file, std::cout);
+    } catch (const std::exception &_exception) {
+        std::cout.flush();
+        std::cerr << _exception.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "LogCompression.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+void printUsage(const char *_program) {
+    std::cerr << "Usage: " << _program << " [<compressed log file>...]\n"
+              << "Writes the text of the log files compressed by LogCompressor to stdout, reads stdin without a file.\n";
+}
+
+/*!
+ * @brief Decompresses the stream to stdout, returns false and reports the error if it is corrupted.
+ */
+bool decompress(std::istream &_is, const char *_name) {
+    try {
+        LogCompression::decompressStream(_is, std::cout);
+    } catch (const std::exception &_exception) {
+        std::cout.flush();
+        std::cerr << _name << ": " << _exception.what() << '\n';
+        return false;
+    }
+
+    return true;
+}
+}  // namespace
+
+int main(int _argc, char *_argv[]) {
+    for (int i = 1; i < _argc; ++i) {
+        if (_argv[i][0] == '-') {
+            printUsage(_argv[0]);
+            return 2;
+        }
+    }
+
+    if (_argc == 1) {
+        return decompress(std::cin, "stdin") ? 0 : 1;
+    }
+
+    int result = 0;
+    for (int i = 1; i < _argc; ++i) {
+        std::ifstream file(_argv[i], std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << _argv[i] << '\n';
+            result = 1;
+        } else if (!decompress(file, _argv[i])) {
+            result = 1;
+        }
+    }
+
+    return result;
+}